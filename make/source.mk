@@ -65,6 +65,7 @@ COMMON_SRC = \
             io/usb_msc.c \
             msp/msp.c \
             msp/msp_box.c \
+            msp/msp_dataflash.c \
             msp/msp_serial.c \
             scheduler/scheduler.c \
             sensors/adcinternal.c \
@@ -83,6 +84,7 @@ COMMON_SRC = \
             drivers/rx/rx_pwm.c \
             drivers/serial_softserial.c \
             fc/core.c \
+            fc/pid_subtask.c \
             fc/rc.c \
             fc/rc_adjustments.c \
             fc/rc_controls.c \
@@ -135,10 +137,12 @@ COMMON_SRC = \
             sensors/compass.c \
             sensors/gyro.c \
             sensors/gyro_init.c \
+            sensors/gyro_integrator.c \
             sensors/initialisation.c \
             blackbox/blackbox.c \
             blackbox/blackbox_encoding.c \
             blackbox/blackbox_io.c \
+            blackbox/blackbox_logdir.c \
             cms/cms.c \
             cms/cms_menu_blackbox.c \
             cms/cms_menu_failsafe.c \
@@ -229,6 +233,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             common/encoding.c \
             common/filter.c \
             common/maths.c \
+            common/rfft.c \
             common/sdft.c \
             common/typeconversion.c \
             drivers/accgyro/accgyro_mpu.c \
@@ -258,6 +263,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             drivers/system.c \
             drivers/timer.c \
             fc/core.c \
+            fc/pid_subtask.c \
             fc/tasks.c \
             fc/rc.c \
             fc/rc_controls.c \
@@ -283,6 +289,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             sensors/acceleration.c \
             sensors/boardalignment.c \
             sensors/gyro.c \
+            sensors/gyro_integrator.c \
             $(CMSIS_SRC) \
             $(DEVICE_STDPERIPH_SRC) \
 
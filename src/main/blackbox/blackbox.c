@@ -37,6 +37,7 @@
 #include "build/version.h"
 
 #include "common/axis.h"
+#include "common/crc.h"
 #include "common/encoding.h"
 #include "common/maths.h"
 #include "common/time.h"
@@ -114,6 +115,73 @@ static const char* const blackboxFieldHeaderNames[] = {
     "encoding"
 };
 
+typedef struct blackboxMainState_s {
+    uint32_t iteration;
+    uint32_t time;
+
+    int16_t command[5];
+    int16_t setpoint[4];
+    int16_t mixer[4];
+
+    int32_t axisPID_P[XYZ_AXIS_COUNT];
+    int32_t axisPID_I[XYZ_AXIS_COUNT];
+    int32_t axisPID_D[XYZ_AXIS_COUNT];
+    int32_t axisPID_F[XYZ_AXIS_COUNT];
+    int32_t axisPID_B[XYZ_AXIS_COUNT];
+    int32_t axisPID_O[XYZ_AXIS_COUNT];
+
+    int16_t attitude[XYZ_AXIS_COUNT];
+    int16_t gyroRAW[XYZ_AXIS_COUNT];
+    int16_t gyroADC[XYZ_AXIS_COUNT];
+    int16_t accADC[XYZ_AXIS_COUNT];
+#ifdef USE_MAG
+    int16_t magADC[XYZ_AXIS_COUNT];
+#endif
+#ifdef USE_BARO
+    int32_t altitude;
+#ifdef USE_VARIO
+    int16_t vario;
+#endif
+#endif
+
+    uint16_t voltage;
+    uint16_t current;
+
+    uint16_t vbec;
+    uint16_t vbus;
+
+    uint16_t esc_voltage;
+    uint16_t esc_current;
+    int16_t  esc_temp;
+    uint16_t esc_capa;
+    uint16_t esc_pwm;
+    uint16_t esc_thr;
+    uint32_t esc_rpm;
+
+    uint16_t esc2_voltage;
+    uint16_t esc2_current;
+    int16_t  esc2_temp;
+    uint16_t esc2_capa;
+    uint32_t esc2_rpm;
+
+    uint16_t bec_voltage;
+    uint16_t bec_current;
+    int16_t  bec_temp;
+
+    int16_t  mcu_temp;
+
+    uint16_t rssi;
+
+    uint16_t headspeed;
+    uint16_t tailspeed;
+
+    int16_t motor[MAX_SUPPORTED_MOTORS];
+    int16_t servo[MAX_SUPPORTED_SERVOS];
+
+    int32_t debug[DEBUG_VALUE_COUNT];
+
+} blackboxMainState_t;
+
 /* All field definition structs should look like this (but with longer arrs): */
 typedef struct blackboxFieldDefinition_s {
     const char *name;
@@ -157,149 +225,164 @@ typedef struct blackboxDeltaFieldDefinition_s {
     uint8_t Ppredict;
     uint8_t Pencode;
     uint8_t condition; // Decide whether this field should appear in the log
+
+    uint8_t storage;   // Size and signedness of the value in blackboxMainState_t
+    uint16_t offset;   // Offset of the value in blackboxMainState_t
 } blackboxDeltaFieldDefinition_t;
 
+#define FIELD_STORAGE_16        0x00
+#define FIELD_STORAGE_32        0x01
+#define FIELD_STORAGE_SIGNED    0x02
+
+#define STATE_MEMBER(member)    (((blackboxMainState_t *)0)->member)
+
+// Where the value of a main frame field is found in blackboxMainState_t
+#define FIELD_VALUE(member) \
+    .storage = ((sizeof(STATE_MEMBER(member)) == sizeof(uint32_t)) ? FIELD_STORAGE_32 : FIELD_STORAGE_16) | \
+               ((__builtin_types_compatible_p(typeof(STATE_MEMBER(member)), int16_t) || \
+                 __builtin_types_compatible_p(typeof(STATE_MEMBER(member)), int32_t)) ? FIELD_STORAGE_SIGNED : 0), \
+    .offset = offsetof(blackboxMainState_t, member)
+
 /**
  * Description of the blackbox fields we are writing in our main intra (I) and inter (P) frames. This description is
- * written into the flight log header so the log can be properly interpreted (but these definitions don't actually cause
- * the encoding to happen, we have to encode the flight log ourselves in write{Inter|Intra}frame() in a way that matches
- * the encoding we've promised here).
+ * written into the flight log header so the log can be properly interpreted, and it also drives the encoding in
+ * write{Inter|Intra}frame(). Fields with the same P-frame group encoding must be kept next to each other.
  */
 static const blackboxDeltaFieldDefinition_t blackboxMainFields[] =
 {
     /* loop iteration doesn't appear in P frames since it always increments */
-    {"loopIteration", -1, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(INC),           .Pencode = ENCODING_NULL,        CONDITION(ALWAYS)},
+    {"loopIteration", -1, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(INC),           .Pencode = ENCODING_NULL,        CONDITION(ALWAYS), FIELD_VALUE(iteration)},
 
     /* Time advances pretty steadily so the P-frame prediction is a straight line */
-    {"time",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(LINEAR),        .Pencode = ENCODING(SIGNED_VB),  CONDITION(ALWAYS)},
+    {"time",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(LINEAR),        .Pencode = ENCODING(SIGNED_VB),  CONDITION(ALWAYS), FIELD_VALUE(time)},
 
     /* RC commands are encoded together as a group in P-frames: */
-    {"rcCommand",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(COMMAND)},
-    {"rcCommand",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(COMMAND)},
-    {"rcCommand",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(COMMAND)},
-    {"rcCommand",   3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(COMMAND)},
-    {"rcCommand",   4, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(COMMAND)},
+    {"rcCommand",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(COMMAND), FIELD_VALUE(command[0])},
+    {"rcCommand",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(COMMAND), FIELD_VALUE(command[1])},
+    {"rcCommand",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(COMMAND), FIELD_VALUE(command[2])},
+    {"rcCommand",   3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(COMMAND), FIELD_VALUE(command[3])},
+    {"rcCommand",   4, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(COMMAND), FIELD_VALUE(command[4])},
 
     /* setpoint - define 4 fields like RC command */
-    {"setpoint",    0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(SETPOINT)},
-    {"setpoint",    1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(SETPOINT)},
-    {"setpoint",    2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(SETPOINT)},
-    {"setpoint",    3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(SETPOINT)},
+    {"setpoint",    0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(SETPOINT), FIELD_VALUE(setpoint[0])},
+    {"setpoint",    1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(SETPOINT), FIELD_VALUE(setpoint[1])},
+    {"setpoint",    2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(SETPOINT), FIELD_VALUE(setpoint[2])},
+    {"setpoint",    3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(SETPOINT), FIELD_VALUE(setpoint[3])},
 
     /* Mixer inputs */
-    {"mixer",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(MIXER)},
-    {"mixer",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(MIXER)},
-    {"mixer",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(MIXER)},
-    {"mixer",       3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(MIXER)},
+    {"mixer",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(MIXER), FIELD_VALUE(mixer[0])},
+    {"mixer",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(MIXER), FIELD_VALUE(mixer[1])},
+    {"mixer",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(MIXER), FIELD_VALUE(mixer[2])},
+    {"mixer",       3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16),  CONDITION(MIXER), FIELD_VALUE(mixer[3])},
 
     /* PID control terms */
-    {"axisP",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID)},
-    {"axisP",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID)},
-    {"axisP",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID)},
-    {"axisI",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID)},
-    {"axisI",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID)},
-    {"axisI",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID)},
-    {"axisD",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID)},
-    {"axisD",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID)},
-    {"axisD",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID)},
-    {"axisF",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID)},
-    {"axisF",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID)},
-    {"axisF",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID)},
+    {"axisP",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID), FIELD_VALUE(axisPID_P[0])},
+    {"axisP",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID), FIELD_VALUE(axisPID_P[1])},
+    {"axisP",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID), FIELD_VALUE(axisPID_P[2])},
+    {"axisI",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID), FIELD_VALUE(axisPID_I[0])},
+    {"axisI",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID), FIELD_VALUE(axisPID_I[1])},
+    {"axisI",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID), FIELD_VALUE(axisPID_I[2])},
+    {"axisD",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID), FIELD_VALUE(axisPID_D[0])},
+    {"axisD",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID), FIELD_VALUE(axisPID_D[1])},
+    {"axisD",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID), FIELD_VALUE(axisPID_D[2])},
+    {"axisF",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID), FIELD_VALUE(axisPID_F[0])},
+    {"axisF",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID), FIELD_VALUE(axisPID_F[1])},
+    {"axisF",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(PID), FIELD_VALUE(axisPID_F[2])},
 
     /* PID FF Boost terms */
-    {"axisB",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(BOOST)},
-    {"axisB",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(BOOST)},
-    {"axisB",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(BOOST)},
+    {"axisB",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(BOOST), FIELD_VALUE(axisPID_B[0])},
+    {"axisB",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(BOOST), FIELD_VALUE(axisPID_B[1])},
+    {"axisB",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(BOOST), FIELD_VALUE(axisPID_B[2])},
 
     /* HSI Offset terms */
-    {"axisO",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(HSI)},
-    {"axisO",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(HSI)},
-    {"axisO",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(HSI)},
+    {"axisO",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(HSI), FIELD_VALUE(axisPID_O[0])},
+    {"axisO",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(HSI), FIELD_VALUE(axisPID_O[1])},
+    {"axisO",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(HSI), FIELD_VALUE(axisPID_O[2])},
 
     /* Attitude Euler angles in 0.1deg steps */
-    {"attitude",    0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(ATTITUDE)},
-    {"attitude",    1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(ATTITUDE)},
-    {"attitude",    2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(ATTITUDE)},
+    {"attitude",    0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(ATTITUDE), FIELD_VALUE(attitude[0])},
+    {"attitude",    1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(ATTITUDE), FIELD_VALUE(attitude[1])},
+    {"attitude",    2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32),  CONDITION(ATTITUDE), FIELD_VALUE(attitude[2])},
 
     /* Gyros and accelerometers base their P-predictions on the average of the previous 2 frames to reduce noise impact */
-    {"gyroRAW",     0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(GYRAW)},
-    {"gyroRAW",     1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(GYRAW)},
-    {"gyroRAW",     2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(GYRAW)},
+    {"gyroRAW",     0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(GYRAW), FIELD_VALUE(gyroRAW[0])},
+    {"gyroRAW",     1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(GYRAW), FIELD_VALUE(gyroRAW[1])},
+    {"gyroRAW",     2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(GYRAW), FIELD_VALUE(gyroRAW[2])},
 
-    {"gyroADC",     0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(GYRO)},
-    {"gyroADC",     1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(GYRO)},
-    {"gyroADC",     2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(GYRO)},
+    {"gyroADC",     0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(GYRO), FIELD_VALUE(gyroADC[0])},
+    {"gyroADC",     1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(GYRO), FIELD_VALUE(gyroADC[1])},
+    {"gyroADC",     2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(GYRO), FIELD_VALUE(gyroADC[2])},
 
-    {"accADC",      0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(ACC)},
-    {"accADC",      1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(ACC)},
-    {"accADC",      2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(ACC)},
+    {"accADC",      0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(ACC), FIELD_VALUE(accADC[0])},
+    {"accADC",      1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(ACC), FIELD_VALUE(accADC[1])},
+    {"accADC",      2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(ACC), FIELD_VALUE(accADC[2])},
 
 #ifdef USE_MAG
-    {"magADC",      0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(MAG)},
-    {"magADC",      1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(MAG)},
-    {"magADC",      2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(MAG)},
+    {"magADC",      0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(MAG), FIELD_VALUE(magADC[0])},
+    {"magADC",      1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(MAG), FIELD_VALUE(magADC[1])},
+    {"magADC",      2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(MAG), FIELD_VALUE(magADC[2])},
 #endif
 
 #ifdef USE_BARO
-    {"altitude",   -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(ALT)},
+    {"altitude",   -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(ALT), FIELD_VALUE(altitude)},
 #ifdef USE_VARIO
-    {"vario",      -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(ALT)},
+    {"vario",      -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(ALT), FIELD_VALUE(vario)},
 #endif
 #endif
 
-    {"rssi",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(RSSI)},
-
-    {"Vbat",       -1, UNSIGNED, .Ipredict = PREDICT(VBATREF), .Iencode = ENCODING(NEG_14BIT),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(VOLTAGE)},
-    {"Ibat",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(CURRENT)},
-
-    {"Vbec",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(VBEC)},
-    {"Vbus",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(VBUS)},
-
-    {"EscV",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC_TELEM)},
-    {"EscI",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC_TELEM)},
-    {"EscCap",     -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC_TELEM)},
-    {"EscRPM",     -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC_TELEM)},
-    {"EscThr",     -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC_TELEM)},
-    {"EscPwm",     -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC_TELEM)},
-
-    {"BecV",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(BEC_TELEM)},
-    {"BecI",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(BEC_TELEM)},
-
-    {"Esc2V",      -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC2_TELEM)},
-    {"Esc2I",      -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC2_TELEM)},
-    {"Esc2Cap",    -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC2_TELEM)},
-    {"Esc2RPM",    -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC2_TELEM)},
-
-    {"Tmcu",       -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(TMCU)},
-    {"Tesc",       -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(TESC)},
-    {"Tbec",       -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(TBEC)},
-    {"Tesc2",      -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(TESC2)},
-
-    {"headspeed",  -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(HEADSPEED)},
-    {"tailspeed",  -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(TAILSPEED)},
-
-    {"motor",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(MOTOR_1)},
-    {"motor",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(MOTOR_2)},
-    {"motor",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(MOTOR_3)},
-    {"motor",       3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(MOTOR_4)},
-
-    {"servo",       0, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_1)},
-    {"servo",       1, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_2)},
-    {"servo",       2, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_3)},
-    {"servo",       3, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_4)},
-    {"servo",       4, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_5)},
-    {"servo",       5, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_6)},
-    {"servo",       6, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_7)},
-    {"servo",       7, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_8)},
-
-    {"debug",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG)},
-    {"debug",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG)},
-    {"debug",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG)},
-    {"debug",       3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG)},
-    {"debug",       4, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG)},
-    {"debug",       5, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG)},
-    {"debug",       6, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG)},
-    {"debug",       7, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG)},
+    {"rssi",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(RSSI), FIELD_VALUE(rssi)},
+
+    {"Vbat",       -1, UNSIGNED, .Ipredict = PREDICT(VBATREF), .Iencode = ENCODING(NEG_14BIT),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(VOLTAGE), FIELD_VALUE(voltage)},
+    {"Ibat",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(CURRENT), FIELD_VALUE(current)},
+
+    {"Vbec",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(VBEC), FIELD_VALUE(vbec)},
+    {"Vbus",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(VBUS), FIELD_VALUE(vbus)},
+
+    {"EscV",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC_TELEM), FIELD_VALUE(esc_voltage)},
+    {"EscI",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC_TELEM), FIELD_VALUE(esc_current)},
+    {"EscCap",     -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC_TELEM), FIELD_VALUE(esc_capa)},
+    {"EscRPM",     -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC_TELEM), FIELD_VALUE(esc_rpm)},
+    {"EscThr",     -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC_TELEM), FIELD_VALUE(esc_thr)},
+    {"EscPwm",     -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC_TELEM), FIELD_VALUE(esc_pwm)},
+
+    {"BecV",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(BEC_TELEM), FIELD_VALUE(bec_voltage)},
+    {"BecI",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(BEC_TELEM), FIELD_VALUE(bec_current)},
+
+    {"Esc2V",      -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC2_TELEM), FIELD_VALUE(esc2_voltage)},
+    {"Esc2I",      -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC2_TELEM), FIELD_VALUE(esc2_current)},
+    {"Esc2Cap",    -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC2_TELEM), FIELD_VALUE(esc2_capa)},
+    {"Esc2RPM",    -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(ESC2_TELEM), FIELD_VALUE(esc2_rpm)},
+
+    {"Tmcu",       -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(TMCU), FIELD_VALUE(mcu_temp)},
+    {"Tesc",       -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(TESC), FIELD_VALUE(esc_temp)},
+    {"Tbec",       -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(TBEC), FIELD_VALUE(bec_temp)},
+    {"Tesc2",      -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB),  CONDITION(TESC2), FIELD_VALUE(esc2_temp)},
+
+    {"headspeed",  -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(HEADSPEED), FIELD_VALUE(headspeed)},
+    {"tailspeed",  -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB),  .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(TAILSPEED), FIELD_VALUE(tailspeed)},
+
+    {"motor",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(MOTOR_1), FIELD_VALUE(motor[0])},
+    {"motor",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(MOTOR_2), FIELD_VALUE(motor[1])},
+    {"motor",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(MOTOR_3), FIELD_VALUE(motor[2])},
+    {"motor",       3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(MOTOR_4), FIELD_VALUE(motor[3])},
+
+    {"servo",       0, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_1), FIELD_VALUE(servo[0])},
+    {"servo",       1, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_2), FIELD_VALUE(servo[1])},
+    {"servo",       2, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_3), FIELD_VALUE(servo[2])},
+    {"servo",       3, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_4), FIELD_VALUE(servo[3])},
+    {"servo",       4, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_5), FIELD_VALUE(servo[4])},
+    {"servo",       5, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_6), FIELD_VALUE(servo[5])},
+    {"servo",       6, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_7), FIELD_VALUE(servo[6])},
+    {"servo",       7, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB),  CONDITION(SERVO_8), FIELD_VALUE(servo[7])},
+
+    {"debug",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG), FIELD_VALUE(debug[0])},
+    {"debug",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG), FIELD_VALUE(debug[1])},
+    {"debug",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG), FIELD_VALUE(debug[2])},
+    {"debug",       3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG), FIELD_VALUE(debug[3])},
+    {"debug",       4, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG), FIELD_VALUE(debug[4])},
+    {"debug",       5, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG), FIELD_VALUE(debug[5])},
+    {"debug",       6, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG), FIELD_VALUE(debug[6])},
+    {"debug",       7, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),    .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB),  CONDITION(DEBUG), FIELD_VALUE(debug[7])},
 
 };
 
@@ -356,72 +439,6 @@ typedef enum BlackboxState {
 } BlackboxState;
 
 
-typedef struct blackboxMainState_s {
-    uint32_t time;
-
-    int16_t command[5];
-    int16_t setpoint[4];
-    int16_t mixer[4];
-
-    int32_t axisPID_P[XYZ_AXIS_COUNT];
-    int32_t axisPID_I[XYZ_AXIS_COUNT];
-    int32_t axisPID_D[XYZ_AXIS_COUNT];
-    int32_t axisPID_F[XYZ_AXIS_COUNT];
-    int32_t axisPID_B[XYZ_AXIS_COUNT];
-    int32_t axisPID_O[XYZ_AXIS_COUNT];
-
-    int16_t attitude[XYZ_AXIS_COUNT];
-    int16_t gyroRAW[XYZ_AXIS_COUNT];
-    int16_t gyroADC[XYZ_AXIS_COUNT];
-    int16_t accADC[XYZ_AXIS_COUNT];
-#ifdef USE_MAG
-    int16_t magADC[XYZ_AXIS_COUNT];
-#endif
-#ifdef USE_BARO
-    int32_t altitude;
-#ifdef USE_VARIO
-    int16_t vario;
-#endif
-#endif
-
-    uint16_t voltage;
-    uint16_t current;
-
-    uint16_t vbec;
-    uint16_t vbus;
-
-    uint16_t esc_voltage;
-    uint16_t esc_current;
-    int16_t  esc_temp;
-    uint16_t esc_capa;
-    uint16_t esc_pwm;
-    uint16_t esc_thr;
-    uint32_t esc_rpm;
-
-    uint16_t esc2_voltage;
-    uint16_t esc2_current;
-    int16_t  esc2_temp;
-    uint16_t esc2_capa;
-    uint32_t esc2_rpm;
-
-    uint16_t bec_voltage;
-    uint16_t bec_current;
-    int16_t  bec_temp;
-
-    int16_t  mcu_temp;
-
-    uint16_t rssi;
-
-    uint16_t headspeed;
-    uint16_t tailspeed;
-
-    int16_t motor[MAX_SUPPORTED_MOTORS];
-    int16_t servo[MAX_SUPPORTED_SERVOS];
-
-    int32_t debug[DEBUG_VALUE_COUNT];
-
-} blackboxMainState_t;
-
 typedef struct blackboxGpsState_s {
     int32_t GPS_home[2];
     int32_t GPS_coord[2];
@@ -467,6 +484,30 @@ static uint64_t blackboxConditionCache;
 
 STATIC_ASSERT((sizeof(blackboxConditionCache) * 8) >= FLIGHT_LOG_FIELD_CONDITION_COUNT, too_many_flight_log_conditions);
 
+// Main frame fields enabled for this log, precomputed at start
+typedef struct {
+    uint8_t index;      // index in blackboxMainFields
+    uint8_t storage;
+    uint16_t offset;
+    uint8_t Ipredict;
+    uint8_t Iencode;
+    uint8_t Ppredict;
+} blackboxMainField_t;
+
+// Consecutive enabled fields written with one P-frame encoding call
+typedef struct {
+    uint8_t encode;
+    uint8_t start;
+    uint8_t count;
+} blackboxMainGroup_t;
+
+static blackboxMainField_t blackboxMainFieldList[ARRAYLEN(blackboxMainFields)];
+static blackboxMainGroup_t blackboxMainGroupList[ARRAYLEN(blackboxMainFields)];
+static uint8_t blackboxMainFieldIndex[ARRAYLEN(blackboxMainFields)];
+
+static uint8_t blackboxMainFieldCount;
+static uint8_t blackboxMainGroupCount;
+
 static uint32_t blackboxIteration;
 
 static uint32_t blackboxPInterval = 0;
@@ -474,6 +515,27 @@ static uint32_t blackboxIInterval = 0;
 static uint32_t blackboxSInterval = 0;
 static uint32_t blackboxGInterval = 0;
 
+/*
+ * Adaptive rate control. When the device buffer is filling up, the P and I intervals are doubled (up to
+ * 2^BLACKBOX_RATE_SHIFT_MAX times the configured rate), and halved again once the device has caught up.
+ * The intervals above are the effective ones, the configured ones are kept here.
+ */
+#define BLACKBOX_RATE_SHIFT_MAX         3
+#define BLACKBOX_RATE_FILL_HIGH         75
+#define BLACKBOX_RATE_FILL_LOW          25
+#define BLACKBOX_RATE_RECOVERY_COUNT    16
+
+static uint32_t blackboxBasePInterval = 0;
+static uint32_t blackboxBaseIInterval = 0;
+static uint32_t blackboxBaseSInterval = 0;
+static uint32_t blackboxBaseGInterval = 0;
+
+static uint8_t blackboxRateShift;
+static uint8_t blackboxRateTarget;
+static uint8_t blackboxRatePeakFill;
+static uint8_t blackboxRateQuietCount;
+static uint32_t blackboxRateFrameDrops;
+
 static uint32_t blackboxSlowFrameSkipCounter;
 static uint32_t blackboxGPSHomeFrameSkipCounter;
 
@@ -641,7 +703,7 @@ static bool testBlackboxConditionUncached(FlightLogFieldCondition condition)
         return (debugMode != DEBUG_NONE);
 
     case CONDITION(NOT_EVERY_FRAME):
-        return (blackboxPInterval > 1);
+        return (blackboxBasePInterval > 1 || blackboxConfig()->adaptiveRate);
 
     case CONDITION(NEVER):
         return false;
@@ -666,6 +728,98 @@ static bool testBlackboxCondition(FlightLogFieldCondition condition)
     return (blackboxConditionCache & BITLL(condition));
 }
 
+/*
+ * Build the list of enabled main frame fields, and split it into P-frame encoding groups the same way
+ * the log decoder does. Must be called after the condition cache has been built.
+ */
+static void blackboxBuildMainFieldList(void)
+{
+    blackboxMainFieldCount = 0;
+
+    for (unsigned index = 0; index < ARRAYLEN(blackboxMainFields); index++) {
+        const blackboxDeltaFieldDefinition_t *def = &blackboxMainFields[index];
+
+        if (testBlackboxCondition(def->condition)) {
+            blackboxMainField_t *field = &blackboxMainFieldList[blackboxMainFieldCount];
+
+            field->index = index;
+            field->storage = def->storage;
+            field->offset = def->offset;
+            field->Ipredict = def->Ipredict;
+            field->Iencode = def->Iencode;
+            field->Ppredict = def->Ppredict;
+
+            blackboxMainFieldIndex[blackboxMainFieldCount++] = index;
+        }
+    }
+
+    blackboxMainGroupCount = 0;
+
+    for (int start = 0; start < blackboxMainFieldCount; ) {
+        const uint8_t encode = blackboxMainFields[blackboxMainFieldList[start].index].Pencode;
+        int count;
+
+        // Nothing is written for these
+        if (encode == ENCODING_NULL) {
+            start++;
+            continue;
+        }
+
+        switch (encode) {
+        case ENCODING(TAG8_4S16):
+            count = 4;
+            break;
+        case ENCODING(TAG2_3S32):
+        case ENCODING(TAG2_3SVARIABLE):
+            count = 3;
+            break;
+        case ENCODING(TAG8_8SVB):
+            count = 1;
+            while (count < 8 && start + count < blackboxMainFieldCount &&
+                    blackboxMainFields[blackboxMainFieldList[start + count].index].Pencode == encode) {
+                count++;
+            }
+            break;
+        default:
+            count = 1;
+            break;
+        }
+
+        count = MIN(count, blackboxMainFieldCount - start);
+
+        blackboxMainGroup_t *group = &blackboxMainGroupList[blackboxMainGroupCount++];
+
+        group->encode = encode;
+        group->start = start;
+        group->count = count;
+
+        start += count;
+    }
+}
+
+/*
+ * Identify the set of main frame fields in the current log, so that logs
+ * with the same layout can be recognised without parsing their headers.
+ */
+uint32_t blackboxGetFieldSetHash(void)
+{
+    return fnv_update(FNV_OFFSET_BASIS, blackboxMainFieldIndex, blackboxMainFieldCount);
+}
+
+static inline int32_t blackboxLoadField(const blackboxMainState_t *state, const blackboxMainField_t *field)
+{
+    const void *value = (const char *)state + field->offset;
+
+    switch (field->storage) {
+    case FIELD_STORAGE_16:
+        return *(const uint16_t *)value;
+    case FIELD_STORAGE_16 | FIELD_STORAGE_SIGNED:
+        return *(const int16_t *)value;
+    default:
+        return *(const int32_t *)value;
+    }
+}
+
 static void blackboxSetState(BlackboxState newState)
 {
     //Perform initial setup required for the new state
@@ -702,141 +856,42 @@ static void blackboxSetState(BlackboxState newState)
 
 static void writeIntraframe(void)
 {
-    blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
-
-    const int motorCount = getMotorCount();
-    const int servoCount = getServoCount();
+    const blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
 
+    blackboxFrameBegin();
     blackboxWrite('I');
 
-    blackboxWriteUnsignedVB(blackboxIteration);
-    blackboxWriteUnsignedVB(blackboxCurrent->time);
-
-    if (testBlackboxCondition(CONDITION(COMMAND))) {
-        // Write roll, pitch, yaw and collective first:
-        blackboxWriteSigned16VBArray(blackboxCurrent->command, 4);
-
-        /*
-        * Write the throttle separately from the rest of the RC data as it's unsigned.
-        * Throttle lies in range [0..1000]:
-        */
-        blackboxWriteUnsignedVB(blackboxCurrent->command[THROTTLE]);
-    }
-
-    if (testBlackboxCondition(CONDITION(SETPOINT))) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->setpoint, 4);
-    }
-
-    if (testBlackboxCondition(CONDITION(MIXER))) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->mixer, 4);
-    }
-
-    if (testBlackboxCondition(CONDITION(PID))) {
-        blackboxWriteSignedVBArray(blackboxCurrent->axisPID_P, XYZ_AXIS_COUNT);
-        blackboxWriteSignedVBArray(blackboxCurrent->axisPID_I, XYZ_AXIS_COUNT);
-        blackboxWriteSignedVBArray(blackboxCurrent->axisPID_D, XYZ_AXIS_COUNT);
-        blackboxWriteSignedVBArray(blackboxCurrent->axisPID_F, XYZ_AXIS_COUNT);
-    }
-
-    if (testBlackboxCondition(CONDITION(BOOST))) {
-        blackboxWriteSignedVBArray(blackboxCurrent->axisPID_B, XYZ_AXIS_COUNT);
-    }
-    if (testBlackboxCondition(CONDITION(HSI))) {
-        blackboxWriteSignedVBArray(blackboxCurrent->axisPID_O, XYZ_AXIS_COUNT);
-    }
-
-    if (testBlackboxCondition(CONDITION(ATTITUDE))) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->attitude, XYZ_AXIS_COUNT);
-    }
-    if (testBlackboxCondition(CONDITION(GYRAW))) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->gyroRAW, XYZ_AXIS_COUNT);
-    }
-    if (testBlackboxCondition(CONDITION(GYRO))) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->gyroADC, XYZ_AXIS_COUNT);
-    }
-    if (testBlackboxCondition(CONDITION(ACC))) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->accADC, XYZ_AXIS_COUNT);
-    }
-#ifdef USE_MAG
-    if (testBlackboxCondition(CONDITION(MAG))) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->magADC, XYZ_AXIS_COUNT);
-    }
-#endif
-#ifdef USE_BARO
-    if (testBlackboxCondition(CONDITION(ALT))) {
-        blackboxWriteSignedVB(blackboxCurrent->altitude);
-#ifdef USE_VARIO
-        blackboxWriteSignedVB(blackboxCurrent->vario);
-#endif
-    }
-#endif
-    if (testBlackboxCondition(CONDITION(RSSI))) {
-        blackboxWriteUnsignedVB(blackboxCurrent->rssi);
-    }
-
-    if (testBlackboxCondition(CONDITION(VOLTAGE))) {
-        blackboxWriteUnsignedVB((vbatReference - blackboxCurrent->voltage) & 0x3FFF);
-    }
-    if (testBlackboxCondition(CONDITION(CURRENT))) {
-        blackboxWriteUnsignedVB(blackboxCurrent->current);
-    }
-    if (testBlackboxCondition(CONDITION(VBEC))) {
-        blackboxWriteUnsignedVB(blackboxCurrent->vbec);
-    }
-    if (testBlackboxCondition(CONDITION(VBUS))) {
-        blackboxWriteUnsignedVB(blackboxCurrent->vbus);
-    }
-    if (testBlackboxCondition(CONDITION(ESC_TELEM))) {
-        blackboxWriteUnsignedVB(blackboxCurrent->esc_voltage);
-        blackboxWriteUnsignedVB(blackboxCurrent->esc_current);
-        blackboxWriteUnsignedVB(blackboxCurrent->esc_capa);
-        blackboxWriteUnsignedVB(blackboxCurrent->esc_rpm);
-        blackboxWriteUnsignedVB(blackboxCurrent->esc_thr);
-        blackboxWriteUnsignedVB(blackboxCurrent->esc_pwm);
-    }
-    if (testBlackboxCondition(CONDITION(BEC_TELEM))) {
-        blackboxWriteUnsignedVB(blackboxCurrent->bec_voltage);
-        blackboxWriteUnsignedVB(blackboxCurrent->bec_current);
-    }
-    if (testBlackboxCondition(CONDITION(ESC2_TELEM))) {
-        blackboxWriteUnsignedVB(blackboxCurrent->esc2_voltage);
-        blackboxWriteUnsignedVB(blackboxCurrent->esc2_current);
-        blackboxWriteUnsignedVB(blackboxCurrent->esc2_capa);
-        blackboxWriteUnsignedVB(blackboxCurrent->esc2_rpm);
-    }
+    for (int i = 0; i < blackboxMainFieldCount; i++) {
+        const blackboxMainField_t *field = &blackboxMainFieldList[i];
+        int32_t value = blackboxLoadField(blackboxCurrent, field);
 
-    if (testBlackboxCondition(CONDITION(TMCU))) {
-        blackboxWriteSignedVB(blackboxCurrent->mcu_temp);
-    }
-    if (testBlackboxCondition(CONDITION(TESC))) {
-        blackboxWriteSignedVB(blackboxCurrent->esc_temp);
-    }
-    if (testBlackboxCondition(CONDITION(TBEC))) {
-        blackboxWriteSignedVB(blackboxCurrent->bec_temp);
-    }
-    if (testBlackboxCondition(CONDITION(TESC2))) {
-        blackboxWriteSignedVB(blackboxCurrent->esc2_temp);
-    }
-
-    if (testBlackboxCondition(CONDITION(HEADSPEED))) {
-        blackboxWriteUnsignedVB(blackboxCurrent->headspeed);
-    }
-    if (testBlackboxCondition(CONDITION(TAILSPEED))) {
-        blackboxWriteUnsignedVB(blackboxCurrent->tailspeed);
-    }
+        switch (field->Ipredict) {
+        case PREDICT(VBATREF):
+            value -= vbatReference;
+            break;
+        case PREDICT(1500):
+            value -= 1500;
+            break;
+        default:
+            break;
+        }
 
-    if (isFieldEnabled(FIELD_SELECT(MOTOR))) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->motor, motorCount);
-    }
-    if (isFieldEnabled(FIELD_SELECT(SERVO))) {
-        for (int i = 0; i < servoCount; i++) {
-            blackboxWriteSignedVB(blackboxCurrent->servo[i] - 1500);
+        switch (field->Iencode) {
+        case ENCODING(SIGNED_VB):
+            blackboxWriteSignedVB(value);
+            break;
+        case ENCODING(UNSIGNED_VB):
+            blackboxWriteUnsignedVB(value);
+            break;
+        case ENCODING(NEG_14BIT):
+            blackboxWriteUnsignedVB(-value & 0x3FFF);
+            break;
+        default:
+            break;
         }
     }
 
-    if (testBlackboxCondition(CONDITION(DEBUG))) {
-        blackboxWriteSignedVBArray(blackboxCurrent->debug, DEBUG_VALUE_COUNT);
-    }
+    blackboxFrameEnd();
 
     //Rotate our history buffers:
 
@@ -850,200 +905,70 @@ static void writeIntraframe(void)
     blackboxLoggedAnyFrames = true;
 }
 
-static void blackboxWriteMainStateArrayUsingAveragePredictor(int arrOffsetInHistory, int count)
-{
-    int16_t *curr  = (int16_t*) ((char*) (blackboxHistory[0]) + arrOffsetInHistory);
-    int16_t *prev1 = (int16_t*) ((char*) (blackboxHistory[1]) + arrOffsetInHistory);
-    int16_t *prev2 = (int16_t*) ((char*) (blackboxHistory[2]) + arrOffsetInHistory);
-
-    for (int i = 0; i < count; i++) {
-        // Predictor is the average of the previous two history states
-        int32_t predictor = (prev1[i] + prev2[i]) / 2;
-
-        blackboxWriteSignedVB(curr[i] - predictor);
-    }
-}
-
-#define CALC_DELTAS(delta, next, prev, count) do {  \
-    for (int i = 0; i < (count); i++)               \
-        delta[i] = next[i] - prev[i];               \
-} while(0)
-
-
 static void writeInterframe(void)
 {
-    blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
-    blackboxMainState_t *blackboxPrev = blackboxHistory[1];
-
-    const int motorCount = getMotorCount();
-    const int servoCount = getServoCount();
+    const blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
+    const blackboxMainState_t *blackboxPrev1 = blackboxHistory[1];
+    const blackboxMainState_t *blackboxPrev2 = blackboxHistory[2];
 
-    int32_t deltas[8];
+    int32_t values[8];
 
+    blackboxFrameBegin();
     blackboxWrite('P');
 
-    // No need to store iteration count since its delta is always 1
-
-    /*
-     * Since the difference between the difference between successive times will be nearly zero (due to consistent
-     * looptime spacing), use second-order differences.
-     */
-    blackboxWriteSignedVB((int32_t) (blackboxHistory[0]->time - 2 * blackboxHistory[1]->time + blackboxHistory[2]->time));
-
-    /*
-     * RC tends to stay the same or fairly small for many frames at a time, so use an encoding that
-     * can pack multiple values per byte:
-     */
-    if (testBlackboxCondition(CONDITION(COMMAND))) {
-        CALC_DELTAS(deltas, blackboxCurrent->command, blackboxPrev->command, 4);
-        blackboxWriteTag8_4S16(deltas);
-
-        // Calculate throttle delta
-        int32_t throttleDelta = blackboxCurrent->command[THROTTLE] - blackboxPrev->command[THROTTLE];
-        blackboxWriteSignedVB(throttleDelta);
-    }
-
-    if (testBlackboxCondition(CONDITION(SETPOINT))) {
-        CALC_DELTAS(deltas, blackboxCurrent->setpoint, blackboxPrev->setpoint, 4);
-        blackboxWriteTag8_4S16(deltas);
-    }
-
-    if (testBlackboxCondition(CONDITION(MIXER))) {
-        CALC_DELTAS(deltas, blackboxCurrent->mixer, blackboxPrev->mixer, 4);
-        blackboxWriteTag8_4S16(deltas);
-    }
-
-    if (testBlackboxCondition(CONDITION(PID))) {
-        CALC_DELTAS(deltas, blackboxCurrent->axisPID_P, blackboxPrev->axisPID_P, XYZ_AXIS_COUNT);
-        blackboxWriteTag2_3S32(deltas);
-
-        CALC_DELTAS(deltas, blackboxCurrent->axisPID_I, blackboxPrev->axisPID_I, XYZ_AXIS_COUNT);
-        blackboxWriteTag2_3S32(deltas);
-
-        CALC_DELTAS(deltas, blackboxCurrent->axisPID_D, blackboxPrev->axisPID_D, XYZ_AXIS_COUNT);
-        blackboxWriteTag2_3S32(deltas);
-
-        CALC_DELTAS(deltas, blackboxCurrent->axisPID_F, blackboxPrev->axisPID_F, XYZ_AXIS_COUNT);
-        blackboxWriteTag2_3S32(deltas);
-    }
-
-    if (testBlackboxCondition(CONDITION(BOOST))) {
-        CALC_DELTAS(deltas, blackboxCurrent->axisPID_B, blackboxPrev->axisPID_B, XYZ_AXIS_COUNT);
-        blackboxWriteTag2_3S32(deltas);
-    }
-
-    if (testBlackboxCondition(CONDITION(HSI))) {
-        CALC_DELTAS(deltas, blackboxCurrent->axisPID_O, blackboxPrev->axisPID_O, XYZ_AXIS_COUNT);
-        blackboxWriteTag2_3S32(deltas);
-    }
-
-    if (testBlackboxCondition(CONDITION(ATTITUDE))) {
-        CALC_DELTAS(deltas, blackboxCurrent->attitude, blackboxPrev->attitude, XYZ_AXIS_COUNT);
-        blackboxWriteTag2_3S32(deltas);
-    }
-
-    // Since gyro and acc are noisy, base their predictions on the average of the history
-    if (testBlackboxCondition(CONDITION(GYRAW))) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, gyroRAW), XYZ_AXIS_COUNT);
-    }
-    if (testBlackboxCondition(CONDITION(GYRO))) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, gyroADC), XYZ_AXIS_COUNT);
-    }
-    if (testBlackboxCondition(CONDITION(ACC))) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, accADC), XYZ_AXIS_COUNT);
-    }
+    for (int g = 0; g < blackboxMainGroupCount; g++) {
+        const blackboxMainGroup_t *group = &blackboxMainGroupList[g];
 
-    // Check for sensors that are updated periodically (so deltas are normally zero)
-    int packedFieldCount = 0;
+        for (int i = 0; i < group->count; i++) {
+            const blackboxMainField_t *field = &blackboxMainFieldList[group->start + i];
+            const uint32_t value = blackboxLoadField(blackboxCurrent, field);
 
-#ifdef USE_MAG
-    if (testBlackboxCondition(CONDITION(MAG))) {
-        for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
-            deltas[packedFieldCount++] = blackboxCurrent->magADC[i] - blackboxPrev->magADC[i];
+            switch (field->Ppredict) {
+            case PREDICT(PREVIOUS):
+                values[i] = value - blackboxLoadField(blackboxPrev1, field);
+                break;
+            case PREDICT(LINEAR):
+                /*
+                 * Used for time, which advances steadily with the looptime, so the second-order difference
+                 * is nearly zero.
+                 */
+                values[i] = value - 2 * (uint32_t)blackboxLoadField(blackboxPrev1, field) + blackboxLoadField(blackboxPrev2, field);
+                break;
+            case PREDICT(AVERAGE_2):
+                // Noisy fields are predicted from the average of the history
+                values[i] = value - (blackboxLoadField(blackboxPrev1, field) + blackboxLoadField(blackboxPrev2, field)) / 2;
+                break;
+            default:
+                values[i] = value;
+                break;
+            }
         }
-    }
-#endif
-#ifdef USE_BARO
-    if (testBlackboxCondition(CONDITION(ALT))) {
-        deltas[packedFieldCount++] = blackboxCurrent->altitude - blackboxPrev->altitude;
-#ifdef USE_VARIO
-        deltas[packedFieldCount++] = blackboxCurrent->vario - blackboxPrev->vario;
-#endif
-    }
-#endif
-    if (testBlackboxCondition(CONDITION(RSSI))) {
-        deltas[packedFieldCount++] = (int32_t) blackboxCurrent->rssi - blackboxPrev->rssi;
-    }
-    blackboxWriteTag8_8SVB(deltas, packedFieldCount);
-
-    if (testBlackboxCondition(CONDITION(VOLTAGE))) {
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->voltage - blackboxPrev->voltage);
-    }
-    if (testBlackboxCondition(CONDITION(CURRENT))) {
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->current - blackboxPrev->current);
-    }
-
-    if (testBlackboxCondition(CONDITION(VBEC))) {
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->vbec - blackboxPrev->vbec);
-    }
-    if (testBlackboxCondition(CONDITION(VBUS))) {
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->vbus - blackboxPrev->vbus);
-    }
-
-    if (testBlackboxCondition(CONDITION(ESC_TELEM))) {
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->esc_voltage - blackboxPrev->esc_voltage);
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->esc_current - blackboxPrev->esc_current);
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->esc_capa - blackboxPrev->esc_capa);
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->esc_rpm - blackboxPrev->esc_rpm);
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->esc_thr - blackboxPrev->esc_thr);
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->esc_pwm - blackboxPrev->esc_pwm);
-    }
-    if (testBlackboxCondition(CONDITION(BEC_TELEM))) {
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->bec_voltage - blackboxPrev->bec_voltage);
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->bec_current - blackboxPrev->bec_current);
-    }
-    if (testBlackboxCondition(CONDITION(ESC2_TELEM))) {
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->esc2_voltage - blackboxPrev->esc2_voltage);
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->esc2_current - blackboxPrev->esc2_current);
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->esc2_capa - blackboxPrev->esc2_capa);
-        blackboxWriteSignedVB((int32_t) blackboxCurrent->esc2_rpm - blackboxPrev->esc2_rpm);
-    }
 
-    packedFieldCount = 0;
-    if (testBlackboxCondition(CONDITION(TMCU))) {
-       deltas[packedFieldCount++] = blackboxCurrent->mcu_temp - blackboxPrev->mcu_temp;
-    }
-    if (testBlackboxCondition(CONDITION(TESC))) {
-        deltas[packedFieldCount++] = blackboxCurrent->esc_temp - blackboxPrev->esc_temp;
-    }
-    if (testBlackboxCondition(CONDITION(TBEC))) {
-        deltas[packedFieldCount++] = blackboxCurrent->bec_temp - blackboxPrev->bec_temp;
-    }
-    if (testBlackboxCondition(CONDITION(TESC2))) {
-        deltas[packedFieldCount++] = blackboxCurrent->esc2_temp - blackboxPrev->esc2_temp;
-    }
-    blackboxWriteTag8_8SVB(deltas, packedFieldCount);
-
-    if (testBlackboxCondition(CONDITION(HEADSPEED))) {
-        int32_t predictor = (blackboxHistory[1]->headspeed + blackboxHistory[2]->headspeed) / 2;
-        blackboxWriteSignedVB(blackboxCurrent->headspeed - predictor);
-    }
-    if (testBlackboxCondition(CONDITION(TAILSPEED))) {
-        int32_t predictor = (blackboxHistory[1]->tailspeed + blackboxHistory[2]->tailspeed) / 2;
-        blackboxWriteSignedVB(blackboxCurrent->tailspeed - predictor);
-    }
-
-    if (isFieldEnabled(FIELD_SELECT(MOTOR))) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, motor), motorCount);
-    }
-    if (isFieldEnabled(FIELD_SELECT(SERVO))) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, servo), servoCount);
+        switch (group->encode) {
+        case ENCODING(SIGNED_VB):
+            blackboxWriteSignedVB(values[0]);
+            break;
+        case ENCODING(UNSIGNED_VB):
+            blackboxWriteUnsignedVB(values[0]);
+            break;
+        case ENCODING(TAG8_4S16):
+            blackboxWriteTag8_4S16(values);
+            break;
+        case ENCODING(TAG2_3S32):
+            blackboxWriteTag2_3S32(values);
+            break;
+        case ENCODING(TAG2_3SVARIABLE):
+            blackboxWriteTag2_3SVariable(values);
+            break;
+        case ENCODING(TAG8_8SVB):
+            blackboxWriteTag8_8SVB(values, group->count);
+            break;
+        default:
+            break;
+        }
     }
 
-    if (testBlackboxCondition(CONDITION(DEBUG))) {
-        CALC_DELTAS(deltas, blackboxCurrent->debug, blackboxPrev->debug, DEBUG_VALUE_COUNT);
-        blackboxWriteSignedVBArray(deltas, DEBUG_VALUE_COUNT);
-    }
+    blackboxFrameEnd();
 
     // Rotate our history buffers
     blackboxHistory[2] = blackboxHistory[1];
@@ -1059,6 +984,7 @@ static void writeSlowFrame(void)
 {
     int32_t values[3];
 
+    blackboxFrameBegin();
     blackboxWrite('S');
 
     blackboxWriteUnsignedVB(slowHistory.flightModeFlags);
@@ -1071,6 +997,8 @@ static void writeSlowFrame(void)
     values[1] = slowHistory.rxSignalReceived ? 1 : 0;
     values[2] = slowHistory.rxFlightChannelsValid ? 1 : 0;
     blackboxWriteTag2_3S32(values);
+
+    blackboxFrameEnd();
 }
 
 /**
@@ -1136,6 +1064,26 @@ static void blackboxResetIterationTimers(void)
     blackboxIteration = 0;
 }
 
+static void blackboxSetRateShift(uint8_t shift)
+{
+    blackboxRateShift = shift;
+    blackboxRateTarget = shift;
+
+    blackboxPInterval = blackboxBasePInterval << shift;
+    blackboxIInterval = blackboxBaseIInterval << shift;
+    blackboxSInterval = blackboxBaseSInterval >> shift;
+    blackboxGInterval = blackboxBaseGInterval >> shift;
+}
+
+static void blackboxResetRate(void)
+{
+    blackboxSetRateShift(0);
+
+    blackboxRatePeakFill = 0;
+    blackboxRateQuietCount = 0;
+    blackboxRateFrameDrops = blackboxGetFrameDrops();
+}
+
 /**
  * Start Blackbox logging if it is not already running. Intended to be called upon arming.
  */
@@ -1166,7 +1114,9 @@ static void blackboxStart(void)
      * cache those now.
      */
     blackboxBuildConditionCache();
+    blackboxBuildMainFieldList();
     blackboxResetIterationTimers();
+    blackboxResetRate();
 
     /*
      * Record the beeper's current idea of the last arming beep time, so that we can detect it changing when
@@ -1225,18 +1175,22 @@ void blackboxCheckEnabler(timeUs_t currentTimeUs)
 #ifdef USE_GPS
 static void writeGPSHomeFrame(void)
 {
+    blackboxFrameBegin();
     blackboxWrite('H');
 
     blackboxWriteSignedVB(GPS_home[0]);
     blackboxWriteSignedVB(GPS_home[1]);
     //TODO it'd be great if we could grab the GPS current time and write that too
 
+    blackboxFrameEnd();
+
     gpsHistory.GPS_home[0] = GPS_home[0];
     gpsHistory.GPS_home[1] = GPS_home[1];
 }
 
 static void writeGPSFrame(timeUs_t currentTimeUs)
 {
+    blackboxFrameBegin();
     blackboxWrite('G');
 
     /*
@@ -1257,6 +1211,8 @@ static void writeGPSFrame(timeUs_t currentTimeUs)
     blackboxWriteUnsignedVB(gpsSol.groundSpeed);
     blackboxWriteUnsignedVB(gpsSol.groundCourse);
 
+    blackboxFrameEnd();
+
     gpsHistory.GPS_numSat = gpsSol.numSat;
     gpsHistory.GPS_coord[GPS_LATITUDE] = gpsSol.llh.lat;
     gpsHistory.GPS_coord[GPS_LONGITUDE] = gpsSol.llh.lon;
@@ -1271,6 +1227,7 @@ static void loadMainState(timeUs_t currentTimeUs)
 #ifndef UNIT_TEST
     blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
 
+    blackboxCurrent->iteration = blackboxIteration;
     blackboxCurrent->time = currentTimeUs;
 
     // ROLL/PITCH/YAW/COLLECTIVE
@@ -1403,6 +1360,9 @@ static void loadMainState(timeUs_t currentTimeUs)
  * Provide an array 'conditions' of FlightLogFieldCondition enums if you want these conditions to decide whether a field
  * should be included or not. Otherwise provide NULL for this parameter and NULL for secondCondition.
  *
+ * Provide an array 'fieldIndex' of field definition indexes to transmit only those fields, in that order. fieldCount is
+ * then the length of that array. Otherwise provide NULL to transmit all fields.
+ *
  * Set xmitState.headerIndex to 0 and xmitState.u.fieldIndex to -1 before calling for the first time.
  *
  * secondFieldDefinition and secondCondition element pointers need to be provided in order to compute the stride of the
@@ -1411,7 +1371,8 @@ static void loadMainState(timeUs_t currentTimeUs)
  * Returns true if there is still header left to transmit (so call again to continue transmission).
  */
 static bool sendFieldDefinition(char mainFrameChar, char deltaFrameChar, const void *fieldDefinitions,
-        const void *secondFieldDefinition, int fieldCount, const uint8_t *conditions, const uint8_t *secondCondition)
+        const void *secondFieldDefinition, int fieldCount, const uint8_t *conditions, const uint8_t *secondCondition,
+        const uint8_t *fieldIndex)
 {
     const blackboxFieldDefinition_t *def;
     unsigned int headerCount;
@@ -1452,9 +1413,11 @@ static bool sendFieldDefinition(char mainFrameChar, char deltaFrameChar, const v
     const uint32_t LONGEST_INTEGER_STRLEN = 2;
 
     for (; xmitState.u.fieldIndex < fieldCount; xmitState.u.fieldIndex++) {
-        def = (const blackboxFieldDefinition_t*) ((const char*)fieldDefinitions + definitionStride * xmitState.u.fieldIndex);
+        const int index = fieldIndex ? fieldIndex[xmitState.u.fieldIndex] : xmitState.u.fieldIndex;
+
+        def = (const blackboxFieldDefinition_t*) ((const char*)fieldDefinitions + definitionStride * index);
 
-        if (!conditions || testBlackboxCondition(conditions[conditionsStride * xmitState.u.fieldIndex])) {
+        if (!conditions || testBlackboxCondition(conditions[conditionsStride * index])) {
             // First (over)estimate the length of the string we want to print
 
             int32_t bytesToWrite = 1; // Leading comma
@@ -1746,6 +1709,7 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE(PARAM_NAME_DEBUG_MODE, "%d",             debugMode);
         BLACKBOX_PRINT_HEADER_LINE(PARAM_NAME_DEBUG_AXIS, "%d",             debugAxis);
         BLACKBOX_PRINT_HEADER_LINE("fields_mask", "%d",                     blackboxConfig()->fields);
+        BLACKBOX_PRINT_HEADER_LINE("adaptive_rate", "%d",                   blackboxConfig()->adaptiveRate);
 
         default:
             return true;
@@ -1771,6 +1735,7 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data)
     }
 
     //Shared header for event frames
+    blackboxFrameBegin();
     blackboxWrite('E');
     blackboxWrite(event);
 
@@ -1819,6 +1784,11 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data)
         blackboxWriteUnsignedVB(data->loggingResume.logIteration);
         blackboxWriteUnsignedVB(data->loggingResume.currentTime);
         break;
+    case FLIGHT_LOG_EVENT_LOGGING_RATE:
+        blackboxWriteUnsignedVB(data->loggingRate.logIteration);
+        blackboxWriteUnsignedVB(data->loggingRate.pInterval);
+        blackboxWriteUnsignedVB(data->loggingRate.iInterval);
+        break;
     case FLIGHT_LOG_EVENT_LOG_END:
         blackboxWriteString("End of log");
         blackboxWrite(0);
@@ -1826,6 +1796,8 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data)
     default:
         break;
     }
+
+    blackboxFrameEnd();
 }
 
 void blackboxLogCustomData(const uint8_t *ptr, size_t length)
@@ -1945,6 +1917,59 @@ static bool blackboxShouldLogGpsHomeFrame(void)
 
 #endif // GPS
 
+/*
+ * Follow the device buffer fill and pick the logging rate for the next I-frame interval.
+ *
+ * The rate only changes on an iteration that is an I-frame under both the old and the new
+ * intervals, so the P-frame history stays valid and the decoder gets a LOGGING_RATE event
+ * followed by a fresh I-frame.
+ */
+static void blackboxUpdateRate(void)
+{
+    if (!blackboxShouldLogFastFrame()) {
+        return;
+    }
+
+    const uint8_t fill = blackboxDeviceGetBufferFill();
+    blackboxRatePeakFill = MAX(blackboxRatePeakFill, fill);
+
+    if (!blackboxShouldLogIFrame()) {
+        return;
+    }
+
+    const uint32_t drops = blackboxGetFrameDrops();
+
+    if (drops != blackboxRateFrameDrops || blackboxRatePeakFill >= BLACKBOX_RATE_FILL_HIGH) {
+        if (blackboxRateShift < BLACKBOX_RATE_SHIFT_MAX) {
+            blackboxRateTarget = blackboxRateShift + 1;
+        }
+        blackboxRateQuietCount = 0;
+    }
+    else if (blackboxRatePeakFill <= BLACKBOX_RATE_FILL_LOW) {
+        if (blackboxRateShift > 0 && ++blackboxRateQuietCount >= BLACKBOX_RATE_RECOVERY_COUNT) {
+            blackboxRateTarget = blackboxRateShift - 1;
+            blackboxRateQuietCount = 0;
+        }
+    }
+    else {
+        blackboxRateQuietCount = 0;
+    }
+
+    blackboxRateFrameDrops = drops;
+    blackboxRatePeakFill = 0;
+
+    if (blackboxRateTarget != blackboxRateShift &&
+        (blackboxIteration % (blackboxBaseIInterval << blackboxRateTarget)) == 0) {
+        blackboxSetRateShift(blackboxRateTarget);
+
+        flightLogEvent_loggingRate_t eventData;
+        eventData.logIteration = blackboxIteration;
+        eventData.pInterval = blackboxPInterval;
+        eventData.iInterval = blackboxIInterval;
+        blackboxLogEvent(FLIGHT_LOG_EVENT_LOGGING_RATE, (flightLogEventData_t *)&eventData);
+    }
+}
+
 // Called once every FC loop in PAUSED and RUNNING states
 static void blackboxAdvanceIterationTimers(void)
 {
@@ -1954,6 +1979,10 @@ static void blackboxAdvanceIterationTimers(void)
 // Called once every FC loop in order to log the current state
 static void blackboxLogIteration(timeUs_t currentTimeUs)
 {
+    if (blackboxConfig()->adaptiveRate) {
+        blackboxUpdateRate();
+    }
+
     if (blackboxShouldLogFastFrame()) {
         blackboxCheckAndLogArmingBeep();
         blackboxCheckAndLogFlightMode();
@@ -2023,6 +2052,8 @@ void blackboxUpdate(timeUs_t currentTimeUs)
         if (blackboxIsLoggingEnabled()) {
             blackboxOpen();
             blackboxStart();
+        } else {
+            blackboxDeviceIdle();
         }
         break;
     case BLACKBOX_STATE_WAIT_FOR_READY:
@@ -2064,8 +2095,8 @@ void blackboxUpdate(timeUs_t currentTimeUs)
     case BLACKBOX_STATE_SEND_MAIN_FIELD_HEADER:
         blackboxReplenishHeaderBudget();
         //On entry of this state, xmitState.headerIndex is 0 and xmitState.u.fieldIndex is -1
-        if (!sendFieldDefinition('I', 'P', blackboxMainFields, blackboxMainFields + 1, ARRAYLEN(blackboxMainFields),
-                &blackboxMainFields[0].condition, &blackboxMainFields[1].condition)) {
+        if (!sendFieldDefinition('I', 'P', blackboxMainFields, blackboxMainFields + 1, blackboxMainFieldCount,
+                NULL, NULL, blackboxMainFieldIndex)) {
 #ifdef USE_GPS
             if (featureIsEnabled(FEATURE_GPS) && isFieldEnabled(FIELD_SELECT(GPS))) {
                 blackboxSetState(BLACKBOX_STATE_SEND_GPS_H_HEADER);
@@ -2079,7 +2110,7 @@ void blackboxUpdate(timeUs_t currentTimeUs)
         blackboxReplenishHeaderBudget();
         //On entry of this state, xmitState.headerIndex is 0 and xmitState.u.fieldIndex is -1
         if (!sendFieldDefinition('H', 0, blackboxGpsHFields, blackboxGpsHFields + 1, ARRAYLEN(blackboxGpsHFields),
-                NULL, NULL) && isFieldEnabled(FIELD_SELECT(GPS))) {
+                NULL, NULL, NULL) && isFieldEnabled(FIELD_SELECT(GPS))) {
             blackboxSetState(BLACKBOX_STATE_SEND_GPS_G_HEADER);
         }
         break;
@@ -2087,7 +2118,7 @@ void blackboxUpdate(timeUs_t currentTimeUs)
         blackboxReplenishHeaderBudget();
         //On entry of this state, xmitState.headerIndex is 0 and xmitState.u.fieldIndex is -1
         if (!sendFieldDefinition('G', 0, blackboxGpsGFields, blackboxGpsGFields + 1, ARRAYLEN(blackboxGpsGFields),
-                &blackboxGpsGFields[0].condition, &blackboxGpsGFields[1].condition) && isFieldEnabled(FIELD_SELECT(GPS))) {
+                &blackboxGpsGFields[0].condition, &blackboxGpsGFields[1].condition, NULL) && isFieldEnabled(FIELD_SELECT(GPS))) {
             blackboxSetState(BLACKBOX_STATE_SEND_SLOW_HEADER);
         }
         break;
@@ -2096,7 +2127,7 @@ void blackboxUpdate(timeUs_t currentTimeUs)
         blackboxReplenishHeaderBudget();
         //On entry of this state, xmitState.headerIndex is 0 and xmitState.u.fieldIndex is -1
         if (!sendFieldDefinition('S', 0, blackboxSlowFields, blackboxSlowFields + 1, ARRAYLEN(blackboxSlowFields),
-                NULL, NULL)) {
+                NULL, NULL, NULL)) {
             cacheFlushNextState = BLACKBOX_STATE_SEND_SYSINFO;
             blackboxSetState(BLACKBOX_STATE_CACHE_FLUSH);
         }
@@ -2208,7 +2239,7 @@ void blackboxUpdate(timeUs_t currentTimeUs)
     }
 }
 
-uint8_t blackboxGetRateDenom(void)
+uint16_t blackboxGetRateDenom(void)
 {
     return blackboxPInterval;
 }
@@ -2228,24 +2259,26 @@ void blackboxInit(void)
 {
     blackboxResetIterationTimers();
 
-    blackboxPInterval = constrain(blackboxConfig()->denom, 1, 8000);
+    blackboxBasePInterval = constrain(blackboxConfig()->denom, 1, 8000);
 
     // I-frame is written at least every 32ms or 64 P-frames
-    uint32_t Imul = (32 * gyro.targetRateHz) / (1000 * blackboxPInterval);
+    uint32_t Imul = (32 * gyro.targetRateHz) / (1000 * blackboxBasePInterval);
 
     // Make sure Iinterval is a multiple of Pinterval
     if (Imul > 64)
-        blackboxIInterval = blackboxPInterval * 64;
+        blackboxBaseIInterval = blackboxBasePInterval * 64;
     else if (Imul > 0)
-        blackboxIInterval = blackboxPInterval * Imul;
+        blackboxBaseIInterval = blackboxBasePInterval * Imul;
     else
-        blackboxIInterval = blackboxPInterval;
+        blackboxBaseIInterval = blackboxBasePInterval;
 
     // S-frame is written at least every 5s
-    blackboxSInterval = 5 * gyro.targetRateHz / blackboxPInterval;
+    blackboxBaseSInterval = 5 * gyro.targetRateHz / blackboxBasePInterval;
 
     // GPS frame is written at least every 10s
-    blackboxGInterval = 10 * gyro.targetRateHz / blackboxIInterval;
+    blackboxBaseGInterval = 10 * gyro.targetRateHz / blackboxBaseIInterval;
+
+    blackboxResetRate();
 
     if (blackboxConfig()->device)
         blackboxSetState(BLACKBOX_STATE_STOPPED);
@@ -46,6 +46,7 @@ bool isBlackboxErased(void);
 void blackboxSetStartDateTime(const char *dateTime, timeMs_t timeNowMs);
 void blackboxValidateConfig(void);
 bool blackboxMayEditConfig(void);
+uint32_t blackboxGetFieldSetHash(void);
 
 #ifdef UNIT_TEST
 STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs);
@@ -113,6 +113,7 @@ typedef enum {
     FLIGHT_LOG_EVENT_GOVSTATE = 50,   // Add new event type for main motor governor state.
     FLIGHT_LOG_EVENT_RESCUE_STATE = 51,
     FLIGHT_LOG_EVENT_AIRBORNE_STATE = 52,
+    FLIGHT_LOG_EVENT_LOGGING_RATE = 53,
     FLIGHT_LOG_EVENT_CUSTOM_DATA = 100,
     FLIGHT_LOG_EVENT_CUSTOM_STRING = 101,
     FLIGHT_LOG_EVENT_LOG_END = 255
@@ -219,6 +220,12 @@ typedef struct flightLogEvent_loggingResume_s {
     uint32_t currentTime;
 } flightLogEvent_loggingResume_t;
 
+typedef struct flightLogEvent_loggingRate_s {
+    uint32_t logIteration;
+    uint32_t pInterval;
+    uint32_t iInterval;
+} flightLogEvent_loggingRate_t;
+
 #define FLIGHT_LOG_EVENT_INFLIGHT_ADJUSTMENT_FUNCTION_FLOAT_VALUE_FLAG 128
 
 typedef union flightLogEventData_u {
@@ -232,6 +239,7 @@ typedef union flightLogEventData_u {
     flightLogEvent_customData_t data;
     flightLogEvent_customString_t string;
     flightLogEvent_loggingResume_t loggingResume;
+    flightLogEvent_loggingRate_t loggingRate;
 } flightLogEventData_t;
 
 typedef struct flightLogEvent_s {
@@ -44,6 +44,7 @@
 
 #include "blackbox.h"
 #include "blackbox_io.h"
+#include "blackbox_logdir.h"
 
 #include "common/maths.h"
 
@@ -86,6 +87,10 @@ static struct {
         BLACKBOX_SDCARD_READY_TO_CREATE_LOG,
         BLACKBOX_SDCARD_READY_TO_LOG
     } state;
+
+    // Rest of a frame that afatfs_fwrite() cut short, written before anything else
+    uint8_t frameTail[BLACKBOX_FRAME_BUFFER_SIZE];
+    uint16_t frameTailLength;
 } blackboxSDCard;
 
 #define LOGFILE_PREFIX "LOG"
@@ -108,21 +113,94 @@ static uint16_t bbRateMax;
 static uint32_t bbDrops;
 #endif
 
-void blackboxWrite(uint8_t value)
-{
+static uint8_t blackboxFrameBuffer[BLACKBOX_FRAME_BUFFER_SIZE];
+static uint8_t *blackboxFrameStart;
+static bool blackboxFrameOverflow;
+static uint32_t blackboxFrameDrops;
+
+uint8_t *blackboxFramePos = NULL;
+uint8_t *blackboxFrameLimit = NULL;
+
 #ifdef DEBUG_BB_OUTPUT
-    bbBits += 8;
+static void blackboxOutputAccount(uint32_t bits)
+{
+    bbBits += bits;
+
+    timeMs_t now = millis();
+
+    if (now > bbLastclearMs + 100) {  // Debug log every 100[msec]
+        uint16_t bbRate = ((bbBits * 10 + 5) / (now - bbLastclearMs)) / 10; // In unit of [Kbps]
+        DEBUG_SET(DEBUG_BLACKBOX_OUTPUT, 0, bbRate);
+        if (bbRate > bbRateMax) {
+            bbRateMax = bbRate;
+            DEBUG_SET(DEBUG_BLACKBOX_OUTPUT, 1, bbRateMax);
+        }
+        bbLastclearMs = now;
+        bbBits = 0;
+    }
+}
+
+static void blackboxOutputDrop(uint32_t bytes)
+{
+    bbDrops += bytes;
+    DEBUG_SET(DEBUG_BLACKBOX_OUTPUT, 2, bbDrops);
+}
+#else
+#define blackboxOutputAccount(bits)
+#define blackboxOutputDrop(bytes)
+#endif
+
+#ifdef USE_SDCARD
+// Write what is left of the last frame. Returns true once all of it is written.
+static bool blackboxSDCardWriteTail(void)
+{
+    if (blackboxSDCard.frameTailLength && !afatfs_fileIsBusy(blackboxSDCard.logFile)) {
+        const uint32_t written = afatfs_fwrite(blackboxSDCard.logFile, blackboxSDCard.frameTail, blackboxSDCard.frameTailLength);
+
+        blackboxOutputAccount(written * 8);
+
+        blackboxSDCard.frameTailLength -= written;
+        memmove(blackboxSDCard.frameTail, blackboxSDCard.frameTail + written, blackboxSDCard.frameTailLength);
+    }
+
+    return blackboxSDCard.frameTailLength == 0;
+}
 #endif
 
+void blackboxWriteByte(uint8_t value)
+{
+    if (blackboxFramePos) {
+        if (blackboxFrameStart != blackboxFrameBuffer) {
+            // Reserved device space exhausted, continue the frame in the staging buffer
+            const uint32_t length = blackboxFramePos - blackboxFrameStart;
+            memcpy(blackboxFrameBuffer, blackboxFrameStart, length);
+            blackboxFrameStart = blackboxFrameBuffer;
+            blackboxFramePos = blackboxFrameBuffer + length;
+            blackboxFrameLimit = blackboxFrameBuffer + sizeof(blackboxFrameBuffer);
+            blackboxWrite(value);
+        } else {
+            // Staging buffer full, the frame will be dropped in blackboxFrameEnd()
+            blackboxFrameOverflow = true;
+        }
+        return;
+    }
+
     switch (blackboxConfig()->device) {
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
         flashfsWriteByte(value);
+        blackboxOutputAccount(8);
         break;
 #endif
 #ifdef USE_SDCARD
     case BLACKBOX_DEVICE_SDCARD:
+        // Never in the middle of a frame
+        if (!blackboxSDCardWriteTail()) {
+            blackboxOutputDrop(1);
+            return;
+        }
         afatfs_fputc(blackboxSDCard.logFile, value);
+        blackboxOutputAccount(8);
         break;
 #endif
     case BLACKBOX_DEVICE_SERIAL:
@@ -130,37 +208,127 @@ void blackboxWrite(uint8_t value)
         {
             int txBytesFree = serialTxBytesFree(blackboxPort);
 
-#ifdef DEBUG_BB_OUTPUT
-            bbBits += 2;
             DEBUG_SET(DEBUG_BLACKBOX_OUTPUT, 3, txBytesFree);
-#endif
 
             if (txBytesFree == 0) {
-#ifdef DEBUG_BB_OUTPUT
-                ++bbDrops;
-                DEBUG_SET(DEBUG_BLACKBOX_OUTPUT, 2, bbDrops);
-#endif
+                blackboxOutputDrop(1);
                 return;
             }
             serialWrite(blackboxPort, value);
+            blackboxOutputAccount(10);
         }
         break;
     }
+}
 
-#ifdef DEBUG_BB_OUTPUT
-    timeMs_t now = millis();
+// Write a complete frame to the device, or nothing at all if it doesn't fit
+static bool blackboxDeviceWriteFrame(const uint8_t *data, uint32_t length)
+{
+    switch (blackboxConfig()->device) {
+#ifdef USE_FLASHFS
+    case BLACKBOX_DEVICE_FLASH:
+        if (length > flashfsGetWriteBufferFreeSpace()) {
+            return false;
+        }
+        flashfsWrite(data, length);
+        blackboxOutputAccount(length * 8);
+        break;
+#endif
+#ifdef USE_SDCARD
+    case BLACKBOX_DEVICE_SDCARD:
+        // The previous frame must be complete first
+        if (!blackboxSDCardWriteTail()) {
+            return false;
+        }
+        // A pending seek would make afatfs_fwrite() return without writing anything
+        if (afatfs_fileIsBusy(blackboxSDCard.logFile)) {
+            return false;
+        }
+        // The frame is smaller than a sector, but it may straddle two of them
+        if (length + AFATFS_SECTOR_SIZE > afatfs_getFreeBufferSpace()) {
+            return false;
+        }
+        {
+            const uint32_t written = afatfs_fwrite(blackboxSDCard.logFile, data, length);
 
-    if (now > bbLastclearMs + 100) {  // Debug log every 100[msec]
-        uint16_t bbRate = ((bbBits * 10 + 5) / (now - bbLastclearMs)) / 10; // In unit of [Kbps]
-        DEBUG_SET(DEBUG_BLACKBOX_OUTPUT, 0, bbRate);
-        if (bbRate > bbRateMax) {
-            bbRateMax = bbRate;
-            DEBUG_SET(DEBUG_BLACKBOX_OUTPUT, 1, bbRateMax);
+            blackboxOutputAccount(written * 8);
+
+            // Crossing into a new cluster may need a FAT lookup, which cuts the write short.
+            // Keep the rest for the next write, so the log never holds part of a frame.
+            if (written < length) {
+                memcpy(blackboxSDCard.frameTail, data + written, length - written);
+                blackboxSDCard.frameTailLength = length - written;
+            }
         }
-        bbLastclearMs = now;
-        bbBits = 0;
+        break;
+#endif
+    case BLACKBOX_DEVICE_SERIAL:
+    default:
+        {
+            int txBytesFree = serialTxBytesFree(blackboxPort);
+
+            DEBUG_SET(DEBUG_BLACKBOX_OUTPUT, 3, txBytesFree);
+
+            if (length > (uint32_t)txBytesFree) {
+                return false;
+            }
+            serialWriteBuf(blackboxPort, data, length);
+            blackboxOutputAccount(length * 10);
+        }
+        break;
+    }
+
+    return true;
+}
+
+void blackboxFrameBegin(void)
+{
+    blackboxFrameOverflow = false;
+
+#ifdef USE_FLASHFS
+    // Encode straight into the flashfs write buffer when possible
+    if (blackboxConfig()->device == BLACKBOX_DEVICE_FLASH) {
+        uint8_t *data;
+        const uint32_t space = flashfsWriteReserve(&data);
+        if (space > 0) {
+            blackboxFrameStart = data;
+            blackboxFramePos = data;
+            blackboxFrameLimit = data + space;
+            return;
+        }
+    }
+#endif
+
+    blackboxFrameStart = blackboxFrameBuffer;
+    blackboxFramePos = blackboxFrameBuffer;
+    blackboxFrameLimit = blackboxFrameBuffer + sizeof(blackboxFrameBuffer);
+}
+
+void blackboxFrameEnd(void)
+{
+    const uint32_t length = blackboxFramePos - blackboxFrameStart;
+
+    blackboxFramePos = NULL;
+    blackboxFrameLimit = NULL;
+
+#ifdef USE_FLASHFS
+    if (blackboxFrameStart != blackboxFrameBuffer) {
+        flashfsWriteCommit(length);
+        blackboxOutputAccount(length * 8);
+        return;
     }
 #endif
+
+    if (blackboxFrameOverflow || !blackboxDeviceWriteFrame(blackboxFrameBuffer, length)) {
+        blackboxOutputDrop(length);
+        blackboxFrameDrops++;
+    }
+}
+
+// Number of frames dropped because the device couldn't take them
+uint32_t blackboxGetFrameDrops(void)
+{
+    return blackboxFrameDrops;
 }
 
 // Print the null-terminated string 's' to the blackbox device and return the number of bytes written
@@ -169,6 +337,16 @@ int blackboxWriteString(const char *s)
     int length;
     const uint8_t *pos;
 
+    // Inside a frame the string goes to the staging buffer
+    if (blackboxFramePos) {
+        pos = (uint8_t*) s;
+        while (*pos) {
+            blackboxWrite(*pos);
+            pos++;
+        }
+        return pos - (uint8_t*) s;
+    }
+
     switch (blackboxConfig()->device) {
 
 #ifdef USE_FLASHFS
@@ -218,6 +396,12 @@ void blackboxDeviceFlush(void)
         break;
 #endif // USE_FLASHFS
 
+#ifdef USE_SDCARD
+    case BLACKBOX_DEVICE_SDCARD:
+        blackboxSDCardWriteTail();
+        break;
+#endif // USE_SDCARD
+
     default:
         ;
     }
@@ -247,7 +431,7 @@ bool blackboxDeviceFlushForce(void)
         // However the "flush" only queues one dirty sector each time and the process is asynchronous. So after
         // the last dirty sector is queued the flush returns true even though the sector may not actually have
         // been physically written to the SD card yet.
-        return afatfs_flush();
+        return blackboxSDCardWriteTail() && afatfs_flush();
 #endif // USE_SDCARD
 
     default:
@@ -374,6 +558,9 @@ void blackboxDeviceErase(void)
 {
     if (blackboxConfig()->device == BLACKBOX_DEVICE_FLASH) {
         flashfsEraseCompletely();
+#ifdef USE_BLACKBOX_LOGDIR
+        blackboxLogDirCancel();
+#endif
     }
 }
 #endif
@@ -403,6 +590,18 @@ void blackboxDeviceInitialErase(void)
 #endif
 }
 
+/**
+ * Background work on the logging device while the blackbox is stopped.
+ */
+void blackboxDeviceIdle(void)
+{
+#ifdef USE_BLACKBOX_LOGDIR
+    if (blackboxConfig()->device == BLACKBOX_DEVICE_FLASH) {
+        blackboxLogDirUpdate();
+    }
+#endif
+}
+
 /**
  * Close the Blackbox logging device.
  */
@@ -427,6 +626,9 @@ void blackboxDeviceClose(void)
     case BLACKBOX_DEVICE_FLASH:
         // Some flash device, e.g., NAND devices, require explicit close to flush internally buffered data.
         flashfsClose();
+#ifdef USE_BLACKBOX_LOGDIR
+        blackboxLogDirEnd();
+#endif
         break;
 #endif
     default:
@@ -564,6 +766,11 @@ bool blackboxDeviceBeginLog(void)
     case BLACKBOX_DEVICE_SDCARD:
         return blackboxSDCardBeginLog();
 #endif // USE_SDCARD
+#ifdef USE_BLACKBOX_LOGDIR
+    case BLACKBOX_DEVICE_FLASH:
+        blackboxLogDirBegin(blackboxGetFieldSetHash());
+        return true;
+#endif // USE_BLACKBOX_LOGDIR
     default:
         return true;
     }
@@ -586,6 +793,10 @@ bool blackboxDeviceEndLog(bool retainLog)
     switch (blackboxConfig()->device) {
 #ifdef USE_SDCARD
     case BLACKBOX_DEVICE_SDCARD:
+        // The log ends with a complete frame
+        if (retainLog && !blackboxSDCardWriteTail()) {
+            return false;
+        }
         // Keep retrying until the close operation queues
         if (
             (retainLog && afatfs_fclose(blackboxSDCard.logFile, NULL))
@@ -593,6 +804,7 @@ bool blackboxDeviceEndLog(bool retainLog)
         ) {
             // Don't bother waiting the for the close to complete, it's queued now and will complete eventually
             blackboxSDCard.logFile = NULL;
+            blackboxSDCard.frameTailLength = 0;
             blackboxSDCard.state = BLACKBOX_SDCARD_READY_TO_CREATE_LOG;
             return true;
         }
@@ -686,6 +898,45 @@ void blackboxReplenishHeaderBudget(void)
     blackboxHeaderBudget = MIN(MIN(freeSpace, blackboxHeaderBudget + blackboxMaxHeaderBytesPerIteration), BLACKBOX_MAX_ACCUMULATED_HEADER_BUDGET);
 }
 
+/**
+ * Return how full the device write buffer is, in percent. Used to back off the logging rate before the device starts
+ * dropping frames.
+ */
+uint8_t blackboxDeviceGetBufferFill(void)
+{
+    uint32_t size;
+    uint32_t freeSpace;
+
+    switch (blackboxConfig()->device) {
+    case BLACKBOX_DEVICE_SERIAL:
+        // USB VCP has no tx buffer of its own
+        size = blackboxPort->txBufferSize;
+        freeSpace = serialTxBytesFree(blackboxPort);
+        break;
+#ifdef USE_FLASHFS
+    case BLACKBOX_DEVICE_FLASH:
+        size = flashfsGetWriteBufferSize();
+        freeSpace = flashfsGetWriteBufferFreeSpace();
+        break;
+#endif
+#ifdef USE_SDCARD
+    case BLACKBOX_DEVICE_SDCARD:
+        size = afatfs_getBufferSize();
+        freeSpace = afatfs_getFreeBufferSpace();
+        break;
+#endif
+    default:
+        size = 0;
+        freeSpace = 0;
+    }
+
+    if (size == 0 || freeSpace >= size) {
+        return 0;
+    }
+
+    return 100 - (freeSpace * 100) / size;
+}
+
 /**
  * You must call this function before attempting to write Blackbox header bytes to ensure that the write will not
  * cause buffers to overflow. The number of bytes you can write is capped by the blackboxHeaderBudget. Calling this
@@ -38,12 +38,38 @@ typedef enum {
  */
 #define BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION 64
 
+/*
+ * Log frames are encoded into a staging buffer between blackboxFrameBegin() and blackboxFrameEnd(), and then handed
+ * to the device in a single write. If the device can't take the whole frame, the frame is dropped, so that the log
+ * never contains a partial frame.
+ */
+#ifndef BLACKBOX_FRAME_BUFFER_SIZE
+#define BLACKBOX_FRAME_BUFFER_SIZE 512
+#endif
+
 extern int32_t blackboxHeaderBudget;
 
+// Staging buffer write position and limit, both NULL when no frame is open
+extern uint8_t *blackboxFramePos;
+extern uint8_t *blackboxFrameLimit;
+
 void blackboxOpen(void);
-void blackboxWrite(uint8_t value);
+void blackboxWriteByte(uint8_t value);
 int blackboxWriteString(const char *s);
 
+static inline void blackboxWrite(uint8_t value)
+{
+    if (blackboxFramePos < blackboxFrameLimit) {
+        *blackboxFramePos++ = value;
+    } else {
+        blackboxWriteByte(value);
+    }
+}
+
+void blackboxFrameBegin(void);
+void blackboxFrameEnd(void);
+uint32_t blackboxGetFrameDrops(void);
+
 void blackboxDeviceFlush(void);
 bool blackboxDeviceFlushForce(void);
 bool blackboxDeviceFlushForceComplete(void);
@@ -63,6 +89,8 @@ int32_t blackboxGetLogNumber(void);
 
 void blackboxReplenishHeaderBudget(void);
 blackboxBufferReserveStatus_e blackboxDeviceReserveBufferSpace(int32_t bytes);
+uint8_t blackboxDeviceGetBufferFill(void);
 int8_t blackboxGetLogFileNo(void);
 
 void blackboxDeviceInitialErase(void);
+void blackboxDeviceIdle(void);
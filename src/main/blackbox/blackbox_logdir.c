@@ -0,0 +1,841 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Blackbox log directory on dataflash
+ *
+ * Finding the logs on the flash used to mean reading the start of every
+ * page in the used space, looking for the log header. On a large NAND
+ * flash that takes seconds. Instead, a record for every log is appended
+ * to a small directory partition when the log is closed, and the logs
+ * are enumerated from the records.
+ *
+ * The directory has two banks of one sector each, one record per page.
+ * The active bank is the one with the newest last record. When it is
+ * full, the newer half of the records is copied to the other bank, with
+ * the older half merged into a single record. The active bank only
+ * changes once the copy is complete.
+ *
+ * Closing a log never waits for an erase. A bank that needs erasing is
+ * left to blackboxLogDirUpdate(), which erases it while the blackbox is
+ * stopped. Until then, the logs that can't be recorded are found by the
+ * scan below.
+ *
+ * The directory sectors used to be the end of FlashFS, so after an
+ * upgrade they may still hold logs. The directory only takes them over
+ * once they hold its records or read blank; that check also runs in
+ * blackboxLogDirUpdate(). Until then, the directory is treated as
+ * missing. A full flash erase makes them blank.
+ *
+ * Any part of the used space not covered by the records (logs written
+ * before the directory existed, or not closed before a power loss) is
+ * scanned for log headers like before. If the directory is unreadable,
+ * the whole used space is scanned, and the directory starts over with
+ * the next log.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_FLASHFS
+
+#include "common/crc.h"
+#include "common/maths.h"
+#include "common/strtol.h"
+#include "common/time.h"
+#include "common/utils.h"
+
+#include "drivers/flash.h"
+
+#include "io/flashfs.h"
+
+#include "pg/time.h"
+
+#include "blackbox/blackbox_logdir.h"
+
+
+#define LOGDIR_RECORD_MAGIC     0xB10C
+#define LOGDIR_BANK_COUNT       2
+
+#define LOGDIR_FLAG_MERGED      BIT(0)  // Covers the logs dropped in a compaction
+#define LOGDIR_FLAG_PARTIAL     BIT(1)  // The log rolled over its own start
+
+#define LOGDIR_HEADER_BUF_SIZE  32
+#define LOGDIR_BLANK_CHECK_SIZE 64
+
+typedef struct {
+    uint16_t magic;
+    uint16_t sequence;
+    uint32_t address;       // Physical FlashFS address of the log start
+    uint32_t length;
+    uint32_t startTime;
+    uint32_t fieldHash;
+    uint16_t flags;
+    uint16_t crc;
+} logDirRecord_t;
+
+STATIC_ASSERT(sizeof(logDirRecord_t) == 24, logDirRecord_size);
+
+typedef enum {
+    LOGDIR_RECORD_VALID,
+    LOGDIR_RECORD_ERASED,
+    LOGDIR_RECORD_INVALID,
+} logDirRecordState_e;
+
+typedef enum {
+    LOGDIR_OK,
+    LOGDIR_MISSING,
+    LOGDIR_CORRUPT,
+} logDirStatus_e;
+
+typedef enum {
+    LOGDIR_REGION_UNKNOWN,
+    LOGDIR_REGION_OWNED,    // Holds directory records, or was found blank
+    LOGDIR_REGION_FOREIGN,  // Holds something else, e.g. logs from before the directory
+} logDirRegion_e;
+
+typedef struct {
+    uint32_t address;       // Physical address of the first bank
+    uint32_t bankSize;
+    uint16_t pageSize;
+    uint16_t slots;         // Records per bank
+    uint16_t count;         // Records in the active bank
+    uint16_t sequence;      // Sequence number of the newest record
+    uint8_t bank;           // Active bank
+} logDir_t;
+
+typedef struct {
+    blackboxLogVisitor_t visitor;
+    void (*progress)(void);
+    void *context;
+    int count;
+    bool scan;              // Scan the space not covered by the records
+    bool stopped;
+} logDirEnum_t;
+
+static const char logHeader[] = "H Product:Blackbox";
+static const char timeHeader[] = "H Log start datetime:";
+
+
+/*
+ * Directory access
+ */
+
+#ifdef USE_BLACKBOX_LOGDIR
+
+static uint32_t logDirSlotAddress(const logDir_t *dir, int bank, int slot)
+{
+    return dir->address + bank * dir->bankSize + slot * dir->pageSize;
+}
+
+static uint16_t logDirRecordCrc(const logDirRecord_t *record)
+{
+    return crc16_ccitt_update(0, record, offsetof(logDirRecord_t, crc));
+}
+
+static logDirRecordState_e logDirReadRecord(const logDir_t *dir, int bank, int slot, logDirRecord_t *record)
+{
+    STATIC_DMA_DATA_AUTO logDirRecord_t buffer;
+
+    if (flashReadBytes(logDirSlotAddress(dir, bank, slot), (uint8_t *)&buffer, sizeof(buffer)) < (int)sizeof(buffer)) {
+        return LOGDIR_RECORD_INVALID;
+    }
+
+    *record = buffer;
+
+    if (record->magic == LOGDIR_RECORD_MAGIC && record->crc == logDirRecordCrc(record)) {
+        return LOGDIR_RECORD_VALID;
+    }
+
+    const uint8_t *bytes = (const uint8_t *)record;
+    for (unsigned i = 0; i < sizeof(*record); i++) {
+        if (bytes[i] != 0xFF) {
+            return LOGDIR_RECORD_INVALID;
+        }
+    }
+
+    return LOGDIR_RECORD_ERASED;
+}
+
+static bool logDirWriteRecord(const logDir_t *dir, int bank, int slot, logDirRecord_t *record)
+{
+    STATIC_DMA_DATA_AUTO logDirRecord_t buffer;
+
+    // Never program over anything but erased flash
+    if (logDirReadRecord(dir, bank, slot, &buffer) != LOGDIR_RECORD_ERASED) {
+        return false;
+    }
+
+    record->magic = LOGDIR_RECORD_MAGIC;
+    record->crc = logDirRecordCrc(record);
+
+    buffer = *record;
+
+    flashPageProgram(logDirSlotAddress(dir, bank, slot), (const uint8_t *)&buffer, sizeof(buffer), NULL);
+    flashFlush();
+    flashWaitForReady();
+
+    return true;
+}
+
+
+/*
+ * Number of records in a bank. Records are only ever appended,
+ * so the first erased slot can be found with a binary search.
+ */
+static int logDirBankCount(const logDir_t *dir, int bank)
+{
+    logDirRecord_t record;
+
+    int left = 0;
+    int right = dir->slots;
+
+    while (left < right) {
+        const int mid = (left + right) / 2;
+
+        if (logDirReadRecord(dir, bank, mid, &record) == LOGDIR_RECORD_ERASED) {
+            right = mid;
+        } else {
+            left = mid + 1;
+        }
+    }
+
+    return left;
+}
+
+// The directory region is only written once it is known to be ours
+static logDirRegion_e logDirRegion;
+static uint32_t logDirBlankChecked;
+
+static bool logDirIsOwned(const logDir_t *dir)
+{
+    // Look at the first record of each bank, unless a blank check is under way
+    if (logDirRegion == LOGDIR_REGION_UNKNOWN && logDirBlankChecked == 0) {
+        bool foreign = false;
+
+        for (int bank = 0; bank < LOGDIR_BANK_COUNT; bank++) {
+            logDirRecord_t record;
+
+            switch (logDirReadRecord(dir, bank, 0, &record)) {
+            case LOGDIR_RECORD_VALID:
+                logDirRegion = LOGDIR_REGION_OWNED;
+                return true;
+            case LOGDIR_RECORD_INVALID:
+                foreign = true;
+                break;
+            default:
+                break;
+            }
+        }
+
+        if (foreign) {
+            logDirRegion = LOGDIR_REGION_FOREIGN;
+        }
+    }
+
+    return logDirRegion == LOGDIR_REGION_OWNED;
+}
+
+// Check a little more of the region for being blank. Takes over the region once all of it is.
+static void logDirCheckBlank(const logDir_t *dir)
+{
+    STATIC_DMA_DATA_AUTO uint8_t buffer[LOGDIR_BLANK_CHECK_SIZE];
+
+    const uint32_t size = LOGDIR_BANK_COUNT * dir->bankSize;
+    const uint32_t length = MIN(sizeof(buffer), size - logDirBlankChecked);
+
+    if (flashReadBytes(dir->address + logDirBlankChecked, buffer, length) < (int)length) {
+        return;
+    }
+
+    for (unsigned i = 0; i < length; i++) {
+        if (buffer[i] != 0xFF) {
+            logDirRegion = LOGDIR_REGION_FOREIGN;
+            return;
+        }
+    }
+
+    logDirBlankChecked += length;
+
+    if (logDirBlankChecked >= size) {
+        logDirRegion = LOGDIR_REGION_OWNED;
+    }
+}
+
+static bool logDirLocate(logDir_t *dir)
+{
+    const flashPartition_t *partition = flashPartitionFindByType(FLASH_PARTITION_TYPE_LOGDIR);
+    const flashGeometry_t *geometry = flashGetGeometry();
+
+    if (!partition || FLASH_PARTITION_SECTOR_COUNT(partition) < LOGDIR_BANK_COUNT || geometry->pageSize < sizeof(logDirRecord_t)) {
+        return false;
+    }
+
+    dir->address = partition->startSector * geometry->sectorSize;
+    dir->bankSize = geometry->sectorSize;
+    dir->pageSize = geometry->pageSize;
+    dir->slots = geometry->pagesPerSector;
+    dir->count = 0;
+    dir->sequence = 0;
+    dir->bank = 0;
+
+    return true;
+}
+
+static logDirStatus_e logDirLoad(logDir_t *dir)
+{
+    if (!logDirLocate(dir) || !logDirIsOwned(dir)) {
+        return LOGDIR_MISSING;
+    }
+
+    for (int bank = 0; bank < LOGDIR_BANK_COUNT; bank++) {
+        const int count = logDirBankCount(dir, bank);
+
+        if (count > 0) {
+            logDirRecord_t record;
+
+            if (logDirReadRecord(dir, bank, count - 1, &record) != LOGDIR_RECORD_VALID) {
+                return LOGDIR_CORRUPT;
+            }
+
+            // The newer bank wins, or the fuller one while a compaction is incomplete
+            const int16_t age = record.sequence - dir->sequence;
+
+            if (dir->count == 0 || age > 0 || (age == 0 && count > dir->count)) {
+                dir->bank = bank;
+                dir->count = count;
+                dir->sequence = record.sequence;
+            }
+        }
+    }
+
+    for (int slot = 0; slot < dir->count; slot++) {
+        logDirRecord_t record;
+
+        if (logDirReadRecord(dir, dir->bank, slot, &record) != LOGDIR_RECORD_VALID) {
+            return LOGDIR_CORRUPT;
+        }
+    }
+
+    return LOGDIR_OK;
+}
+
+
+/*
+ * Directory update
+ */
+
+static struct {
+    uint32_t address;
+    uint32_t startTime;
+    uint32_t fieldHash;
+    bool pending;
+} logDirCurrent;
+
+// Banks waiting for blackboxLogDirUpdate() to erase them
+static uint8_t logDirEraseBanks;
+
+static bool logDirHasHeader(uint32_t offset);
+
+static uint32_t logDirLocalTime(void)
+{
+#ifdef USE_RTC_TIME
+    rtcTime_t now;
+
+    if (rtcGet(&now)) {
+        return rtcTimeGetSeconds(&now) + timeConfig()->tz_offsetMinutes * 60;
+    }
+#endif
+
+    return 0;
+}
+
+static bool logDirCompact(logDir_t *dir)
+{
+    const uint32_t size = flashfsGetSize();
+    const int from = dir->bank;
+    const int to = from ^ 1;
+    const int keep = dir->slots / 2;
+    const int drop = dir->count - keep;
+
+    logDirRecord_t merged, record;
+
+    // The other bank must have been erased beforehand
+    if ((logDirEraseBanks & BIT(to)) || logDirBankCount(dir, to) > 0) {
+        logDirEraseBanks |= BIT(to);
+        return false;
+    }
+
+    if (logDirReadRecord(dir, from, 0, &merged) != LOGDIR_RECORD_VALID ||
+        logDirReadRecord(dir, from, drop, &record) != LOGDIR_RECORD_VALID) {
+        return false;
+    }
+
+    // The dropped logs stay listed, as one entry up to the oldest kept log
+    merged.length = (record.address + size - merged.address) % size;
+    merged.fieldHash = 0;
+    merged.flags |= LOGDIR_FLAG_MERGED;
+
+    if (!logDirWriteRecord(dir, to, 0, &merged)) {
+        logDirEraseBanks |= BIT(to);
+        return false;
+    }
+
+    // The copies keep their sequence numbers, so the old bank stays active until the next append
+    for (int slot = 0; slot < keep; slot++) {
+        if (logDirReadRecord(dir, from, drop + slot, &record) != LOGDIR_RECORD_VALID ||
+            !logDirWriteRecord(dir, to, slot + 1, &record)) {
+            logDirEraseBanks |= BIT(to);
+            return false;
+        }
+    }
+
+    dir->bank = to;
+    dir->count = keep + 1;
+
+    // Get the old bank ready for the next compaction
+    logDirEraseBanks |= BIT(from);
+
+    return true;
+}
+
+static bool logDirAppend(logDir_t *dir, logDirRecord_t *record)
+{
+    if (dir->count == dir->slots && !logDirCompact(dir)) {
+        return false;
+    }
+
+    record->sequence = dir->sequence + 1;
+
+    if (!logDirWriteRecord(dir, dir->bank, dir->count, record)) {
+        // Something other than records in the active bank, start over
+        logDirEraseBanks = BIT(0) | BIT(1);
+        return false;
+    }
+
+    dir->sequence = record->sequence;
+    dir->count++;
+
+    return true;
+}
+
+/*
+ * Remember where the log starts. Called before the log header is written.
+ */
+void blackboxLogDirBegin(uint32_t fieldHash)
+{
+    const uint32_t size = flashfsGetSize();
+    const uint32_t used = flashfsGetOffset();
+
+    // Nothing can be logged on a full flash
+    logDirCurrent.pending = (used < size);
+
+    if (logDirCurrent.pending) {
+        logDirCurrent.address = (flashfsGetHeadAddress() + used) % size;
+        logDirCurrent.startTime = logDirLocalTime();
+        logDirCurrent.fieldHash = fieldHash;
+    }
+}
+
+/*
+ * Forget the current log, e.g. when the flash is erased.
+ * The directory region is erased along with the flash, and taken
+ * over once the blank check finds it erased.
+ */
+void blackboxLogDirCancel(void)
+{
+    logDirCurrent.pending = false;
+    logDirEraseBanks = 0;
+    logDirRegion = LOGDIR_REGION_UNKNOWN;
+    logDirBlankChecked = 0;
+}
+
+/*
+ * Write the record for the current log. Called after FlashFS has been
+ * closed, so the log end is on a page boundary and nothing is buffered.
+ */
+void blackboxLogDirEnd(void)
+{
+    if (!logDirCurrent.pending) {
+        return;
+    }
+
+    logDirCurrent.pending = false;
+
+    // Programming has to wait for a suspended erase, leave this log to the scan
+    if (flashIsSuspended()) {
+        return;
+    }
+
+    flashWaitForReady();
+
+    const uint32_t size = flashfsGetSize();
+    const uint32_t head = flashfsGetHeadAddress();
+    const uint32_t used = flashfsGetOffset();
+
+    logDirRecord_t record = {
+        .address = logDirCurrent.address,
+        .length = (head + used + size - logDirCurrent.address) % size,
+        .startTime = logDirCurrent.startTime,
+        .fieldHash = logDirCurrent.fieldHash,
+    };
+
+    if (record.length == 0) {
+        return;
+    }
+
+    // In rolling erase, the log may have overwritten its own header
+    if (!logDirHasHeader((record.address + size - head) % size)) {
+        record.address = head;
+        record.length = used;
+        record.flags = LOGDIR_FLAG_PARTIAL;
+    }
+
+    logDir_t dir;
+
+    const logDirStatus_e status = logDirLoad(&dir);
+
+    if (status == LOGDIR_MISSING) {
+        return;
+    }
+
+    if (status == LOGDIR_CORRUPT) {
+        logDirEraseBanks = BIT(0) | BIT(1);
+    }
+
+    // Leave the log to the scan until the erase is done
+    if (logDirEraseBanks & BIT(dir.bank)) {
+        return;
+    }
+
+    logDirAppend(&dir, &record);
+}
+
+/*
+ * Background work on the directory while the blackbox is stopped: check
+ * that a region without records is blank before using it, and erase the
+ * banks waiting for it. Only runs when the flash is idle, never waits.
+ */
+void blackboxLogDirUpdate(void)
+{
+    logDir_t dir;
+
+    if ((logDirRegion != LOGDIR_REGION_UNKNOWN && !logDirEraseBanks) || !flashfsIsReady() || flashIsSuspended() || !flashIsReady()) {
+        return;
+    }
+
+    if (!logDirLocate(&dir)) {
+        logDirEraseBanks = 0;
+        return;
+    }
+
+    if (logDirRegion == LOGDIR_REGION_UNKNOWN) {
+        if (!logDirIsOwned(&dir) && logDirRegion == LOGDIR_REGION_UNKNOWN) {
+            logDirCheckBlank(&dir);
+        }
+        return;
+    }
+
+    const int bank = (logDirEraseBanks & BIT(0)) ? 0 : 1;
+
+    flashEraseSector(logDirSlotAddress(&dir, bank, 0));
+
+    logDirEraseBanks &= ~BIT(bank);
+}
+
+#endif // USE_BLACKBOX_LOGDIR
+
+
+/*
+ * Log header scan
+ */
+
+static bool logDirHasHeader(uint32_t offset)
+{
+    STATIC_DMA_DATA_AUTO uint8_t buffer[sizeof(logHeader) - 1];
+
+    flashfsReadAbs(offset, buffer, sizeof(buffer));
+
+    return memcmp(buffer, logHeader, sizeof(buffer)) == 0;
+}
+
+// Seconds since 1970 from a Gregorian calendar date
+static uint32_t logDirMakeTime(int year, int month, int day, int hour, int min, int sec)
+{
+    if (year < 1970 || month < 1 || month > 12 || day < 1 || day > 31) {
+        return 0;
+    }
+
+    const int y = year - (month <= 2);
+    const int era = y / 400;
+    const int yoe = y - era * 400;
+    const int doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    const uint32_t days = era * 146097 + doe - 719468;
+
+    return days * 86400 + hour * 3600 + min * 60 + sec;
+}
+
+/*
+ * Find the "Log start datetime" header of the log at offset,
+ * example encoding "H Log start datetime:2019-08-15T13:18:22.199+00:00"
+ */
+static uint32_t logDirScanStartTime(uint32_t offset, uint32_t end)
+{
+    STATIC_DMA_DATA_AUTO uint8_t buffer[LOGDIR_HEADER_BUF_SIZE];
+
+    const int lenTimeHeader = strlen(timeHeader);
+
+    int timeHeaderMatched = 0;
+    int buffOffset = LOGDIR_HEADER_BUF_SIZE;
+    uint32_t hdrOffset = offset - LOGDIR_HEADER_BUF_SIZE;
+
+    while (true) {
+        if (buffOffset == LOGDIR_HEADER_BUF_SIZE) {
+            // Read the next portion of the header
+            hdrOffset += LOGDIR_HEADER_BUF_SIZE;
+
+            if (hdrOffset >= end) {
+                return 0;
+            }
+
+            flashfsReadAbs(hdrOffset, buffer, LOGDIR_HEADER_BUF_SIZE);
+            buffOffset = 0;
+        }
+
+        if (buffer[buffOffset++] == timeHeader[timeHeaderMatched]) {
+            // This matches the header we're looking for so far
+            if (++timeHeaderMatched == lenTimeHeader) {
+                break;
+            }
+        } else {
+            timeHeaderMatched = 0;
+        }
+    }
+
+    // Complete match so read date/time into buffer
+    flashfsReadAbs(hdrOffset + buffOffset, buffer, LOGDIR_HEADER_BUF_SIZE - 1);
+    buffer[LOGDIR_HEADER_BUF_SIZE - 1] = 0;
+
+    char *nextToken = (char *)buffer;
+    const int year = strtoul(nextToken, &nextToken, 10);
+    const int month = strtoul(++nextToken, &nextToken, 10);
+    const int day = strtoul(++nextToken, &nextToken, 10);
+    const int hour = strtoul(++nextToken, &nextToken, 10);
+    const int min = strtoul(++nextToken, &nextToken, 10);
+    const int sec = strtoul(++nextToken, NULL, 10);
+
+    return logDirMakeTime(year, month, day, hour, min, sec);
+}
+
+static bool logDirVisit(logDirEnum_t *e, const blackboxLogEntry_t *entry)
+{
+    if (!e->stopped) {
+        e->count++;
+        e->stopped = !e->visitor(entry, e->context);
+    }
+
+    return !e->stopped;
+}
+
+/*
+ * Enumerate the logs in [start, end) by looking for the log header
+ * at the start of every page.
+ */
+static bool logDirScan(logDirEnum_t *e, uint32_t start, uint32_t end)
+{
+    const uint16_t pageSize = flashGetGeometry()->pageSize;
+
+    blackboxLogEntry_t entry = { 0 };
+    bool found = false;
+
+    for (uint32_t offset = start; offset < end; offset += pageSize) {
+        if (e->progress) {
+            e->progress();
+        }
+
+        if (!logDirHasHeader(offset)) {
+            continue;
+        }
+
+        // The length of the previous log is now known
+        if (found) {
+            entry.size = offset - entry.offset;
+            if (!logDirVisit(e, &entry)) {
+                return false;
+            }
+        }
+
+        entry.offset = offset;
+        entry.startTime = logDirScanStartTime(offset, end);
+        found = true;
+    }
+
+    if (found) {
+        entry.size = end - entry.offset;
+        return logDirVisit(e, &entry);
+    }
+
+    return !e->stopped;
+}
+
+
+/*
+ * Log enumeration
+ */
+
+#ifdef USE_BLACKBOX_LOGDIR
+
+/*
+ * Enumerate the logs from the directory, scanning only the gaps between
+ * the records. Returns false without visiting anything if the directory
+ * can't be used.
+ */
+static bool logDirEnumerateRecords(logDirEnum_t *e, uint32_t used)
+{
+    const uint32_t size = flashfsGetSize();
+    const uint32_t head = flashfsGetHeadAddress();
+
+    logDirRecord_t record;
+    logDir_t dir;
+
+    if (size == 0 || logDirLoad(&dir) != LOGDIR_OK) {
+        return false;
+    }
+
+    // Walk back from the newest record to the oldest one still on the flash
+    uint32_t limit = used;
+    bool covered = false;
+    int first = dir.count;
+
+    while (first > 0) {
+        if (logDirReadRecord(&dir, dir.bank, first - 1, &record) != LOGDIR_RECORD_VALID) {
+            return false;
+        }
+
+        const uint32_t offset = (record.address + size - head) % size;
+
+        if (offset + record.length > limit) {
+            // Rolled over; the rest of it may still fill the space up to the next log
+            covered = ((offset + record.length) % size == limit);
+            break;
+        }
+
+        if (!(record.flags & LOGDIR_FLAG_PARTIAL) && !logDirHasHeader(offset)) {
+            break;
+        }
+
+        limit = offset;
+        first--;
+    }
+
+    uint32_t position = covered ? limit : 0;
+
+    for (int slot = first; slot < dir.count; slot++) {
+        if (logDirReadRecord(&dir, dir.bank, slot, &record) != LOGDIR_RECORD_VALID) {
+            break;
+        }
+
+        const uint32_t offset = (record.address + size - head) % size;
+
+        if (offset > position && e->scan && !logDirScan(e, position, offset)) {
+            return true;
+        }
+
+        // Logs without a header can't be decoded
+        if (!(record.flags & LOGDIR_FLAG_PARTIAL)) {
+            const blackboxLogEntry_t entry = {
+                .offset = offset,
+                .size = record.length,
+                .startTime = record.startTime,
+                .fieldHash = record.fieldHash,
+            };
+
+            if (!logDirVisit(e, &entry)) {
+                return true;
+            }
+        }
+
+        position = offset + record.length;
+    }
+
+    if (position < used && e->scan) {
+        logDirScan(e, position, used);
+    }
+
+    return true;
+}
+
+#endif
+
+/*
+ * Enumerate the logs in the used flash space, oldest first.
+ * Returns the number of logs visited.
+ */
+int blackboxLogDirEnumerate(blackboxLogVisitor_t visitor, void (*progress)(void), void *context)
+{
+    logDirEnum_t e = {
+        .visitor = visitor,
+        .progress = progress,
+        .context = context,
+        .scan = true,
+    };
+
+    const uint32_t used = flashfsGetOffset();
+
+#ifdef USE_BLACKBOX_LOGDIR
+    if (!logDirEnumerateRecords(&e, used))
+#endif
+    {
+        logDirScan(&e, 0, used);
+    }
+
+    return e.count;
+}
+
+/*
+ * Enumerate only the logs with a directory record, oldest first. The
+ * gaps between the records are not scanned, so this is quick but misses
+ * any log that was not closed properly. Without a usable directory, the
+ * whole used space is scanned like blackboxLogDirEnumerate() does.
+ * Returns the number of logs visited.
+ */
+int blackboxLogDirEnumerateRecords(blackboxLogVisitor_t visitor, void *context)
+{
+    logDirEnum_t e = {
+        .visitor = visitor,
+        .context = context,
+        .scan = false,
+    };
+
+    const uint32_t used = flashfsGetOffset();
+
+#ifdef USE_BLACKBOX_LOGDIR
+    if (!logDirEnumerateRecords(&e, used))
+#endif
+    {
+        logDirScan(&e, 0, used);
+    }
+
+    return e.count;
+}
+
+#endif // USE_FLASHFS
@@ -0,0 +1,39 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    uint32_t offset;        // Start of the log, relative to the start of the used flash space
+    uint32_t size;          // Log size in bytes
+    uint32_t startTime;     // Local start time in seconds since 1970, 0 if unknown
+    uint32_t fieldHash;     // Hash of the main frame field set, 0 if unknown
+} blackboxLogEntry_t;
+
+// Called for each log in order, return false to stop the enumeration
+typedef bool (*blackboxLogVisitor_t)(const blackboxLogEntry_t *entry, void *context);
+
+void blackboxLogDirBegin(uint32_t fieldHash);
+void blackboxLogDirEnd(void);
+void blackboxLogDirCancel(void);
+void blackboxLogDirUpdate(void);
+
+int blackboxLogDirEnumerate(blackboxLogVisitor_t visitor, void (*progress)(void), void *context);
+int blackboxLogDirEnumerateRecords(blackboxLogVisitor_t visitor, void *context);
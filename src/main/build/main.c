@@ -42,7 +42,9 @@ FAST_CODE void run(void)
 {
     while (true) {
         scheduler();
-#ifdef SIMULATOR_BUILD
+#if defined(SIMULATOR_LOCKSTEP)
+        simulatorLockstepUpdate();
+#elif defined(SIMULATOR_BUILD)
         delayMicroseconds_real(50); // max rate 20kHz
 #endif
     }
@@ -35,6 +35,7 @@ bool cliMode = false;
 #ifdef USE_CLI
 
 #include "blackbox/blackbox.h"
+#include "blackbox/blackbox_logdir.h"
 
 #include "build/build_config.h"
 #include "build/debug.h"
@@ -2345,6 +2346,7 @@ static void cliMixer(const char *cmdName, char *cmdline)
     char *args[ARGS_MAX];
     char *saveptr, *ptr;
     int count = 0;
+    bool changed = false;
 
     ptr = strtok_r(cmdline, " ", &saveptr);
     while (ptr && count < ARGS_MAX) {
@@ -2360,6 +2362,7 @@ static void cliMixer(const char *cmdName, char *cmdline)
     else if (strcasecmp(args[FUNC], "reset") == 0) {
         PG_RESET(mixerInputs);
         PG_RESET(mixerRules);
+        changed = true;
     }
     else if (strcasecmp(args[FUNC], "status") == 0) {
         for (unsigned i=1; i<MIXER_OUTPUT_COUNT; i++) {
@@ -2387,6 +2390,7 @@ static void cliMixer(const char *cmdName, char *cmdline)
                 mixerInput_t *input = mixerInputsMutable(vals[INPUT]);
                 input->min = vals[MIN];
                 input->max = vals[MAX];
+                changed = true;
             } else {
                 cliShowArgumentRangeError(cmdName, NULL, 0, 0);
             }
@@ -2412,6 +2416,7 @@ static void cliMixer(const char *cmdName, char *cmdline)
             {
                 mixerInput_t *input = mixerInputsMutable(vals[INPUT]);
                 input->rate = vals[RATE];
+                changed = true;
             } else {
                 cliShowArgumentRangeError(cmdName, NULL, 0, 0);
             }
@@ -2426,6 +2431,7 @@ static void cliMixer(const char *cmdName, char *cmdline)
         else if (count == 2) {
             if (strcasecmp(args[ARG1], "reset") == 0) {
                 PG_RESET(mixerInputs);
+                changed = true;
             }
         }
         else if (count == 5) {
@@ -2447,6 +2453,7 @@ static void cliMixer(const char *cmdName, char *cmdline)
                 input->min = vals[MIN];
                 input->max = vals[MAX];
                 input->rate = vals[RATE];
+                changed = true;
             } else {
                 cliShowArgumentRangeError(cmdName, NULL, 0, 0);
             }
@@ -2461,6 +2468,7 @@ static void cliMixer(const char *cmdName, char *cmdline)
         else if (count == 2) {
             if (strcasecmp(args[ARG1], "reset") == 0) {
                 PG_RESET(mixerRules);
+                changed = true;
             }
         }
         else if (count == 3) {
@@ -2469,6 +2477,7 @@ static void cliMixer(const char *cmdName, char *cmdline)
                 int index = atoi(args[RULE]);
                 if (index >= 0 && index < MIXER_RULE_COUNT) {
                     memset(mixerRulesMutable(index), 0, sizeof(mixerRule_t));
+                    changed = true;
                 } else {
                     cliShowArgumentRangeError(cmdName, NULL, 0, 0);
                 }
@@ -2504,6 +2513,7 @@ static void cliMixer(const char *cmdName, char *cmdline)
                 mix->output = vals[OUTPUT];
                 mix->weight = vals[WEIGHT];
                 mix->offset = vals[OFFSET];
+                changed = true;
             } else {
                 cliShowArgumentRangeError(cmdName, NULL, 0, 0);
             }
@@ -2570,6 +2580,11 @@ static void cliMixer(const char *cmdName, char *cmdline)
     else {
         cliShowParseError(cmdName);
     }
+
+    // Apply any input or rule changes to the running mixer
+    if (changed) {
+        mixerInitConfig();
+    }
 }
 
 
@@ -2709,6 +2724,9 @@ static void cliFlashErase(const char *cmdName, char *cmdline)
 
     cliWriterFlush();
     flashfsEraseCompletely();
+#ifdef USE_BLACKBOX_LOGDIR
+    blackboxLogDirCancel();
+#endif
 
     while (!flashfsIsReady()) {
         flashfsEraseAsync();
@@ -4803,7 +4821,7 @@ static void cliStatus(const char *cmdName, char *cmdline)
 #endif
     cliPrintLinefeed();
 
-    cliPrintLinef("Configuration: %s, size: %d, max available: %d", configurationStates[systemConfigMutable()->configurationState], getEEPROMConfigSize(), getEEPROMStorageSize());
+    cliPrintLinef("Configuration: %s, size: %d, max available: %d, load time: %dus", configurationStates[systemConfigMutable()->configurationState], getEEPROMConfigSize(), getEEPROMStorageSize(), getEEPROMLoadTime());
 
     // Devices
 #if defined(USE_SPI) || defined(USE_I2C)
@@ -4982,6 +5000,13 @@ static void cliTasks(const char *cmdName, char *cmdline)
         getCheckFuncInfo(&checkFuncInfo);
         cliPrintLinef("RX Check Function %19d %7d %25d", checkFuncInfo.maxExecutionTimeUs, checkFuncInfo.averageExecutionTimeUs, checkFuncInfo.totalExecutionTimeUs / 1000);
         cliPrintLinef("Total (excluding SERIAL) %33d.%1d%%", averageLoadSum/10, averageLoadSum%10);
+        for (int index = 0; index < getPidSubTaskCount(); index++) {
+            pidSubTaskInfo_t subTaskInfo;
+            getPidSubTaskInfo(index, &subTaskInfo);
+            cliPrintLinef("PID sub-task %-12s slot %2d/%-2d %7d.%1d",
+                    subTaskInfo.subTaskName, subTaskInfo.slot, subTaskInfo.slotCount,
+                    subTaskInfo.averageExecutionTime10thUs / 10, subTaskInfo.averageExecutionTime10thUs % 10);
+        }
         if (debugMode == DEBUG_SCHEDULER_DETERMINISM) {
             extern int32_t schedLoopStartCycles, taskGuardCycles;
 
@@ -6785,10 +6810,28 @@ void cliProcess(void)
     // Flush the buffer to get rid of any MSP data polls sent by configurator after CLI was invoked
     cliWriterFlush();
 
-    while (serialRxBytesWaiting(cliPort)) {
-        uint8_t c = serialRead(cliPort);
+    const uint8_t *data;
+    uint32_t count;
+
+    while ((count = serialPeekRx(cliPort, &data)) > 0) {
+        uint32_t used = 0;
+        uint8_t c = 0;
 
-        processCharacterInteractive(c);
+        // Plain characters only edit the line. A control character may run a
+        // command that takes over the port, so release the input before it.
+        while (used < count) {
+            c = data[used++];
+            if (c < ' ') {
+                break;
+            }
+            processCharacterInteractive(c);
+        }
+
+        serialConsumeRx(cliPort, used);
+
+        if (c < ' ') {
+            processCharacterInteractive(c);
+        }
     }
 }
 
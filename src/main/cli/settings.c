@@ -295,6 +295,12 @@ static const char * const lookupTableLowpassType[] = {
     "ORDER1", "BUTTER", "BESSEL", "DAMPED",
 };
 
+#ifdef USE_DYN_NOTCH_FILTER
+static const char * const lookupTableDynNotchEngine[] = {
+    "SDFT", "FFT",
+};
+#endif
+
 static const char * const lookupTableFailsafe[] = {
     "AUTO-LAND", "DROP", "GPS-RESCUE"
 };
@@ -543,6 +549,9 @@ const lookupTableEntry_t lookupTables[] = {
     LOOKUP_TABLE_ENTRY(debugModeNames),
     LOOKUP_TABLE_ENTRY(lookupTablePwmProtocol),
     LOOKUP_TABLE_ENTRY(lookupTableLowpassType),
+#ifdef USE_DYN_NOTCH_FILTER
+    LOOKUP_TABLE_ENTRY(lookupTableDynNotchEngine),
+#endif
     LOOKUP_TABLE_ENTRY(lookupTableFailsafe),
     LOOKUP_TABLE_ENTRY(lookupTableFailsafeSwitchMode),
 #ifdef USE_CAMERA_CONTROL
@@ -662,6 +671,7 @@ const clivalue_t valueTable[] = {
     { PARAM_NAME_DYN_NOTCH_Q,           VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 10, 100 }, PG_DYN_NOTCH_CONFIG, offsetof(dynNotchConfig_t, dyn_notch_q) },
     { PARAM_NAME_DYN_NOTCH_MIN_HZ,      VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 10, 200 }, PG_DYN_NOTCH_CONFIG, offsetof(dynNotchConfig_t, dyn_notch_min_hz) },
     { PARAM_NAME_DYN_NOTCH_MAX_HZ,      VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 100, 500 }, PG_DYN_NOTCH_CONFIG, offsetof(dynNotchConfig_t, dyn_notch_max_hz) },
+    { PARAM_NAME_DYN_NOTCH_ENGINE,      VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_DYN_NOTCH_ENGINE }, PG_DYN_NOTCH_CONFIG, offsetof(dynNotchConfig_t, dyn_notch_engine) },
 #endif
 
 // PG_ACCELEROMETER_CONFIG
@@ -803,6 +813,7 @@ const clivalue_t valueTable[] = {
     { "blackbox_rolling_erase",     VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_BLACKBOX_CONFIG, offsetof(blackboxConfig_t, rollingErase) },
 #endif
     { "blackbox_grace_period",      VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 60 }, PG_BLACKBOX_CONFIG, offsetof(blackboxConfig_t, gracePeriod) },
+    { "blackbox_adaptive_rate",     VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_BLACKBOX_CONFIG, offsetof(blackboxConfig_t, adaptiveRate) },
 #endif
 
 // PG_MOTOR_CONFIG
@@ -989,6 +1000,7 @@ const clivalue_t valueTable[] = {
 // PG_SERIAL_CONFIG
     { "reboot_character",           VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 48, 126 }, PG_SERIAL_CONFIG, offsetof(serialConfig_t, reboot_character) },
     { "serial_update_rate_hz",      VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 100, 2000 }, PG_SERIAL_CONFIG, offsetof(serialConfig_t, serial_update_rate_hz) },
+    { "msp_budget_us",              VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 2000 }, PG_SERIAL_CONFIG, offsetof(serialConfig_t, msp_budget_us) },
 
 // PG_IMU_CONFIG
     { "imu_dcm_kp",                 VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 32000 }, PG_IMU_CONFIG, offsetof(imuConfig_t, dcm_kp) },
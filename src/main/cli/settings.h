@@ -61,6 +61,9 @@ typedef enum {
     TABLE_DEBUG,
     TABLE_MOTOR_PWM_PROTOCOL,
     TABLE_LPF_TYPE,
+#ifdef USE_DYN_NOTCH_FILTER
+    TABLE_DYN_NOTCH_ENGINE,
+#endif
     TABLE_FAILSAFE,
     TABLE_FAILSAFE_SWITCH_MODE,
 #ifdef USE_CAMERA_CONTROL
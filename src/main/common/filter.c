@@ -574,6 +574,45 @@ FAST_CODE void biquadFilterUpdate(biquadFilter_t *filter, float cutoff, float sa
 }
 
 
+// Fast notch coefficients.
+//
+// The notch only needs sin(ω) and cos(ω), with ω limited to [0,0.95π]
+// by limitCutoff(). These are derived from the half angle θ = ω/2, which
+// is always within [0,π/2], so the sine polynomial can be evaluated
+// directly without any range reduction. The normalisation is done with
+// a single division. The coefficients are within 1e-5 of the exact values.
+
+#define notchPolyCoef3 -1.666568107e-1f
+#define notchPolyCoef5  8.312366210e-3f
+#define notchPolyCoef7 -1.849218155e-4f
+
+static inline float notchSinPoly(float x)
+{
+    const float x2 = x * x;
+
+    return x + x * x2 * (notchPolyCoef3 + x2 * (notchPolyCoef5 + x2 * notchPolyCoef7));
+}
+
+FAST_CODE void biquadNotchUpdate(biquadFilter_t *filter, float cutoff, float sampleRate, float Q)
+{
+    cutoff = limitCutoff(cutoff, sampleRate);
+
+    const float theta = M_PIf * cutoff / sampleRate;
+    const float sinth = notchSinPoly(theta);
+    const float costh = notchSinPoly(M_PI2f - theta);
+
+    // cos(ω) = 1 - 2·sin²(θ) ; α = sin(ω) / 2Q = sin(θ)·cos(θ) / Q
+    const float cosom = 1 - 2 * sinth * sinth;
+    const float gain = Q / (Q + sinth * costh);
+
+    filter->b0 = gain;
+    filter->b1 = -2 * cosom * gain;
+    filter->b2 = gain;
+    filter->a1 = filter->b1;
+    filter->a2 = 2 * gain - 1;
+}
+
+
 FAST_CODE float biquadFilterApplyDF1(biquadFilter_t *filter, float input)
 {
     const float output =
@@ -826,7 +865,7 @@ void notchFilterInit(filter_t *filter, float cutoff, float Q, float sampleRate,
 void notchFilterUpdate(filter_t *filter, float cutoff, float Q, float sampleRate)
 {
     if (cutoff > 0 && Q > 0)
-        biquadFilterUpdate(&filter->data.sos, cutoff, sampleRate, Q, BIQUAD_NOTCH);
+        biquadNotchUpdate(&filter->data.sos, cutoff, sampleRate, Q);
 }
 
 // Get notch filter Q given center frequency (f0) and lower cutoff frequency (f1)
@@ -263,6 +263,7 @@ void biquadDampedUpdate(biquadFilter_t *filter, float cutoff, float sampleRate);
 
 void biquadFilterInit(biquadFilter_t *filter, float cutoff, float sampleRate, float Q, uint8_t filterType);
 void biquadFilterUpdate(biquadFilter_t *filter, float cutoff, float sampleRate, float Q, uint8_t filterType);
+void biquadNotchUpdate(biquadFilter_t *filter, float cutoff, float sampleRate, float Q);
 
 float biquadFilterApply(biquadFilter_t *filter, float input);
 float biquadFilterApplyDF1(biquadFilter_t *filter, float input);
@@ -0,0 +1,218 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+#include "common/rfft.h"
+#include "common/utils.h"
+
+// The N real samples are packed into N/2 complex points, transformed with
+// a radix-2 complex FFT and then split into the N/2 real spectrum bins.
+
+#define RFFT_POINTS     RFFT_BIN_COUNT
+
+#if RFFT_POINTS == 64
+#define RFFT_LOG2       6
+#elif RFFT_POINTS == 128
+#define RFFT_LOG2       7
+#else
+#define RFFT_LOG2       8
+#endif
+
+enum {
+    RFFT_STEP_LOAD,
+    RFFT_STEP_BUTTERFLY,
+    RFFT_STEP_OUTPUT,
+};
+
+// cos/sin(2πk/N) for k = 0..N/2-1
+static FAST_DATA_ZERO_INIT float   twiddleCos[RFFT_POINTS];
+static FAST_DATA_ZERO_INIT float   twiddleSin[RFFT_POINTS];
+
+// Bit reversed point index
+static FAST_DATA_ZERO_INIT uint8_t bitReverse[RFFT_POINTS];
+
+
+INIT_CODE void rfftInit(rfft_t *fft, const int startBin, const int endBin)
+{
+    if (!twiddleCos[0]) {
+        const float c = M_2PIf / RFFT_SAMPLE_SIZE;
+        for (int i = 0; i < RFFT_POINTS; i++) {
+            twiddleCos[i] = cos_approx(c * i);
+            twiddleSin[i] = sin_approx(c * i);
+
+            int rev = 0;
+            for (int bit = 0; bit < RFFT_LOG2; bit++) {
+                if (i & BIT(bit))
+                    rev |= BIT(RFFT_LOG2 - 1 - bit);
+            }
+            bitReverse[i] = rev;
+        }
+    }
+
+    fft->idx = 0;
+    fft->origin = 0;
+
+    fft->startBin = constrain(startBin, 0, RFFT_BIN_COUNT - 1);
+    fft->endBin = constrain(endBin, fft->startBin, RFFT_BIN_COUNT - 1);
+
+    fft->step = RFFT_STEP_LOAD;
+    fft->stage = 0;
+    fft->count = 0;
+
+    for (int i = 0; i < RFFT_SAMPLE_SIZE; i++) {
+        fft->samples[i] = 0.0f;
+    }
+}
+
+
+// Add new sample to the circular buffer
+FAST_CODE void rfftPush(rfft_t *fft, const float sample)
+{
+    fft->samples[fft->idx] = sample;
+    fft->idx = (fft->idx + 1) & (RFFT_SAMPLE_SIZE - 1);
+}
+
+
+// Hann window. For n ≥ N/2, cos(2πn/N) = -cos(2π(n-N/2)/N)
+static inline float hannWindow(int n)
+{
+    return (n < RFFT_POINTS) ?
+        0.5f - 0.5f * twiddleCos[n] :
+        0.5f + 0.5f * twiddleCos[n - RFFT_POINTS];
+}
+
+// Window the samples and pack them into bit reversed complex points
+static FAST_CODE bool rfftLoad(rfft_t *fft, float *work)
+{
+    const int end = MIN(fft->count + RFFT_BATCH_SIZE, RFFT_POINTS);
+
+    for (int i = fft->count; i < end; i++) {
+        const int n = 2 * i;
+        const int k = 2 * bitReverse[i];
+        work[k + 0] = fft->samples[(fft->origin + n + 0) & (RFFT_SAMPLE_SIZE - 1)] * hannWindow(n + 0);
+        work[k + 1] = fft->samples[(fft->origin + n + 1) & (RFFT_SAMPLE_SIZE - 1)] * hannWindow(n + 1);
+    }
+
+    fft->count = end;
+
+    return (end == RFFT_POINTS);
+}
+
+// Radix-2 decimation in time butterflies of the current stage
+static FAST_CODE bool rfftButterfly(rfft_t *fft, float *work)
+{
+    const int stage = fft->stage;
+    const int half = BIT(stage);
+    const int end = MIN(fft->count + RFFT_BATCH_SIZE, RFFT_POINTS / 2);
+
+    for (int b = fft->count; b < end; b++) {
+        const int j = b & (half - 1);
+        const int i0 = 2 * (((b >> stage) << (stage + 1)) + j);
+        const int i1 = i0 + 2 * half;
+        const int t = j << (RFFT_LOG2 - stage);
+
+        const float c = twiddleCos[t];
+        const float s = twiddleSin[t];
+
+        const float tr = c * work[i1] + s * work[i1 + 1];
+        const float ti = c * work[i1 + 1] - s * work[i1];
+
+        work[i1 + 0] = work[i0 + 0] - tr;
+        work[i1 + 1] = work[i0 + 1] - ti;
+        work[i0 + 0] += tr;
+        work[i0 + 1] += ti;
+    }
+
+    fft->count = end;
+
+    if (end == RFFT_POINTS / 2) {
+        fft->count = 0;
+        fft->stage++;
+    }
+
+    return (fft->stage == RFFT_LOG2);
+}
+
+// Split the complex spectrum into the real spectrum, squared magnitude
+static FAST_CODE bool rfftOutput(rfft_t *fft, const float *work, float *output)
+{
+    const int end = MIN(fft->count + RFFT_BATCH_SIZE, fft->endBin + 1);
+
+    for (int k = fft->count; k < end; k++) {
+        const int m = 2 * ((RFFT_POINTS - k) & (RFFT_POINTS - 1));
+
+        const float er = 0.5f * (work[2 * k + 0] + work[m + 0]);
+        const float ei = 0.5f * (work[2 * k + 1] - work[m + 1]);
+        const float dr = 0.5f * (work[2 * k + 0] - work[m + 0]);
+        const float di = 0.5f * (work[2 * k + 1] + work[m + 1]);
+
+        const float c = twiddleCos[k];
+        const float s = twiddleSin[k];
+
+        const float re = er + c * di - s * dr;
+        const float im = ei - c * dr - s * di;
+
+        output[k] = re * re + im * im;
+    }
+
+    fft->count = end;
+
+    return (end > fft->endBin);
+}
+
+
+// Run one batch of the transform. Returns true when the windowed squared
+// magnitude spectrum (startBin..endBin) has been written to output.
+// The work buffer holds RFFT_SAMPLE_SIZE floats and must not be modified
+// until the transform is complete.
+FAST_CODE bool rfftProcess(rfft_t *fft, float *work, float *output)
+{
+    switch (fft->step) {
+        case RFFT_STEP_LOAD:
+            if (fft->count == 0) {
+                fft->origin = fft->idx;
+            }
+            if (rfftLoad(fft, work)) {
+                fft->step = RFFT_STEP_BUTTERFLY;
+                fft->stage = 0;
+                fft->count = 0;
+            }
+            break;
+
+        case RFFT_STEP_BUTTERFLY:
+            if (rfftButterfly(fft, work)) {
+                fft->step = RFFT_STEP_OUTPUT;
+                fft->count = fft->startBin;
+            }
+            break;
+
+        case RFFT_STEP_OUTPUT:
+            if (rfftOutput(fft, work, output)) {
+                fft->step = RFFT_STEP_LOAD;
+                fft->count = 0;
+                return true;
+            }
+            break;
+    }
+
+    return false;
+}
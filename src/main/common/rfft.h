@@ -0,0 +1,62 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Batched real FFT with Hann window.
+//
+// The samples are collected into a circular buffer. The transform is
+// calculated in place in a caller provided work buffer, a limited amount
+// of work at a time, so that the cost per call is independent of the
+// number of bins.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef RFFT_BIN_COUNT
+#define RFFT_BIN_COUNT      64
+#endif
+
+#if (RFFT_BIN_COUNT != 64) && (RFFT_BIN_COUNT != 128) && (RFFT_BIN_COUNT != 256)
+#error "RFFT_BIN_COUNT must be 64, 128 or 256"
+#endif
+
+#define RFFT_SAMPLE_SIZE    (RFFT_BIN_COUNT * 2)
+
+// Butterflies or samples processed per rfftProcess() call
+#ifndef RFFT_BATCH_SIZE
+#define RFFT_BATCH_SIZE     32
+#endif
+
+typedef struct rfft_s {
+
+    int idx;                            // circular buffer index
+    int startBin;
+    int endBin;
+
+    int step;                           // transform state
+    int stage;
+    int count;
+    int origin;                         // oldest sample in the transform
+
+    float samples[RFFT_SAMPLE_SIZE];    // circular buffer
+
+} rfft_t;
+
+void rfftInit(rfft_t *fft, const int startBin, const int endBin);
+void rfftPush(rfft_t *fft, const float sample);
+bool rfftProcess(rfft_t *fft, float *work, float *output);
@@ -40,8 +40,10 @@
 
 #include "drivers/flash.h"
 #include "drivers/system.h"
+#include "drivers/time.h"
 
 static uint16_t eepromConfigSize;
+static timeDelta_t eepromLoadTime;
 
 typedef enum {
     CR_CLASSICATION_SYSTEM   = 0,
@@ -77,6 +79,25 @@ typedef struct {
 } PG_PACKED configFooter_t;
 // checksum is appended just after footer. It is not included in footer to make checksum calculation consistent
 
+/*
+ * Record offsets of the validated config, hashed by pgn with linear probing.
+ * Built by isEEPROMStructureValid() in the same pass as the CRC check, so
+ * loadEEPROM() doesn't have to scan the config again for each PG.
+ * Must be a power of two. An empty slot is 0, which is always the header.
+ */
+#ifndef CONFIG_RECORD_INDEX_SIZE
+#define CONFIG_RECORD_INDEX_SIZE    256
+#endif
+
+#define CONFIG_RECORD_INDEX_MASK    (CONFIG_RECORD_INDEX_SIZE - 1)
+#define CONFIG_RECORD_INDEX_LIMIT   (CONFIG_RECORD_INDEX_SIZE * 3 / 4)
+
+STATIC_ASSERT((CONFIG_RECORD_INDEX_SIZE & CONFIG_RECORD_INDEX_MASK) == 0, config_record_index_size_not_power_of_two);
+
+static uint16_t configRecordIndex[CONFIG_RECORD_INDEX_SIZE];
+static uint16_t configRecordIndexCount;
+static bool configRecordIndexValid;
+
 // Used to check the compiler packing at build time.
 typedef struct {
     uint8_t byte;
@@ -269,63 +290,303 @@ void initEEPROM(void)
 #endif
 }
 
-bool isEEPROMVersionValid(void)
+/*
+ * Config log
+ *
+ * A bank starts with a snapshot of all the PGs (header, records, footer and CRC).
+ * Saves that change only a few PGs append a segment with the changed PGs after it
+ * (segment header, records, footer and CRC), so the flash isn't erased and rewritten
+ * for every save. Records in a segment replace the earlier ones. Each block starts
+ * on a streamer word boundary, and the sequence number goes up by one per segment,
+ * which rejects leftovers of older logs. A snapshot is always followed by an empty
+ * segment, whose sequence number tells the age of the bank.
+ *
+ * When the log is full, the config is compacted into a new snapshot. If the config
+ * storage splits into two banks on erase page boundaries, the snapshot is written to
+ * the other bank, so the old config stays intact until the new one is complete.
+ */
+#define CONFIG_SEGMENT_MAGIC    0x5A
+
+// Version written by firmware without segments. Such an image is loaded
+// as a snapshot alone, and the next save replaces it with a new snapshot.
+#define EEPROM_CONF_VERSION_LEGACY  174
+
+// Header for each appended segment.
+typedef struct {
+    uint8_t magic;              // magic number, should be 0x5A
+    uint8_t reserved;
+    uint16_t sequence;
+} PG_PACKED configSegmentHeader_t;
+
+typedef struct {
+    const uint8_t *start;       // snapshot header
+    const uint8_t *end;         // end of the space available for segments
+    const uint8_t *logEnd;      // end of the last valid block
+    uint16_t generation;        // sequence number of the first segment
+    uint16_t sequence;          // sequence number of the last segment
+    uint16_t segments;
+    bool legacy;                // snapshot written by older firmware, no segments
+} configBank_t;
+
+// Bank of the validated config
+static configBank_t configBank;
+
+static void configRecordIndexReset(void)
+{
+    memset(configRecordIndex, 0, sizeof(configRecordIndex));
+    configRecordIndexCount = 0;
+    configRecordIndexValid = false;
+}
+
+static bool configRecordMatches(const configRecord_t *record, pgn_t pgn, configRecordFlags_e classification)
+{
+    return record->pgn == pgn && (record->flags & CR_CLASSIFICATION_MASK) == classification;
+}
+
+// Add the record at offset to the index. Returns false if the index is full.
+// A duplicate record replaces the indexed one if replace is set, otherwise the first one is kept.
+static bool configRecordIndexAdd(uint32_t offset, bool replace)
 {
-    const uint8_t *p = &__config_start;
-    const configHeader_t *header = (const configHeader_t *)p;
+    const uint8_t *base = &__config_start;
+    const configRecord_t *record = (const configRecord_t *)(base + offset);
 
-    if (header->eepromConfigVersion != EEPROM_CONF_VERSION) {
+    if (offset > UINT16_MAX || configRecordIndexCount >= CONFIG_RECORD_INDEX_LIMIT) {
         return false;
     }
 
-    return true;
+    for (unsigned slot = record->pgn & CONFIG_RECORD_INDEX_MASK; ; slot = (slot + 1) & CONFIG_RECORD_INDEX_MASK) {
+        if (configRecordIndex[slot] == 0) {
+            configRecordIndex[slot] = offset;
+            configRecordIndexCount++;
+            return true;
+        }
+        if (configRecordMatches((const configRecord_t *)(base + configRecordIndex[slot]), record->pgn, record->flags & CR_CLASSIFICATION_MASK)) {
+            if (replace) {
+                configRecordIndex[slot] = offset;
+            }
+            return true;
+        }
+    }
 }
 
-// Scan the EEPROM config. Returns true if the config is valid.
-bool isEEPROMStructureValid(void)
+static const configRecord_t *configRecordIndexFind(pgn_t pgn, configRecordFlags_e classification)
 {
-    const uint8_t *p = &__config_start;
-    const configHeader_t *header = (const configHeader_t *)p;
+    const uint8_t *base = &__config_start;
 
-    if (header->magic_be != 0xBE) {
-        return false;
+    for (unsigned slot = pgn & CONFIG_RECORD_INDEX_MASK; configRecordIndex[slot]; slot = (slot + 1) & CONFIG_RECORD_INDEX_MASK) {
+        const configRecord_t *record = (const configRecord_t *)(base + configRecordIndex[slot]);
+        if (configRecordMatches(record, pgn, classification)) {
+            return record;
+        }
     }
 
+    return NULL;
+}
+
+// Blocks start on a streamer word boundary from the start of the config
+static const uint8_t *configBlockAlign(const uint8_t *p)
+{
+    const uintptr_t offset = p - &__config_start;
+
+    return &__config_start + ((offset + CONFIG_STREAMER_BUFFER_SIZE - 1) & ~(uintptr_t)(CONFIG_STREAMER_BUFFER_SIZE - 1));
+}
+
+// Start of the block following the footer at p
+static const uint8_t *configBlockNext(const uint8_t *p)
+{
+    return configBlockAlign(p + sizeof(configFooter_t) + sizeof(uint16_t));
+}
+
+// Check the records and CRC of the block at start, with the records starting at p.
+// Returns the start of the next block, or NULL if the block is not valid.
+static const uint8_t *configBlockCheck(const uint8_t *start, const uint8_t *p, const uint8_t *end)
+{
     uint16_t crc = CRC_START_VALUE;
-    crc = crc16_ccitt_update(crc, header, sizeof(*header));
-    p += sizeof(*header);
+    crc = crc16_ccitt_update(crc, start, p - start);
 
     for (;;) {
         const configRecord_t *record = (const configRecord_t *)p;
 
+        if (p + sizeof(configFooter_t) + sizeof(uint16_t) > end) {
+            // No room for the footer
+            return NULL;
+        }
         if (record->size == 0) {
             // Found the end.  Stop scanning.
             break;
         }
-        if (p + record->size >= &__config_end
+        if (p + record->size >= end
             || record->size < sizeof(*record)) {
             // Too big or too small.
-            return false;
+            return NULL;
         }
 
         crc = crc16_ccitt_update(crc, p, record->size);
+        p += record->size;
+    }
+
+    // include footer and stored CRC in the CRC calculation
+    crc = crc16_ccitt_update(crc, p, sizeof(configFooter_t) + sizeof(uint16_t));
+
+    // CRC has the property that if the CRC itself is included in the calculation the resulting CRC will have constant value
+    if (crc != CRC_CHECK_VALUE) {
+        return NULL;
+    }
+
+    return configBlockNext(p);
+}
+
+// Older firmware always wrote the config from the start
+static bool isLegacyHeader(const configHeader_t *header)
+{
+    return (const uint8_t *)header == &__config_start && header->eepromConfigVersion == EEPROM_CONF_VERSION_LEGACY;
+}
+
+// Validate the snapshot at start and the segments appended to it
+static bool configBankScan(configBank_t *bank, const uint8_t *start, const uint8_t *end)
+{
+    const configHeader_t *header = (const configHeader_t *)start;
+    const bool legacy = isLegacyHeader(header);
+
+    if (header->magic_be != 0xBE || (header->eepromConfigVersion != EEPROM_CONF_VERSION && !legacy)) {
+        return false;
+    }
+
+    const uint8_t *p = configBlockCheck(start, start + sizeof(*header), end);
+    if (!p) {
+        return false;
+    }
+
+    memset(bank, 0, sizeof(*bank));
+    bank->start = start;
+    bank->end = end;
+    bank->legacy = legacy;
+
+    // Whatever follows the snapshot of an older image is not a segment
+    while (!legacy) {
+        const configSegmentHeader_t *segment = (const configSegmentHeader_t *)p;
+
+        if (p + sizeof(*segment) > end
+            || segment->magic != CONFIG_SEGMENT_MAGIC
+            || (bank->segments && segment->sequence != (uint16_t)(bank->sequence + 1))) {
+            break;
+        }
+
+        // A partly written segment is ignored, and overwritten by the next save
+        const uint8_t *next = configBlockCheck(p, p + sizeof(*segment), end);
+        if (!next) {
+            break;
+        }
+
+        if (!bank->segments) {
+            bank->generation = segment->sequence;
+        }
+        bank->sequence = segment->sequence;
+        bank->segments++;
+        p = next;
+    }
+
+    bank->logEnd = p;
+
+    return true;
+}
+
+// Start of the second bank, or NULL if the config storage doesn't split into two banks
+static const uint8_t *configSecondBank(void)
+{
+#if defined(CONFIG_IN_EXTERNAL_FLASH) || (defined(CONFIG_IN_FLASH) && (defined(STM32F4) || defined(STM32F7)))
+    // External flash is programmed a page at a time from the start,
+    // and the F4/F7 erase always hits the first config sector
+    return NULL;
+#else
+    const uintptr_t pageSize = config_streamer_page_size();
+    const uint8_t *half = &__config_start + (&__config_end - &__config_start) / 2;
+
+    if ((uintptr_t)&__config_start % pageSize || (uintptr_t)half % pageSize || half == &__config_start) {
+        return NULL;
+    }
+
+    return half;
+#endif
+}
+
+// Index the records of the bank, in the order they replace each other
+static bool configBankIndex(const configBank_t *bank)
+{
+    const uint8_t *p = bank->start + sizeof(configHeader_t);
+    bool replace = false;
+
+    while (p < bank->logEnd) {
+        const configRecord_t *record = (const configRecord_t *)p;
+
+        if (record->size == 0) {
+            // Records in the segments replace the ones in the snapshot and the earlier segments
+            p = configBlockNext(p) + sizeof(configSegmentHeader_t);
+            replace = true;
+            continue;
+        }
+
+        if (!configRecordIndexAdd(p - &__config_start, replace)) {
+            return false;
+        }
 
         p += record->size;
     }
 
-    const configFooter_t *footer = (const configFooter_t *)p;
-    crc = crc16_ccitt_update(crc, footer, sizeof(*footer));
-    p += sizeof(*footer);
+    return true;
+}
 
-    // include stored CRC in the CRC calculation
-    const uint16_t *storedCrc = (const uint16_t *)p;
-    crc = crc16_ccitt_update(crc, storedCrc, sizeof(*storedCrc));
-    p += sizeof(storedCrc);
+bool isEEPROMVersionValid(void)
+{
+    const configHeader_t *header = (const configHeader_t *)&__config_start;
 
-    eepromConfigSize = p - &__config_start;
+    if (header->eepromConfigVersion == EEPROM_CONF_VERSION || isLegacyHeader(header)) {
+        return true;
+    }
 
-    // CRC has the property that if the CRC itself is included in the calculation the resulting CRC will have constant value
-    return crc == CRC_CHECK_VALUE;
+    // The first bank may be in the middle of a compaction
+    const uint8_t *second = configSecondBank();
+    if (second) {
+        header = (const configHeader_t *)second;
+        return header->eepromConfigVersion == EEPROM_CONF_VERSION;
+    }
+
+    return false;
+}
+
+// Scan the EEPROM config, pick the newest valid bank and index its records. Returns true if the config is valid.
+bool isEEPROMStructureValid(void)
+{
+    const uint8_t *second = configSecondBank();
+    configBank_t bank, other;
+
+    configRecordIndexReset();
+    memset(&configBank, 0, sizeof(configBank));
+
+    bool valid = configBankScan(&bank, &__config_start, &__config_end);
+
+    if (second && (!valid || bank.logEnd <= second)) {
+        if (configBankScan(&other, second, &__config_end)
+            && (!valid || (other.segments && (!bank.segments || (int16_t)(other.generation - bank.generation) > 0)))) {
+            bank = other;
+            valid = true;
+        } else if (valid) {
+            // Leave the second bank for the next compaction
+            bank.end = second;
+        }
+    }
+
+    if (!valid) {
+        return false;
+    }
+
+    configBank = bank;
+    eepromConfigSize = bank.logEnd - bank.start;
+
+    // If the index overflowed, loadEEPROM() falls back to scanning
+    configRecordIndexValid = configBankIndex(&bank);
+
+    return true;
 }
 
 uint16_t getEEPROMConfigSize(void)
@@ -333,6 +594,12 @@ uint16_t getEEPROMConfigSize(void)
     return eepromConfigSize;
 }
 
+// Time taken by the last loadEEPROM(), in microseconds
+timeDelta_t getEEPROMLoadTime(void)
+{
+    return eepromLoadTime;
+}
+
 size_t getEEPROMStorageSize(void)
 {
 #if defined(CONFIG_IN_EXTERNAL_FLASH)
@@ -352,28 +619,41 @@ size_t getEEPROMStorageSize(void)
 // this function assumes that EEPROM content is valid
 static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFlags_e classification)
 {
-    const uint8_t *p = &__config_start;
-    p += sizeof(configHeader_t);             // skip header
-    while (true) {
+    if (configRecordIndexValid) {
+        return configRecordIndexFind(pgN(reg), classification);
+    }
+
+    const configRecord_t *found = NULL;
+    bool replace = false;
+
+    if (!configBank.start) {
+        return NULL;
+    }
+
+    const uint8_t *p = configBank.start + sizeof(configHeader_t);
+    while (p < configBank.logEnd) {
         const configRecord_t *record = (const configRecord_t *)p;
-        if (record->size == 0
-            || p + record->size >= &__config_end
-            || record->size < sizeof(*record))
-            break;
-        if (pgN(reg) == record->pgn
-            && (record->flags & CR_CLASSIFICATION_MASK) == classification)
-            return record;
+        if (record->size == 0) {
+            // records in the segments replace the earlier ones
+            p = configBlockNext(p) + sizeof(configSegmentHeader_t);
+            replace = true;
+            continue;
+        }
+        if (configRecordMatches(record, pgN(reg), classification) && (replace || !found)) {
+            found = record;
+        }
         p += record->size;
     }
-    // record not found
-    return NULL;
+
+    return found;
 }
 
 // Initialize all PG records from EEPROM.
-// This functions processes all PGs sequentially, scanning EEPROM for each one. This is suboptimal,
-//   but each PG is loaded/initialized exactly once and in defined order.
+// This functions processes all PGs sequentially, looking up each one in the record index built
+//   by isEEPROMStructureValid(). Each PG is loaded/initialized exactly once and in defined order.
 bool loadEEPROM(void)
 {
+    const timeUs_t startTime = micros();
     bool success = true;
 
     PG_FOREACH(reg) {
@@ -391,68 +671,232 @@ bool loadEEPROM(void)
         *reg->fnv_hash = fnv_update(FNV_OFFSET_BASIS, reg->address, pgSize(reg));
     }
 
+    eepromLoadTime = cmpTimeUs(micros(), startTime);
+
     return success;
 }
 
-static bool writeSettingsToEEPROM(void)
+static bool isPGDirty(const pgRegistry_t *reg)
+{
+    return *reg->fnv_hash != fnv_update(FNV_OFFSET_BASIS, reg->address, pgSize(reg));
+}
+
+static uint32_t configRecordSize(const pgRegistry_t *reg)
+{
+    return sizeof(configRecord_t) + pgSize(reg);
+}
+
+// Size of a block with the given records, up to the start of the next block
+static uint32_t configBlockSize(uint32_t headerSize, uint32_t recordsSize)
+{
+    const uint32_t size = headerSize + recordsSize + sizeof(configFooter_t) + sizeof(uint16_t);
+
+    return (size + CONFIG_STREAMER_BUFFER_SIZE - 1) & ~(uint32_t)(CONFIG_STREAMER_BUFFER_SIZE - 1);
+}
+
+static void configWriteBlockStart(config_streamer_t *streamer, uint16_t *crc, const void *header, uint32_t size)
+{
+    config_streamer_write(streamer, header, size);
+    *crc = crc16_ccitt_update(CRC_START_VALUE, header, size);
+}
+
+static void configWriteRecord(config_streamer_t *streamer, uint16_t *crc, const pgRegistry_t *reg)
+{
+    const uint16_t regSize = pgSize(reg);
+    configRecord_t record = {
+        .size = sizeof(configRecord_t) + regSize,
+        .pgn = pgN(reg),
+        .version = pgVersion(reg),
+        .flags = 0,
+    };
+
+    record.flags |= CR_CLASSICATION_SYSTEM;
+    config_streamer_write(streamer, (uint8_t *)&record, sizeof(record));
+    *crc = crc16_ccitt_update(*crc, (uint8_t *)&record, sizeof(record));
+    config_streamer_write(streamer, reg->address, regSize);
+    *crc = crc16_ccitt_update(*crc, reg->address, regSize);
+}
+
+static void configWriteBlockEnd(config_streamer_t *streamer, uint16_t crc)
+{
+    configFooter_t footer = {
+        .terminator = 0,
+    };
+
+    config_streamer_write(streamer, (uint8_t *)&footer, sizeof(footer));
+    crc = crc16_ccitt_update(crc, (uint8_t *)&footer, sizeof(footer));
+
+    // include inverted CRC in big endian format in the CRC
+    const uint16_t invertedBigEndianCrc = ~(((crc & 0xFF) << 8) | (crc >> 8));
+    config_streamer_write(streamer, (uint8_t *)&invertedBigEndianCrc, sizeof(crc));
+
+    config_streamer_flush(streamer);
+}
+
+static void configWriteSegment(config_streamer_t *streamer, uint16_t sequence, bool dirtyOnly)
+{
+    const configSegmentHeader_t header = {
+        .magic = CONFIG_SEGMENT_MAGIC,
+        .reserved = 0,
+        .sequence = sequence,
+    };
+    uint16_t crc;
+
+    configWriteBlockStart(streamer, &crc, &header, sizeof(header));
+    if (dirtyOnly) {
+        PG_FOREACH(reg) {
+            if (isPGDirty(reg)) {
+                configWriteRecord(streamer, &crc, reg);
+            }
+        }
+    }
+    configWriteBlockEnd(streamer, crc);
+}
+
+#if defined(CONFIG_IN_FLASH) || defined(CONFIG_IN_FILE)
+// Flash can't be programmed twice without erasing. The streamer erases the pages
+// it enters on a page boundary, the rest of the space must still be erased.
+static bool isConfigSpaceErased(const uint8_t *start, const uint8_t *end)
+{
+    const uintptr_t pageSize = config_streamer_page_size();
+    const uintptr_t boundary = ((uintptr_t)start + pageSize - 1) / pageSize * pageSize;
+
+    for (const uint8_t *p = start; p < end && (uintptr_t)p < boundary; p++) {
+        if (*p != 0xFF) {
+            return false;
+        }
+    }
+
+    return true;
+}
+#else
+static bool isConfigSpaceErased(const uint8_t *start, const uint8_t *end)
 {
-    bool dirtyConfig = !isEEPROMVersionValid() || !isEEPROMStructureValid();
+    UNUSED(start);
+    UNUSED(end);
 
-    configHeader_t header = {
+    return true;
+}
+#endif
+
+// Append the changed PGs to the log of the validated bank. Returns false if they don't fit.
+static bool configAppendSegment(config_streamer_t *streamer)
+{
+#if defined(CONFIG_IN_EXTERNAL_FLASH)
+    // Pages are programmed from the start of the partition only
+    UNUSED(streamer);
+
+    return false;
+#else
+    uint32_t recordsSize = 0;
+
+    PG_FOREACH(reg) {
+        if (isPGDirty(reg)) {
+            recordsSize += configRecordSize(reg);
+        }
+    }
+
+    const uint8_t *start = configBank.logEnd;
+    const uint8_t *end = start + configBlockSize(sizeof(configSegmentHeader_t), recordsSize);
+
+    if (end > configBank.end || !isConfigSpaceErased(start, end)) {
+        return false;
+    }
+
+    config_streamer_start(streamer, (uintptr_t)start, configBank.end - start);
+    configWriteSegment(streamer, configBank.sequence + 1, true);
+
+    return true;
+#endif
+}
+
+// Write a snapshot of all the PGs, into the bank not in use if the config
+// storage splits into two banks. Returns false if it doesn't fit there.
+static bool configWriteSnapshot(config_streamer_t *streamer)
+{
+    const configHeader_t header = {
         .eepromConfigVersion =  EEPROM_CONF_VERSION,
         .magic_be =             0xBE,
     };
+    uint32_t recordsSize = 0;
+    uint16_t crc;
+
+    PG_FOREACH(reg) {
+        recordsSize += configRecordSize(reg);
+    }
+
+    const uint8_t *second = configSecondBank();
+    const uint32_t size = configBlockSize(sizeof(header), recordsSize) + configBlockSize(sizeof(configSegmentHeader_t), 0);
+    const uint8_t *start = &__config_start;
+    const uint8_t *end = &__config_end;
+
+    if (second && configBank.start == &__config_start && configBank.end == second) {
+        start = second;
+    } else if (second && configBank.start == second) {
+        end = second;
+    }
+
+    // Never write over the bank in use
+    if (size > (uint32_t)(end - start)) {
+        return false;
+    }
+
+    config_streamer_start(streamer, (uintptr_t)start, end - start);
+
+    configWriteBlockStart(streamer, &crc, &header, sizeof(header));
+    PG_FOREACH(reg) {
+        configWriteRecord(streamer, &crc, reg);
+    }
+    configWriteBlockEnd(streamer, crc);
+
+    // Empty segment, marks the age of the bank
+    configWriteSegment(streamer, configBank.sequence + 1, false);
+
+    return true;
+}
+
+static bool writeSettingsToEEPROM(void)
+{
+    const bool validConfig = isEEPROMVersionValid() && isEEPROMStructureValid();
+    // An image from older firmware is upgraded by the next save
+    bool dirtyConfig = !validConfig || configBank.legacy;
+
+    if (!validConfig) {
+        // Nothing to append to, start over in the first bank
+        memset(&configBank, 0, sizeof(configBank));
+    }
 
     PG_FOREACH(reg) {
-        if (*reg->fnv_hash != fnv_update(FNV_OFFSET_BASIS, reg->address, pgSize(reg))) {
+        if (isPGDirty(reg)) {
             dirtyConfig = true;
         }
     }
 
     // Only write the config if it has changed
     if (dirtyConfig) {
+        // The index is rebuilt when the new config is validated
+        configRecordIndexReset();
+
         config_streamer_t streamer;
         config_streamer_init(&streamer);
 
-        config_streamer_start(&streamer, (uintptr_t)&__config_start, &__config_end - &__config_start);
-
-        config_streamer_write(&streamer, (uint8_t *)&header, sizeof(header));
-        uint16_t crc = CRC_START_VALUE;
-        crc = crc16_ccitt_update(crc, (uint8_t *)&header, sizeof(header));
-        PG_FOREACH(reg) {
-            const uint16_t regSize = pgSize(reg);
-            configRecord_t record = {
-                .size = sizeof(configRecord_t) + regSize,
-                .pgn = pgN(reg),
-                .version = pgVersion(reg),
-                .flags = 0,
-            };
-
-
-            record.flags |= CR_CLASSICATION_SYSTEM;
-            config_streamer_write(&streamer, (uint8_t *)&record, sizeof(record));
-            crc = crc16_ccitt_update(crc, (uint8_t *)&record, sizeof(record));
-            config_streamer_write(&streamer, reg->address, regSize);
-            crc = crc16_ccitt_update(crc, reg->address, regSize);
+        // Append the changed PGs if there is room, compact the config otherwise
+        if (!validConfig || configBank.legacy || !configAppendSegment(&streamer)) {
+            if (!configWriteSnapshot(&streamer)) {
+                return false;
+            }
         }
 
-        configFooter_t footer = {
-            .terminator = 0,
-        };
-
-        config_streamer_write(&streamer, (uint8_t *)&footer, sizeof(footer));
-        crc = crc16_ccitt_update(crc, (uint8_t *)&footer, sizeof(footer));
-
-        // include inverted CRC in big endian format in the CRC
-        const uint16_t invertedBigEndianCrc = ~(((crc & 0xFF) << 8) | (crc >> 8));
-        config_streamer_write(&streamer, (uint8_t *)&invertedBigEndianCrc, sizeof(crc));
-
-        config_streamer_flush(&streamer);
+        if (config_streamer_finish(&streamer) != 0) {
+            return false;
+        }
 
-        return (config_streamer_finish(&streamer) == 0);
-    } else {
-        return true;
+        PG_FOREACH(reg) {
+            *reg->fnv_hash = fnv_update(FNV_OFFSET_BASIS, reg->address, pgSize(reg));
+        }
     }
+
+    return true;
 }
 
 void writeConfigToEEPROM(void)
@@ -23,7 +23,9 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-#define EEPROM_CONF_VERSION 174
+#include "common/time.h"
+
+#define EEPROM_CONF_VERSION 175
 
 bool isEEPROMVersionValid(void);
 bool isEEPROMStructureValid(void);
@@ -31,4 +33,5 @@ bool loadEEPROM(void);
 void writeConfigToEEPROM(void);
 
 uint16_t getEEPROMConfigSize(void);
+timeDelta_t getEEPROMLoadTime(void);
 size_t getEEPROMStorageSize(void);
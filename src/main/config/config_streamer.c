@@ -27,15 +27,6 @@
 
 #include "config/config_streamer.h"
 
-#if !defined(CONFIG_IN_FLASH)
-#if defined(CONFIG_IN_RAM) && defined(PERSISTENT)
-PERSISTENT uint8_t eepromData[EEPROM_SIZE];
-#else
-uint8_t eepromData[EEPROM_SIZE];
-#endif
-#endif
-
-
 #if (defined(STM32H750xx) || defined(STM32H730xx)) && !(defined(CONFIG_IN_EXTERNAL_FLASH) || defined(CONFIG_IN_RAM) || defined(CONFIG_IN_SDCARD))
 #error "The configured MCU only has one flash page which contains the bootloader, no spare flash pages available, use external storage for persistent config or ram for target testing"
 #endif
@@ -77,6 +68,23 @@ uint8_t eepromData[EEPROM_SIZE];
 # endif
 #endif
 
+#if !defined(CONFIG_IN_FLASH)
+#if defined(CONFIG_IN_RAM) && defined(PERSISTENT)
+PERSISTENT uint8_t eepromData[EEPROM_SIZE];
+#elif defined(CONFIG_IN_FILE)
+// Emulates the flash, with the config starting on a page boundary
+uint8_t eepromData[EEPROM_SIZE] __attribute__((aligned(FLASH_PAGE_SIZE)));
+#else
+uint8_t eepromData[EEPROM_SIZE];
+#endif
+#endif
+
+// Erase page size of the config storage
+uint32_t config_streamer_page_size(void)
+{
+    return FLASH_PAGE_SIZE;
+}
+
 void config_streamer_init(config_streamer_t *c)
 {
     memset(c, 0, sizeof(*c));
@@ -63,3 +63,5 @@ int config_streamer_flush(config_streamer_t *c);
 
 int config_streamer_finish(config_streamer_t *c);
 int config_streamer_status(config_streamer_t *c);
+
+uint32_t config_streamer_page_size(void);
@@ -358,6 +358,12 @@ const flashGeometry_t *flashGetGeometry(void)
  * XXX This restriction can and will be fixed by creating a set of flash operation functions that take partition as an additional parameter.
  */
 
+// Two sectors for the blackbox log directory, placed right after FlashFS.
+// They are taken from the end of FlashFS; logs that firmware without the
+// directory left there are kept until the flash is erased.
+#define FLASH_LOGDIR_SECTORS        2
+#define FLASH_LOGDIR_MIN_SECTORS    64
+
 static void flashConfigurePartitions(void)
 {
 
@@ -406,6 +412,18 @@ static void flashConfigurePartitions(void)
     startSector = 0;
 #endif
 
+#if defined(USE_BLACKBOX_LOGDIR)
+    // Blackbox log directory, only on devices large enough for a scan to hurt
+    if (endSector + 1 >= FLASH_LOGDIR_MIN_SECTORS) {
+        startSector = (endSector + 1) - FLASH_LOGDIR_SECTORS;
+
+        flashPartitionSet(FLASH_PARTITION_TYPE_LOGDIR, startSector, endSector);
+
+        endSector = startSector - 1;
+        startSector = 0;
+    }
+#endif
+
 #ifdef USE_FLASHFS
     flashPartitionSet(FLASH_PARTITION_TYPE_FLASHFS, startSector, endSector);
 #endif
@@ -456,6 +474,7 @@ static const char *flashPartitionNames[] = {
     "BBMGMT   ",
     "FIRMWARE ",
     "CONFIG   ",
+    "LOGDIR   ",
 };
 
 const char *flashPartitionGetTypeName(flashPartitionType_e type)
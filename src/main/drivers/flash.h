@@ -87,6 +87,7 @@ typedef enum {
     FLASH_PARTITION_TYPE_BADBLOCK_MANAGEMENT,
     FLASH_PARTITION_TYPE_FIRMWARE,
     FLASH_PARTITION_TYPE_CONFIG,
+    FLASH_PARTITION_TYPE_LOGDIR,
     FLASH_MAX_PARTITIONS
 } flashPartitionType_e;
 
@@ -20,9 +20,12 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
+#include "common/maths.h"
+
 #include "serial.h"
 
 void serialPrint(serialPort_t *instance, const char *str)
@@ -74,6 +77,42 @@ uint8_t serialRead(serialPort_t *instance)
     return instance->vTable->serialRead(instance);
 }
 
+int serialReadBuf(serialPort_t *instance, uint8_t *data, int count)
+{
+    if (instance->vTable->readBuf) {
+        return instance->vTable->readBuf(instance, data, count);
+    }
+
+    int total = 0;
+
+    // At most two runs when the ring wraps
+    while (total < count) {
+        const uint8_t *src;
+        const uint32_t avail = serialPeekRx(instance, &src);
+        if (avail == 0) {
+            break;
+        }
+        const uint32_t len = MIN(avail, (uint32_t)(count - total));
+        memcpy(data + total, src, len);
+        serialConsumeRx(instance, len);
+        total += len;
+    }
+
+    return total;
+}
+
+uint32_t serialPeekRx(serialPort_t *instance, const uint8_t **data)
+{
+    return instance->vTable->rxPeek(instance, data);
+}
+
+void serialConsumeRx(serialPort_t *instance, uint32_t count)
+{
+    if (count > 0) {
+        instance->vTable->rxConsume(instance, count);
+    }
+}
+
 void serialSetBaudRate(serialPort_t *instance, uint32_t baudRate)
 {
     instance->vTable->serialSetBaudRate(instance, baudRate);
@@ -123,3 +162,21 @@ void serialEndWrite(serialPort_t *instance)
     if (instance->vTable->endWrite)
         instance->vTable->endWrite(instance);
 }
+
+uint32_t serialRingPeek(serialPort_t *instance, const uint8_t **data)
+{
+    // The head is advanced by the receive interrupt after the data is stored
+    const uint32_t head = instance->rxBufferHead;
+    const uint32_t tail = instance->rxBufferTail;
+
+    *data = (const uint8_t *)&instance->rxBuffer[tail];
+
+    return (head >= tail) ? head - tail : instance->rxBufferSize - tail;
+}
+
+void serialRingConsume(serialPort_t *instance, uint32_t count)
+{
+    const uint32_t tail = instance->rxBufferTail + count;
+
+    instance->rxBufferTail = (tail >= instance->rxBufferSize) ? tail - instance->rxBufferSize : tail;
+}
@@ -121,6 +121,13 @@ struct serialPortVTable {
     // Optional functions used to buffer large writes.
     void (*beginWrite)(serialPort_t *instance);
     void (*endWrite)(serialPort_t *instance);
+
+    // Zero-copy receive. rxPeek returns the contiguous run of received bytes at
+    // the read position, rxConsume releases up to that many of them.
+    uint32_t (*rxPeek)(serialPort_t *instance, const uint8_t **data);
+    void (*rxConsume)(serialPort_t *instance, uint32_t count);
+    // Optional bulk read, used instead of rxPeek/rxConsume when set.
+    int (*readBuf)(serialPort_t *instance, uint8_t *data, int count);
 };
 
 void serialWrite(serialPort_t *instance, uint8_t ch);
@@ -128,6 +135,9 @@ uint32_t serialRxBytesWaiting(const serialPort_t *instance);
 uint32_t serialTxBytesFree(const serialPort_t *instance);
 void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count);
 uint8_t serialRead(serialPort_t *instance);
+int serialReadBuf(serialPort_t *instance, uint8_t *data, int count);
+uint32_t serialPeekRx(serialPort_t *instance, const uint8_t **data);
+void serialConsumeRx(serialPort_t *instance, uint32_t count);
 void serialSetBaudRate(serialPort_t *instance, uint32_t baudRate);
 void serialSetMode(serialPort_t *instance, portMode_e mode);
 void serialSetCtrlLineStateCb(serialPort_t *instance, void (*cb)(void *context, uint16_t ctrlLineState), void *context);
@@ -140,3 +150,7 @@ uint32_t serialGetBaudRate(serialPort_t *instance);
 void serialWriteBufShim(void *instance, const uint8_t *data, int count);
 void serialBeginWrite(serialPort_t *instance);
 void serialEndWrite(serialPort_t *instance);
+
+// rxPeek/rxConsume for drivers receiving into the rxBuffer ring
+uint32_t serialRingPeek(serialPort_t *instance, const uint8_t **data);
+void serialRingConsume(serialPort_t *instance, uint32_t count);
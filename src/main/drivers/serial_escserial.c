@@ -852,7 +852,10 @@ const struct serialPortVTable escSerialVTable[] = {
         .setBaudRateCb = NULL,
         .writeBuf = NULL,
         .beginWrite = NULL,
-        .endWrite = NULL
+        .endWrite = NULL,
+        .rxPeek = serialRingPeek,
+        .rxConsume = serialRingConsume,
+        .readBuf = NULL,
     }
 };
 
@@ -637,7 +637,10 @@ static const struct serialPortVTable softSerialVTable = {
     .setBaudRateCb = NULL,
     .writeBuf = NULL,
     .beginWrite = NULL,
-    .endWrite = NULL
+    .endWrite = NULL,
+    .rxPeek = serialRingPeek,
+    .rxConsume = serialRingConsume,
+    .readBuf = NULL,
 };
 
 #endif
@@ -27,12 +27,14 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 
 #include "platform.h"
 
 #include "build/build_config.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "io/serial.h"
@@ -204,6 +206,47 @@ uint8_t tcpRead(serialPort_t *instance)
     return ch;
 }
 
+static uint32_t tcpRxPeek(serialPort_t *instance, const uint8_t **data)
+{
+    tcpPort_t *s = (tcpPort_t *)instance;
+    pthread_mutex_lock(&s->rxLock);
+    uint32_t count = serialRingPeek(instance, data);
+    pthread_mutex_unlock(&s->rxLock);
+
+    return count;
+}
+
+static void tcpRxConsume(serialPort_t *instance, uint32_t count)
+{
+    tcpPort_t *s = (tcpPort_t *)instance;
+    pthread_mutex_lock(&s->rxLock);
+    serialRingConsume(instance, count);
+    pthread_mutex_unlock(&s->rxLock);
+}
+
+static int tcpReadBuf(serialPort_t *instance, uint8_t *data, int count)
+{
+    tcpPort_t *s = (tcpPort_t *)instance;
+    int total = 0;
+    pthread_mutex_lock(&s->rxLock);
+
+    // Both runs of a wrapped ring under one lock
+    while (total < count) {
+        const uint8_t *src;
+        uint32_t chunk = serialRingPeek(instance, &src);
+        if (chunk == 0) {
+            break;
+        }
+        chunk = MIN(chunk, (uint32_t)(count - total));
+        memcpy(data + total, src, chunk);
+        serialRingConsume(instance, chunk);
+        total += chunk;
+    }
+    pthread_mutex_unlock(&s->rxLock);
+
+    return total;
+}
+
 void tcpWrite(serialPort_t *instance, uint8_t ch)
 {
     tcpPort_t *s = (tcpPort_t *)instance;
@@ -271,4 +314,7 @@ static const struct serialPortVTable tcpVTable = {
         .writeBuf = NULL,
         .beginWrite = NULL,
         .endWrite = NULL,
+        .rxPeek = tcpRxPeek,
+        .rxConsume = tcpRxConsume,
+        .readBuf = tcpReadBuf,
 };
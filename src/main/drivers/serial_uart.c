@@ -265,6 +265,48 @@ static uint8_t uartRead(serialPort_t *instance)
     return ch;
 }
 
+static uint32_t uartRxPeek(serialPort_t *instance, const uint8_t **data)
+{
+#ifdef USE_DMA
+    const uartPort_t *uartPort = (const uartPort_t *)instance;
+
+    if (uartPort->rxDMAResource) {
+#ifdef USE_HAL_DRIVER
+        uint32_t rxDMAHead = __HAL_DMA_GET_COUNTER(uartPort->Handle.hdmarx);
+#else
+        uint32_t rxDMAHead = xDMA_GetCurrDataCounter(uartPort->rxDMAResource);
+#endif
+
+        *data = (const uint8_t *)&uartPort->port.rxBuffer[uartPort->port.rxBufferSize - uartPort->rxDMAPos];
+
+        // Up to the DMA write position, or to the end of the buffer if it has wrapped
+        if (uartPort->rxDMAPos >= rxDMAHead) {
+            return uartPort->rxDMAPos - rxDMAHead;
+        } else {
+            return uartPort->rxDMAPos;
+        }
+    }
+#endif
+
+    return serialRingPeek(instance, data);
+}
+
+static void uartRxConsume(serialPort_t *instance, uint32_t count)
+{
+#ifdef USE_DMA
+    uartPort_t *uartPort = (uartPort_t *)instance;
+
+    if (uartPort->rxDMAResource) {
+        uartPort->rxDMAPos -= count;
+        if (uartPort->rxDMAPos == 0)
+            uartPort->rxDMAPos = uartPort->port.rxBufferSize;
+    } else
+#endif
+    {
+        serialRingConsume(instance, count);
+    }
+}
+
 static void uartWrite(serialPort_t *instance, uint8_t ch)
 {
     uartPort_t *uartPort = (uartPort_t *)instance;
@@ -305,6 +347,9 @@ const struct serialPortVTable uartVTable[] = {
         .writeBuf = NULL,
         .beginWrite = NULL,
         .endWrite = NULL,
+        .rxPeek = uartRxPeek,
+        .rxConsume = uartRxConsume,
+        .readBuf = NULL,
     }
 };
 
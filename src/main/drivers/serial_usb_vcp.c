@@ -122,6 +122,27 @@ static uint8_t usbVcpRead(serialPort_t *instance)
     }
 }
 
+static int usbVcpReadBuf(serialPort_t *instance, uint8_t *data, int count)
+{
+    UNUSED(instance);
+
+    return CDC_Receive_DATA(data, count);
+}
+
+static uint32_t usbVcpRxPeek(serialPort_t *instance, const uint8_t **data)
+{
+    UNUSED(instance);
+
+    return CDC_Receive_Peek(data);
+}
+
+static void usbVcpRxConsume(serialPort_t *instance, uint32_t count)
+{
+    UNUSED(instance);
+
+    CDC_Receive_Consume(count);
+}
+
 static void usbVcpWriteBuf(serialPort_t *instance, const void *data, int count)
 {
     UNUSED(instance);
@@ -212,7 +233,10 @@ static const struct serialPortVTable usbVTable[] = {
         .setBaudRateCb = usbVcpSetBaudRateCb,
         .writeBuf = usbVcpWriteBuf,
         .beginWrite = usbVcpBeginWrite,
-        .endWrite = usbVcpEndWrite
+        .endWrite = usbVcpEndWrite,
+        .rxPeek = usbVcpRxPeek,
+        .rxConsume = usbVcpRxConsume,
+        .readBuf = usbVcpReadBuf,
     }
 };
 
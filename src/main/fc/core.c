@@ -52,6 +52,7 @@
 #include "drivers/freq.h"
 #include "drivers/sbus_output.h"
 
+#include "fc/pid_subtask.h"
 #include "fc/rc_rates.h"
 #include "fc/rc.h"
 #include "fc/rc_adjustments.h"
@@ -827,6 +828,36 @@ static void subTaskBlackboxFlush(timeUs_t currentTimeUs)
 #endif
 }
 
+typedef struct {
+    void (*subTaskFunc)(timeUs_t currentTimeUs);
+    const char *subTaskName;
+} pidSubTask_t;
+
+// Slots are planned in fc/pid_subtask.c
+static const pidSubTask_t pidSubTasks[PID_SUBTASK_COUNT] = {
+    [PID_SUBTASK_POSITION]          = { subTaskPosition,            "POSITION" },
+    [PID_SUBTASK_SETPOINT]          = { subTaskSetpoint,            "SETPOINT" },
+    [PID_SUBTASK_PID_CONTROLLER]    = { subTaskPidController,       "PID" },
+    [PID_SUBTASK_MIXER]             = { subTaskMixerUpdate,         "MIXER" },
+    [PID_SUBTASK_MOTORS_SERVOS]     = { subTaskMotorsServosUpdate,  "MOTORS" },
+    [PID_SUBTASK_FILTERS]           = { subTaskFilterUpdate,        "FILTERS" },
+    [PID_SUBTASK_BLACKBOX_UPDATE]   = { subTaskBlackboxUpdate,      "BLACKBOX" },
+    [PID_SUBTASK_BLACKBOX_FLUSH]    = { subTaskBlackboxFlush,       "BBFLUSH" },
+};
+
+uint8_t getPidSubTaskCount(void)
+{
+    return PID_SUBTASK_COUNT;
+}
+
+void getPidSubTaskInfo(int index, pidSubTaskInfo_t *info)
+{
+    info->subTaskName = pidSubTasks[index].subTaskName;
+    info->slot = pidSubTaskGetSlot(index);
+    info->slotCount = pidSubTaskGetSlotCount();
+    info->averageExecutionTime10thUs = pidSubTaskGetAverageTime(index);
+}
+
 void taskGyroSample(timeUs_t currentTimeUs)
 {
     UNUSED(currentTimeUs);
@@ -867,169 +898,27 @@ void taskMainPidLoop(timeUs_t currentTimeUs)
 {
     DEBUG_TIME_START(PIDLOOP, pidUpdateCounter & 7);
 
-    if (activePidLoopDenom == 1) {
-        subTaskPosition(currentTimeUs);
-        subTaskSetpoint(currentTimeUs);
-        subTaskPidController(currentTimeUs);
-        subTaskMixerUpdate(currentTimeUs);
-        subTaskMotorsServosUpdate(currentTimeUs);
-        subTaskFilterUpdate(currentTimeUs);
-        subTaskBlackboxUpdate(currentTimeUs);
-        subTaskBlackboxFlush(currentTimeUs);
-    }
-    else if (activePidLoopDenom == 2) {
-        switch (pidUpdateCounter) {
-            case 0:
-                subTaskPosition(currentTimeUs);
-                subTaskSetpoint(currentTimeUs);
-                subTaskPidController(currentTimeUs);
-                subTaskBlackboxFlush(currentTimeUs);
-                break;
-            case 1:
-                subTaskMixerUpdate(currentTimeUs);
-                subTaskMotorsServosUpdate(currentTimeUs);
-                subTaskFilterUpdate(currentTimeUs);
-                subTaskBlackboxUpdate(currentTimeUs);
-                break;
-        }
-    }
-    else if (activePidLoopDenom == 3) {
-        switch (pidUpdateCounter) {
-            case 0:
-                subTaskPosition(currentTimeUs);
-                subTaskSetpoint(currentTimeUs);
-                subTaskPidController(currentTimeUs);
-                subTaskMixerUpdate(currentTimeUs);
-                break;
-            case 1:
-                subTaskMotorsServosUpdate(currentTimeUs);
-                subTaskBlackboxUpdate(currentTimeUs);
-                break;
-            case 2:
-                subTaskFilterUpdate(currentTimeUs);
-                subTaskBlackboxFlush(currentTimeUs);
-                break;
-        }
+    if (pidUpdateCounter == 0) {
+        if (pidSubTaskGetSlotCount() != activePidLoopDenom)
+            pidSubTaskReset(activePidLoopDenom);
+        else
+            pidSubTaskApply();
     }
-    else if (activePidLoopDenom == 4) {
-        switch (pidUpdateCounter) {
-            case 0:
-                subTaskPosition(currentTimeUs);
-                subTaskSetpoint(currentTimeUs);
-                subTaskPidController(currentTimeUs);
-                break;
-            case 1:
-                subTaskMixerUpdate(currentTimeUs);
-                subTaskMotorsServosUpdate(currentTimeUs);
-                break;
-            case 2:
-                subTaskFilterUpdate(currentTimeUs);
-                subTaskBlackboxUpdate(currentTimeUs);
-                break;
-            case 3:
-                subTaskBlackboxFlush(currentTimeUs);
-                break;
-        }
-    }
-    else if (activePidLoopDenom == 5) {
-        switch (pidUpdateCounter) {
-            case 0:
-                subTaskPosition(currentTimeUs);
-                subTaskSetpoint(currentTimeUs);
-                subTaskPidController(currentTimeUs);
-                break;
-            case 1:
-                subTaskMixerUpdate(currentTimeUs);
-                break;
-            case 2:
-                subTaskMotorsServosUpdate(currentTimeUs);
-                subTaskFilterUpdate(currentTimeUs);
-                break;
-            case 3:
-                subTaskBlackboxUpdate(currentTimeUs);
-                break;
-            case 4:
-                subTaskBlackboxFlush(currentTimeUs);
-                break;
-        }
-    }
-    else if (activePidLoopDenom == 6) {
-        switch (pidUpdateCounter) {
-            case 0:
-                subTaskPosition(currentTimeUs);
-                subTaskSetpoint(currentTimeUs);
-                break;
-            case 1:
-                subTaskPidController(currentTimeUs);
-                break;
-            case 2:
-                subTaskMixerUpdate(currentTimeUs);
-                break;
-            case 3:
-                subTaskMotorsServosUpdate(currentTimeUs);
-                subTaskFilterUpdate(currentTimeUs);
-                break;
-            case 4:
-                subTaskBlackboxUpdate(currentTimeUs);
-                break;
-            case 5:
-                subTaskBlackboxFlush(currentTimeUs);
-                break;
-        }
-    }
-    else if (activePidLoopDenom == 7) {
-        switch (pidUpdateCounter) {
-            case 0:
-                subTaskPosition(currentTimeUs);
-                subTaskSetpoint(currentTimeUs);
-                break;
-            case 1:
-                subTaskPidController(currentTimeUs);
-                break;
-            case 2:
-                subTaskMixerUpdate(currentTimeUs);
-                break;
-            case 3:
-                subTaskMotorsServosUpdate(currentTimeUs);
-                break;
-            case 4:
-                subTaskFilterUpdate(currentTimeUs);
-                break;
-            case 5:
-                subTaskBlackboxUpdate(currentTimeUs);
-                break;
-            case 6:
-                subTaskBlackboxFlush(currentTimeUs);
-                break;
+
+    uint32_t startCycles = getCycleCounter();
+
+    for (int index = 0; index < PID_SUBTASK_COUNT; index++) {
+        if (pidSubTaskGetSlot(index) == pidUpdateCounter) {
+            pidSubTasks[index].subTaskFunc(currentTimeUs);
+
+            const uint32_t endCycles = getCycleCounter();
+            pidSubTaskRecord(index, clockCyclesTo10thMicros(endCycles - startCycles));
+            startCycles = endCycles;
         }
     }
-    else if (activePidLoopDenom >= 8) {
-        switch (pidUpdateCounter) {
-            case 0:
-                subTaskPosition(currentTimeUs);
-                break;
-            case 1:
-                subTaskSetpoint(currentTimeUs);
-                break;
-            case 2:
-                subTaskPidController(currentTimeUs);
-                break;
-            case 3:
-                subTaskMixerUpdate(currentTimeUs);
-                break;
-            case 4:
-                subTaskMotorsServosUpdate(currentTimeUs);
-                break;
-            case 5:
-                subTaskFilterUpdate(currentTimeUs);
-                break;
-            case 6:
-                subTaskBlackboxUpdate(currentTimeUs);
-                break;
-            case 7:
-                subTaskBlackboxFlush(currentTimeUs);
-                break;
-        }
+
+    if (pidUpdateCounter == pidSubTaskGetIdleSlot()) {
+        pidSubTaskIdle();
     }
 
     DEBUG_TIME_END(PIDLOOP, pidUpdateCounter & 7);
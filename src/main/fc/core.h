@@ -57,6 +57,16 @@ bool pidLoopReady(void);
 void taskFiltering(timeUs_t currentTimeUs);
 void taskMainPidLoop(timeUs_t currentTimeUs);
 
+typedef struct {
+    const char *subTaskName;
+    uint8_t slot;                           // gyro cycle within the PID cycle
+    uint8_t slotCount;
+    uint32_t averageExecutionTime10thUs;
+} pidSubTaskInfo_t;
+
+uint8_t getPidSubTaskCount(void);
+void getPidSubTaskInfo(int index, pidSubTaskInfo_t *info);
+
 timeUs_t getLastDisarmTimeUs(void);
 bool isTryingToArm();
 void resetTryingToArm();
@@ -0,0 +1,226 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * PID sub-task slot planner
+ *
+ * The PID loop runs once every activePidLoopDenom gyro cycles, and its
+ * sub-tasks are spread over those gyro cycles (slots) so that no single
+ * gyro cycle overruns. The execution time of each sub-task is measured
+ * with a moving sum, like the scheduler task statistics, and the slot
+ * map is periodically re-packed from the measurements.
+ *
+ * A new slot map is only taken into use at the start of a PID cycle,
+ * so that every sub-task is run exactly once per PID cycle.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+#include "common/utils.h"
+
+#include "flight/pid.h"
+
+#include "scheduler/scheduler.h"
+
+#include "pid_subtask.h"
+
+// Sub-tasks that must run before each sub-task in the same PID cycle.
+// The sub-tasks are listed in dependency order.
+static const uint8_t pidSubTaskDepends[PID_SUBTASK_COUNT] = {
+    [PID_SUBTASK_POSITION]          = 0,
+    [PID_SUBTASK_SETPOINT]          = BIT(PID_SUBTASK_POSITION),
+    [PID_SUBTASK_PID_CONTROLLER]    = BIT(PID_SUBTASK_SETPOINT),
+    [PID_SUBTASK_MIXER]             = BIT(PID_SUBTASK_PID_CONTROLLER),
+    [PID_SUBTASK_MOTORS_SERVOS]     = BIT(PID_SUBTASK_MIXER),
+    [PID_SUBTASK_FILTERS]           = 0,
+    [PID_SUBTASK_BLACKBOX_UPDATE]   = BIT(PID_SUBTASK_MOTORS_SERVOS),
+    [PID_SUBTASK_BLACKBOX_FLUSH]    = 0,
+};
+
+static FAST_DATA_ZERO_INIT uint8_t pidSubTaskSlot[PID_SUBTASK_COUNT];
+static FAST_DATA_ZERO_INIT uint8_t pidSubTaskPendingSlot[PID_SUBTASK_COUNT];
+static FAST_DATA_ZERO_INIT uint32_t pidSubTaskMovingSumExecTime10thUs[PID_SUBTASK_COUNT];
+
+static FAST_DATA_ZERO_INIT uint8_t  pidSubTaskPlanDenom;
+static FAST_DATA_ZERO_INIT uint8_t  pidSubTaskPlanIdleSlot;
+static FAST_DATA_ZERO_INIT uint16_t pidSubTaskPlanCycles;
+static FAST_DATA_ZERO_INIT bool     pidSubTaskPlanPending;
+
+static uint32_t pidSubTaskCost(int index)
+{
+    const uint32_t cost = pidSubTaskMovingSumExecTime10thUs[index] / TASK_STATS_MOVING_SUM_COUNT;
+    return MAX(cost, 1U);
+}
+
+// Place each sub-task into the earliest slot that is not before any of its
+// dependencies and still has room within the budget.
+static bool pidSubTaskPack(uint8_t *slots, uint32_t *load, uint32_t budget)
+{
+    for (int slot = 0; slot < pidSubTaskPlanDenom; slot++) {
+        load[slot] = 0;
+    }
+
+    for (int index = 0; index < PID_SUBTASK_COUNT; index++) {
+        const uint32_t cost = pidSubTaskCost(index);
+        int slot = 0;
+
+        for (int dep = 0; dep < index; dep++) {
+            if (pidSubTaskDepends[index] & BIT(dep)) {
+                slot = MAX(slot, slots[dep]);
+            }
+        }
+        while (slot < pidSubTaskPlanDenom && load[slot] + cost > budget) {
+            slot++;
+        }
+        if (slot == pidSubTaskPlanDenom) {
+            return false;
+        }
+
+        slots[index] = slot;
+        load[slot] += cost;
+    }
+
+    return true;
+}
+
+static uint32_t pidSubTaskPeakLoad(const uint8_t *slots)
+{
+    uint32_t load[MAX_PID_PROCESS_DENOM] = { 0 };
+    uint32_t peak = 0;
+
+    for (int index = 0; index < PID_SUBTASK_COUNT; index++) {
+        load[slots[index]] += pidSubTaskCost(index);
+        peak = MAX(peak, load[slots[index]]);
+    }
+
+    return peak;
+}
+
+// Search for the smallest per-slot budget that fits. Everything fits in one slot.
+static void pidSubTaskPlanSlots(uint8_t *slots)
+{
+    uint32_t load[MAX_PID_PROCESS_DENOM];
+    uint32_t total = 0, lower = 0;
+
+    for (int index = 0; index < PID_SUBTASK_COUNT; index++) {
+        const uint32_t cost = pidSubTaskCost(index);
+        lower = MAX(lower, cost);
+        total += cost;
+    }
+
+    uint32_t upper = total;
+    lower = MAX(lower, total / pidSubTaskPlanDenom);
+
+    while (lower < upper) {
+        const uint32_t budget = (lower + upper) / 2;
+        if (pidSubTaskPack(slots, load, budget))
+            upper = budget;
+        else
+            lower = budget + 1;
+    }
+
+    pidSubTaskPack(slots, load, upper);
+}
+
+static void pidSubTaskUse(const uint8_t *slots)
+{
+    uint32_t load[MAX_PID_PROCESS_DENOM] = { 0 };
+
+    memcpy(pidSubTaskSlot, slots, sizeof(pidSubTaskSlot));
+    pidSubTaskPlanPending = false;
+
+    for (int index = 0; index < PID_SUBTASK_COUNT; index++) {
+        load[pidSubTaskSlot[index]] += pidSubTaskCost(index);
+    }
+
+    // Run the planner itself in the least loaded slot
+    pidSubTaskPlanIdleSlot = 0;
+    for (int slot = 1; slot < pidSubTaskPlanDenom; slot++) {
+        if (load[slot] < load[pidSubTaskPlanIdleSlot])
+            pidSubTaskPlanIdleSlot = slot;
+    }
+}
+
+void pidSubTaskReset(uint8_t slotCount)
+{
+    uint8_t slots[PID_SUBTASK_COUNT];
+
+    pidSubTaskPlanDenom = constrain(slotCount, 1, MAX_PID_PROCESS_DENOM);
+    pidSubTaskPlanCycles = 0;
+
+    // Start from equal costs until the sub-tasks have been measured.
+    // The first plan is always taken into use.
+    memset(pidSubTaskMovingSumExecTime10thUs, 0, sizeof(pidSubTaskMovingSumExecTime10thUs));
+
+    pidSubTaskPlanSlots(slots);
+    pidSubTaskUse(slots);
+}
+
+// Called at the start of a PID cycle
+void pidSubTaskApply(void)
+{
+    if (pidSubTaskPlanPending) {
+        pidSubTaskUse(pidSubTaskPendingSlot);
+    }
+}
+
+FAST_CODE void pidSubTaskRecord(int index, uint32_t execTime10thUs)
+{
+    pidSubTaskMovingSumExecTime10thUs[index] += execTime10thUs - pidSubTaskMovingSumExecTime10thUs[index] / TASK_STATS_MOVING_SUM_COUNT;
+}
+
+// Called once per PID cycle, in the idle slot
+void pidSubTaskIdle(void)
+{
+    if (++pidSubTaskPlanCycles >= PID_SUBTASK_REPLAN_CYCLES) {
+        uint8_t slots[PID_SUBTASK_COUNT];
+
+        pidSubTaskPlanCycles = 0;
+        pidSubTaskPlanSlots(slots);
+
+        // Only switch if the current slot map is clearly worse
+        if (pidSubTaskPeakLoad(slots) + PID_SUBTASK_REPLAN_MARGIN < pidSubTaskPeakLoad(pidSubTaskSlot)) {
+            memcpy(pidSubTaskPendingSlot, slots, sizeof(pidSubTaskPendingSlot));
+            pidSubTaskPlanPending = true;
+        }
+    }
+}
+
+uint8_t pidSubTaskGetSlotCount(void)
+{
+    return pidSubTaskPlanDenom;
+}
+
+FAST_CODE uint8_t pidSubTaskGetSlot(int index)
+{
+    return pidSubTaskSlot[index];
+}
+
+FAST_CODE uint8_t pidSubTaskGetIdleSlot(void)
+{
+    return pidSubTaskPlanIdleSlot;
+}
+
+uint32_t pidSubTaskGetAverageTime(int index)
+{
+    return pidSubTaskMovingSumExecTime10thUs[index] / TASK_STATS_MOVING_SUM_COUNT;
+}
@@ -0,0 +1,46 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PID_SUBTASK_REPLAN_CYCLES   250     // PID cycles between re-planning
+#define PID_SUBTASK_REPLAN_MARGIN   10      // Minimum improvement in 10th us
+
+typedef enum {
+    PID_SUBTASK_POSITION,
+    PID_SUBTASK_SETPOINT,
+    PID_SUBTASK_PID_CONTROLLER,
+    PID_SUBTASK_MIXER,
+    PID_SUBTASK_MOTORS_SERVOS,
+    PID_SUBTASK_FILTERS,
+    PID_SUBTASK_BLACKBOX_UPDATE,
+    PID_SUBTASK_BLACKBOX_FLUSH,
+    PID_SUBTASK_COUNT
+} pidSubTask_e;
+
+void pidSubTaskReset(uint8_t slotCount);
+void pidSubTaskApply(void);
+void pidSubTaskRecord(int index, uint32_t execTime10thUs);
+void pidSubTaskIdle(void);
+
+uint8_t pidSubTaskGetSlotCount(void);
+uint8_t pidSubTaskGetSlot(int index);
+uint8_t pidSubTaskGetIdleSlot(void);
+uint32_t pidSubTaskGetAverageTime(int index);
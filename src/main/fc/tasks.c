@@ -151,7 +151,13 @@ static void taskHandleSerial(timeUs_t currentTimeUs)
     }
 #endif
     bool evaluateMspData = ARMING_FLAG(ARMED) ? MSP_SKIP_NON_MSP_DATA : MSP_EVALUATE_NON_MSP_DATA;
-    mspSerialProcess(evaluateMspData, mspFcProcessCommand, mspFcProcessReply);
+
+    // When disarmed, process MSP command bursts for as long as the scheduler has learnt
+    // this task can run. The estimate grows by at most one command per run, and the
+    // task is only started when the estimate fits in before the next gyro cycle.
+    const timeDelta_t mspBudgetUs = ARMING_FLAG(ARMED) ? 0 : MIN(serialConfig()->msp_budget_us, schedulerGetNextStateTime());
+
+    mspSerialProcess(evaluateMspData, mspFcProcessCommand, mspFcProcessReply, mspFcProcessStream, mspBudgetUs);
 }
 
 #ifdef USE_ACC
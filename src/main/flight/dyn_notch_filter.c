@@ -30,6 +30,7 @@
 
 #include <math.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -40,6 +41,7 @@
 #include "common/axis.h"
 #include "common/filter.h"
 #include "common/maths.h"
+#include "common/rfft.h"
 #include "common/sdft.h"
 #include "common/utils.h"
 
@@ -64,10 +66,10 @@
 
 // For an 8k PID loop, at default 600hz max, 6 sequential gyro data points are averaged, SDFT runs 1333Hz.
 // Upper limit of SDFT is half that frequency, eg 666Hz by default.
-// At 8k, if user sets a max of 300Hz, int(8000/600) = 13, sdftSampleRateHz = 615Hz, range 307Hz.
+// At 8k, if user sets a max of 300Hz, int(8000/600) = 13, spectrumSampleRateHz = 615Hz, range 307Hz.
 // Note that lower max requires more samples to be averaged, increasing precision but taking longer to get enough samples.
-// For Bosch at 3200Hz gyro, max of 600, int(3200/1200) = 2, sdftSampleRateHz = 1600, range to 800hz.
-// For Bosch on XClass, better to set a max of 300, int(3200/600) = 5, sdftSampleRateHz = 640, range to 320Hz.
+// For Bosch at 3200Hz gyro, max of 600, int(3200/1200) = 2, spectrumSampleRateHz = 1600, range to 800hz.
+// For Bosch on XClass, better to set a max of 300, int(3200/600) = 5, spectrumSampleRateHz = 640, range to 320Hz.
 
 // When sampleIndex reaches sampleCount, the averaged gyro value is put into the corresponding SDFT.
 // At 8k, with 600Hz max, sampleCount = 6, this happens every 6 * 0.125us, or every 0.75ms.
@@ -81,13 +83,28 @@
 // Four points in the buffer will have changed in that time, and each point will be the average of three samples.
 // Hence output jitter at 4k is about four times worse than at 8k. At 2k output jitter is quite bad.
 
-// Each SDFT output bin has width sdftSampleRateHz/72, ie 18.5Hz per bin at 1333Hz.
-// Usable bandwidth is half this, ie 666Hz if sdftSampleRateHz is 1333Hz, i.e. bin 1 is 18.5Hz, bin 2 is 37.0Hz etc.
+// Each SDFT output bin has width spectrumSampleRateHz/72, ie 18.5Hz per bin at 1333Hz.
+// Usable bandwidth is half this, ie 666Hz if spectrumSampleRateHz is 1333Hz, i.e. bin 1 is 18.5Hz, bin 2 is 37.0Hz etc.
+
+// Alternatively the spectrum can be calculated with a windowed real FFT (common/rfft.h),
+// with RFFT_BIN_COUNT (64/128/256) bins. The transform runs continuously in batches of
+// fixed size, one batch per PID loop, so the cost per loop does not depend on the number
+// of bins. More bins only make the refresh of one axis take more loops.
+// At 8k with 64 bins it takes about 10 PID loops to calculate the FFT of one axis, and the bins are
+// 10.4Hz wide at 1333Hz.
 
 #define DYN_NOTCH_CALC_TICKS       (XYZ_AXIS_COUNT * STEP_COUNT) // 3 axes and 4 steps per axis
 #define DYN_NOTCH_OSD_MIN_THROTTLE 20
 #define DYN_NOTCH_UPDATE_MIN_HZ    1000
 #define DYN_NOTCH_Q_ADVANCE        0.2f
+#define DYN_NOTCH_PEAK_TOLERANCE   0.25f    // relative change of a bin before its peak is re-evaluated
+#define DYN_NOTCH_PEAK_MAX_CHANGES 16       // above this many changed bins, rescan the whole spectrum
+
+#if (RFFT_BIN_COUNT > SDFT_BIN_COUNT)
+#define DYN_NOTCH_BIN_COUNT        RFFT_BIN_COUNT
+#else
+#define DYN_NOTCH_BIN_COUNT        SDFT_BIN_COUNT
+#endif
 
 typedef enum {
     STEP_WINDOW,
@@ -100,8 +117,18 @@ typedef enum {
 typedef struct peak_s {
     int bin;
     float value;
+    float meanBin;
 } peak_t;
 
+// Peaks are tracked across spectrum updates. Only bins that changed by more
+// than DYN_NOTCH_PEAK_TOLERANCE are re-evaluated, and the interpolated peak
+// positions are kept until the bins around them change.
+typedef struct peakTracker_s {
+    float  data[DYN_NOTCH_BIN_COUNT];       // spectrum at the last re-evaluation
+    float  untrackedMax;                    // upper bound of the peaks not in the list
+    peak_t peaks[DYN_NOTCH_COUNT_MAX];      // N biggest peaks in descending order
+} peakTracker_t;
+
 // state machine step information
 typedef struct state_s {
     int tick;
@@ -110,6 +137,7 @@ typedef struct state_s {
 } state_t;
 
 typedef struct dynNotch_s {
+    int engine;
     float q;
     float minHz;
     float maxHz;
@@ -135,13 +163,26 @@ static FAST_DATA_ZERO_INIT float sampleAvg[XYZ_AXIS_COUNT];
 
 // parameters for peak detection and frequency analysis
 static FAST_DATA_ZERO_INIT state_t state;
-static FAST_DATA_ZERO_INIT sdft_t  sdft[XYZ_AXIS_COUNT];
-static FAST_DATA_ZERO_INIT peak_t  peaks[DYN_NOTCH_COUNT_MAX];
-static FAST_DATA_ZERO_INIT float   sdftData[SDFT_BIN_COUNT];
-static FAST_DATA_ZERO_INIT float   sdftSampleRateHz;
-static FAST_DATA_ZERO_INIT float   sdftResolutionHz;
-static FAST_DATA_ZERO_INIT int     sdftStartBin;
-static FAST_DATA_ZERO_INIT int     sdftEndBin;
+static FAST_DATA_ZERO_INIT peakTracker_t tracker[XYZ_AXIS_COUNT];
+static FAST_DATA_ZERO_INIT bool    centerChanged[DYN_NOTCH_COUNT_MAX];
+static FAST_DATA_ZERO_INIT float  *spectrumData;
+
+// Only the selected engine is in use => the engines share their memory
+static FAST_DATA_ZERO_INIT union {
+    struct {
+        sdft_t  axis[XYZ_AXIS_COUNT];
+        float   spectrum[SDFT_BIN_COUNT];
+    } sdft;
+    struct {
+        rfft_t  axis[XYZ_AXIS_COUNT];
+        float   work[RFFT_SAMPLE_SIZE];
+        float   spectrum[RFFT_BIN_COUNT];
+    } fft;
+} engineData;
+static FAST_DATA_ZERO_INIT float   spectrumSampleRateHz;
+static FAST_DATA_ZERO_INIT float   spectrumResolutionHz;
+static FAST_DATA_ZERO_INIT int     spectrumStartBin;
+static FAST_DATA_ZERO_INIT int     spectrumEndBin;
 
 
 INIT_CODE void dynNotchInit(const dynNotchConfig_t *config)
@@ -153,6 +194,7 @@ INIT_CODE void dynNotchInit(const dynNotchConfig_t *config)
     const float updateNyquistHz = updateRateHz / 2.0f;
 
     // always initialise, since the dynamic notch could be activated at any time
+    dynNotch.engine = config->dyn_notch_engine;
     dynNotch.q = config->dyn_notch_q / 10.0f;
     dynNotch.minHz = MAX(config->dyn_notch_min_hz, 10);
     dynNotch.maxHz = MAX(dynNotch.minHz, config->dyn_notch_max_hz);
@@ -168,25 +210,44 @@ INIT_CODE void dynNotchInit(const dynNotchConfig_t *config)
     sampleCount = MAX(1, floorf(updateNyquistHz / dynNotch.maxHz));
     sampleCountRcp = 1.0f / (sampleCount * (filterRateHz / updateRateHz));
 
-    sdftSampleRateHz = updateRateHz / sampleCount;
-    // eg 8k, user max 600hz, int(8000/1200) = 6 (6.666), sdftSampleRateHz = 1333hz, range 666Hz, resolution 18.51Hz
-    // eg 4k, user max 600hz, int(4000/1200) = 3 (3.333), sdftSampleRateHz = 1333hz, range 666Hz, resolution 18.51Hz
-    // eg 2k, user max 600hz, int(2000/1200) = 1 (1.666) sdftSampleRateHz = 2000hz, range 1000Hz, resolution 27.78Hz
-    // eg 2k, user max 500hz, int(2000/1000) = 2 (2.000) sdftSampleRateHz = 1000hz, range 500Hz, resolution 13.89Hz
-    // eg 2k, user max 400hz, int(2000/800)  = 2 (2.500) sdftSampleRateHz = 1000hz, range 500Hz, resolution 13.89Hz
-    // eg 2k, user max 300hz, int(2000/600)  = 3 (3.333) sdftSampleRateHz = 666hz, range 333Hz, resolution 9.25Hz
-    // eg 2k, user max 250hz, int(2000/500)  = 4 (4.000) sdftSampleRateHz = 500hz, range 250Hz, resolution 6.94Hz
-    // eg 1k, user max 600hz, int(1000/1200) = 1 (max(1,0.8333)) sdftSampleRateHz = 1000hz, range 500Hz, resolution 27.78Hz
+    spectrumSampleRateHz = updateRateHz / sampleCount;
+    // eg 8k, user max 600hz, int(8000/1200) = 6 (6.666), spectrumSampleRateHz = 1333hz, range 666Hz, resolution 18.51Hz
+    // eg 4k, user max 600hz, int(4000/1200) = 3 (3.333), spectrumSampleRateHz = 1333hz, range 666Hz, resolution 18.51Hz
+    // eg 2k, user max 600hz, int(2000/1200) = 1 (1.666) spectrumSampleRateHz = 2000hz, range 1000Hz, resolution 27.78Hz
+    // eg 2k, user max 500hz, int(2000/1000) = 2 (2.000) spectrumSampleRateHz = 1000hz, range 500Hz, resolution 13.89Hz
+    // eg 2k, user max 400hz, int(2000/800)  = 2 (2.500) spectrumSampleRateHz = 1000hz, range 500Hz, resolution 13.89Hz
+    // eg 2k, user max 300hz, int(2000/600)  = 3 (3.333) spectrumSampleRateHz = 666hz, range 333Hz, resolution 9.25Hz
+    // eg 2k, user max 250hz, int(2000/500)  = 4 (4.000) spectrumSampleRateHz = 500hz, range 250Hz, resolution 6.94Hz
+    // eg 1k, user max 600hz, int(1000/1200) = 1 (max(1,0.8333)) spectrumSampleRateHz = 1000hz, range 500Hz, resolution 27.78Hz
     // the upper limit of DN is always going to be the Nyquist frequency (= sampleRate / 2)
 
-    sdftResolutionHz = sdftSampleRateHz / SDFT_SAMPLE_SIZE; // 18.5hz per bin at 8k and 600Hz maxHz
-    sdftStartBin = MAX(2, lrintf(dynNotch.minHz / sdftResolutionHz)); // can't use bin 0 because it is DC.
-    sdftEndBin = MIN(SDFT_BIN_COUNT - 1, lrintf(dynNotch.maxHz / sdftResolutionHz)); // can't use more than SDFT_BIN_COUNT bins.
+    const int sampleSize = (dynNotch.engine == DYN_NOTCH_ENGINE_FFT) ? RFFT_SAMPLE_SIZE : SDFT_SAMPLE_SIZE;
+    const int binCount = sampleSize / 2;
+
+    spectrumResolutionHz = spectrumSampleRateHz / sampleSize; // 18.5hz per bin at 8k and 600Hz maxHz with SDFT
+    spectrumStartBin = MAX(2, lrintf(dynNotch.minHz / spectrumResolutionHz)); // can't use bin 0 because it is DC.
+    spectrumEndBin = MIN(binCount - 1, lrintf(dynNotch.maxHz / spectrumResolutionHz)); // can't use more than binCount bins.
+
+    memset(&engineData, 0, sizeof(engineData));
+
+    if (dynNotch.engine == DYN_NOTCH_ENGINE_FFT)
+        spectrumData = engineData.fft.spectrum;
+    else
+        spectrumData = engineData.sdft.spectrum;
 
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        sdftInit(&sdft[axis], sdftStartBin, sdftEndBin, sampleCount);
+        if (dynNotch.engine == DYN_NOTCH_ENGINE_FFT)
+            rfftInit(&engineData.fft.axis[axis], spectrumStartBin, spectrumEndBin);
+        else
+            sdftInit(&engineData.sdft.axis[axis], spectrumStartBin, spectrumEndBin, sampleCount);
     }
 
+    state.tick = 0;
+    state.step = 0;
+    state.axis = 0;
+
+    memset(tracker, 0, sizeof(tracker));
+
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         for (int p = 0; p < dynNotch.count; p++) {
             // any init value is fine, but evenly spreading centerFreqs across frequency range makes notches stick to peaks quicker
@@ -217,6 +278,13 @@ FAST_CODE void dynNotchUpdate(void)
             DEBUG_AXIS(DYN_NOTCH, axis, 3, sampleAvg[axis]);
         }
 
+        // FFT only collects the samples here
+        if (dynNotch.engine == DYN_NOTCH_ENGINE_FFT) {
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                rfftPush(&engineData.fft.axis[axis], sampleAvg[axis]);
+            }
+        }
+
         // We need DYN_NOTCH_CALC_TICKS ticks to update all axes with newly sampled value
         // recalculation of filters takes 4 calls per axis => each filter gets updated every DYN_NOTCH_CALC_TICKS calls
         // at 8kHz PID loop rate this means 8kHz / 4 / 3 = 666Hz => update every 1.5ms
@@ -228,15 +296,21 @@ FAST_CODE void dynNotchUpdate(void)
     DEBUG_TIME_START(DYN_NOTCH_TIME, 1);
 
     // SDFT processing in batches to synchronize with incoming downsampled data
-    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        sdftPushBatch(&sdft[axis], sampleAvg[axis], sampleIndex);
+    if (dynNotch.engine == DYN_NOTCH_ENGINE_SDFT) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            sdftPushBatch(&engineData.sdft.axis[axis], sampleAvg[axis], sampleIndex);
+        }
     }
     DEBUG_TIME_END(DYN_NOTCH_TIME, 1);
 
     sampleIndex++;
 
     // Find frequency peaks and update filters
-    if (state.tick > 0) {
+    if (dynNotch.engine == DYN_NOTCH_ENGINE_FFT) {
+        // FFT runs continuously, one batch per call
+        dynNotchProcess();
+    }
+    else if (state.tick > 0) {
         dynNotchProcess();
         state.tick--;
     }
@@ -244,73 +318,179 @@ FAST_CODE void dynNotchUpdate(void)
     DEBUG_TIME_END(DYN_NOTCH_TIME, 0);
 }
 
+// Estimate true peak position aka. meanBin (fit parabola y(x) over y0, y1 and y2, solve dy/dx=0 for x)
+static FAST_CODE float peakInterpolate(const float *data, int bin)
+{
+    float meanBin = bin;
+
+    // Height of peak bin (y1) and shoulder bins (y0, y2)
+    const float y0 = data[bin - 1];
+    const float y1 = data[bin];
+    const float y2 = data[bin + 1];
+
+    const float denom = 2.0f * (y0 - 2 * y1 + y2);
+    if (denom != 0.0f) {
+        meanBin += (y0 - y2) / denom;
+    }
+
+    return meanBin;
+}
+
+static inline bool peakCheck(const float *data, int bin)
+{
+    return (data[bin] > data[bin - 1]) && (data[bin] > data[bin + 1]);
+}
+
+// Insert peak into the list in descending height order
+static FAST_CODE void peakInsert(peakTracker_t *track, int bin)
+{
+    const float value = track->data[bin];
+
+    for (int p = 0; p < dynNotch.count; p++) {
+        if (value > track->peaks[p].value) {
+            const peak_t *last = &track->peaks[dynNotch.count - 1];
+            if (last->bin != 0) {
+                track->untrackedMax = fmaxf(track->untrackedMax, last->value);
+            }
+            for (int k = dynNotch.count - 1; k > p; k--) {
+                track->peaks[k] = track->peaks[k - 1];
+            }
+            track->peaks[p].bin = bin;
+            track->peaks[p].value = value;
+            track->peaks[p].meanBin = peakInterpolate(track->data, bin);
+            return;
+        }
+    }
+
+    track->untrackedMax = fmaxf(track->untrackedMax, value);
+}
+
+static FAST_CODE void peakRemove(peakTracker_t *track, int p)
+{
+    for (; p < dynNotch.count - 1; p++) {
+        track->peaks[p] = track->peaks[p + 1];
+    }
+
+    track->peaks[p].bin = 0;
+    track->peaks[p].value = 0.0f;
+}
+
+static FAST_CODE int peakFind(const peakTracker_t *track, int bin)
+{
+    for (int p = 0; p < dynNotch.count; p++) {
+        if (track->peaks[p].bin == bin)
+            return p;
+    }
+
+    return -1;
+}
+
+// Search for N biggest peaks in the whole spectrum
+static FAST_CODE void peakRescan(peakTracker_t *track)
+{
+    for (int p = 0; p < dynNotch.count; p++) {
+        track->peaks[p].bin = 0;
+        track->peaks[p].value = 0.0f;
+    }
+
+    track->untrackedMax = 0.0f;
+
+    for (int bin = (spectrumStartBin + 1); bin < spectrumEndBin; bin++) {
+        if (peakCheck(track->data, bin)) {
+            peakInsert(track, bin);
+            bin++; // If bin is peak, next bin can't be peak => skip it
+        }
+    }
+}
+
+static FAST_CODE void peakTrackerUpdate(peakTracker_t *track)
+{
+    int changed[DYN_NOTCH_PEAK_MAX_CHANGES];
+    int changeCount = 0;
+
+    // Changes well below the smallest tracked peak do not matter
+    const float noiseFloor = (dynNotch.count > 0) ? track->peaks[dynNotch.count - 1].value : 0.0f;
+
+    // Pick up the bins that changed noticeably
+    for (int bin = spectrumStartBin; bin <= spectrumEndBin; bin++) {
+        const float value = spectrumData[bin];
+        if (fabsf(value - track->data[bin]) > DYN_NOTCH_PEAK_TOLERANCE * fmaxf(track->data[bin], noiseFloor)) {
+            track->data[bin] = value;
+            if (changeCount < DYN_NOTCH_PEAK_MAX_CHANGES)
+                changed[changeCount] = bin;
+            changeCount++;
+        }
+    }
+
+    if (changeCount > DYN_NOTCH_PEAK_MAX_CHANGES) {
+        peakRescan(track);
+        return;
+    }
+
+    // Re-evaluate the changed bins and their neighbours
+    for (int i = 0; i < changeCount; i++) {
+        const int first = MAX(changed[i] - 1, spectrumStartBin + 1);
+        const int last = MIN(changed[i] + 1, spectrumEndBin - 1);
+
+        for (int bin = first; bin <= last; bin++) {
+            const int p = peakFind(track, bin);
+            if (p >= 0) {
+                peakRemove(track, p);
+            }
+            if (peakCheck(track->data, bin)) {
+                peakInsert(track, bin);
+            }
+        }
+    }
+
+    // Untracked peaks might now be bigger than the smallest tracked one
+    if (changeCount > 0 && dynNotch.count > 0 && track->peaks[dynNotch.count - 1].value < track->untrackedMax) {
+        peakRescan(track);
+    }
+}
+
 // Find frequency peaks and update filters
 static FAST_CODE void dynNotchProcess(void)
 {
+    bool stepDone = true;
+
     DEBUG_TIME_START(DYN_NOTCH_TIME, state.step + 2); // 2-5
 
     switch (state.step) {
 
         case STEP_WINDOW: // 4.1us (3-6us) @ F722
         {
-            sdftWinSq(&sdft[state.axis], sdftData);
+            if (dynNotch.engine == DYN_NOTCH_ENGINE_FFT)
+                stepDone = rfftProcess(&engineData.fft.axis[state.axis], engineData.fft.work, spectrumData);
+            else
+                sdftWinSq(&engineData.sdft.axis[state.axis], spectrumData);
 
             break;
         }
         case STEP_DETECT_PEAKS: // 5.5us (4-7us) @ F722
         {
-            // Get memory ready for new peak data on current axis
-            for (int p = 0; p < dynNotch.count; p++) {
-                peaks[p].bin = 0;
-                peaks[p].value = 0.0f;
-            }
-
-            // Search for N biggest peaks in frequency spectrum
-            for (int bin = (sdftStartBin + 1); bin < sdftEndBin; bin++) {
-                // Check if bin is peak
-                if ((sdftData[bin] > sdftData[bin - 1]) && (sdftData[bin] > sdftData[bin + 1])) {
-                    // Check if peak is big enough to be one of N biggest peaks.
-                    // If so, insert peak and sort peaks in descending height order
-                    for (int p = 0; p < dynNotch.count; p++) {
-                        if (sdftData[bin] > peaks[p].value) {
-                            for (int k = dynNotch.count - 1; k > p; k--) {
-                                peaks[k] = peaks[k - 1];
-                            }
-                            peaks[p].bin = bin;
-                            peaks[p].value = sdftData[bin];
-                            break;
-                        }
-                    }
-                    bin++; // If bin is peak, next bin can't be peak => skip it
-                }
-            }
+            peakTrackerUpdate(&tracker[state.axis]);
 
             break;
         }
         case STEP_CALC_FREQUENCIES: // 4.0us (2-7us) @ F722
         {
+            const peak_t *peaks = tracker[state.axis].peaks;
+
             for (int p = 0; p < dynNotch.count; p++) {
+                centerChanged[p] = false;
 
                 // Only update dynNotch.centerFreq if there is a peak (ignore void peaks) and if peak is above noise floor
                 if (peaks[p].bin != 0 && peaks[p].value > 0.0f) {
 
-                    float meanBin = peaks[p].bin;
-
-                    // Height of peak bin (y1) and shoulder bins (y0, y2)
-                    const float y0 = sdftData[peaks[p].bin - 1];
-                    const float y1 = sdftData[peaks[p].bin];
-                    const float y2 = sdftData[peaks[p].bin + 1];
-
-                    // Estimate true peak position aka. meanBin (fit parabola y(x) over y0, y1 and y2, solve dy/dx=0 for x)
-                    const float denom = 2.0f * (y0 - 2 * y1 + y2);
-                    if (denom != 0.0f) {
-                        meanBin += (y0 - y2) / denom;
-                    }
-
                     // Convert bin to frequency: freq = bin * binResoultion (bin 0 is 0Hz)
-                    const float centerFreq = constrainf(meanBin * sdftResolutionHz, dynNotch.minHz, dynNotch.maxHz);
+                    const float centerFreq = constrainf(peaks[p].meanBin * spectrumResolutionHz, dynNotch.minHz, dynNotch.maxHz);
 
-                    dynNotch.centerFreq[state.axis][p] = centerFreq;
+                    // Peaks that did not move keep their notch as is
+                    if (centerFreq != dynNotch.centerFreq[state.axis][p]) {
+                        dynNotch.centerFreq[state.axis][p] = centerFreq;
+                        centerChanged[p] = true;
+                    }
                 }
             }
 
@@ -336,8 +516,8 @@ static FAST_CODE void dynNotchProcess(void)
         {
             for (int p = 0; p < dynNotch.count; p++) {
                 // Only update notch filter coefficients if the corresponding peak got its center frequency updated in the previous step
-                if (peaks[p].bin != 0 && peaks[p].value > 0.0f) {
-                    biquadFilterUpdate(&dynNotch.notch[state.axis][p], dynNotch.centerFreq[state.axis][p], gyro.filterRateHz, dynNotch.q + p * DYN_NOTCH_Q_ADVANCE, BIQUAD_NOTCH);
+                if (centerChanged[p]) {
+                    biquadNotchUpdate(&dynNotch.notch[state.axis][p], dynNotch.centerFreq[state.axis][p], gyro.filterRateHz, dynNotch.q + p * DYN_NOTCH_Q_ADVANCE);
                 }
             }
 
@@ -349,7 +529,8 @@ static FAST_CODE void dynNotchProcess(void)
 
     DEBUG_TIME_END(DYN_NOTCH_TIME, state.step + 2);
 
-    state.step = (state.step + 1) % STEP_COUNT;
+    if (stepDone)
+        state.step = (state.step + 1) % STEP_COUNT;
 }
 
 FAST_CODE float dynNotchFilter(const int axis, float value)
@@ -498,14 +498,22 @@ static void imuCalculateEstimatedAttitude(timeUs_t currentTimeUs)
         useAcc = imuIsAccelerometerHealthy(accAverage);
     }
 
+    // Average rate over the coning-corrected gyro delta angle since the last update
+    float gyroAverage[XYZ_AXIS_COUNT];
+    if (!gyroGetAccumulationAverage(gyroAverage)) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyroAverage[axis] = gyro.gyroADCf[axis];
+        }
+    }
+
     imuMahonyAHRSupdate(deltaT * 1e-6f,
-                        DEGREES_TO_RADIANS(gyro.gyroADCf[X]),
-                        DEGREES_TO_RADIANS(gyro.gyroADCf[Y]),
-                        DEGREES_TO_RADIANS(gyro.gyroADCf[Z]),
+                        DEGREES_TO_RADIANS(gyroAverage[X]),
+                        DEGREES_TO_RADIANS(gyroAverage[Y]),
+                        DEGREES_TO_RADIANS(gyroAverage[Z]),
                         useAcc, accAverage[X], accAverage[Y], accAverage[Z],
                         useMag,
                         useCOG, courseOverGround,
-                        imuCalcKpGain(currentTimeUs, useAcc, gyro.gyroADCf));
+                        imuCalcKpGain(currentTimeUs, useAcc, gyroAverage));
 
     imuUpdateEulerAngles();
 #endif
@@ -53,6 +53,18 @@
 
 /** Internal data **/
 
+// Mixer rule with the input rate and scaling pre-applied
+typedef struct {
+
+    uint8_t         oper;
+    uint8_t         input;
+    uint8_t         output;
+
+    float           weight;
+    float           offset;
+
+} mixerProgramRule_t;
+
 typedef struct {
 
     float           input[MIXER_INPUT_COUNT];
@@ -83,6 +95,9 @@ typedef struct {
 
     bitmap_t        cyclicMapping;
 
+    uint8_t         ruleCount;
+    mixerProgramRule_t rules[MIXER_RULE_COUNT];
+
 } mixerData_t;
 
 static FAST_DATA_ZERO_INIT mixerData_t mixer;
@@ -481,25 +496,21 @@ static void mixerUpdateSwash(void)
 
 static void mixerUpdateRules(void)
 {
-    for (int i = 0; i < MIXER_RULE_COUNT; i++) {
-        if (mixerRules(i)->oper) {
-            uint8_t src = mixerRules(i)->input;
-            uint8_t dst = mixerRules(i)->output;
-            float   val = mixer.input[src] * mixerInputs(src)->rate / 1000.0f;
-            float   out = (mixerRules(i)->offset + mixerRules(i)->weight * val) / 1000.0f;
-
-            switch (mixerRules(i)->oper)
-            {
-                case MIXER_OP_SET:
-                    mixer.output[dst] = out;
-                    break;
-                case MIXER_OP_ADD:
-                    mixer.output[dst] += out;
-                    break;
-                case MIXER_OP_MUL:
-                    mixer.output[dst] *= out;
-                    break;
-            }
+    for (int i = 0; i < mixer.ruleCount; i++) {
+        const mixerProgramRule_t *rule = &mixer.rules[i];
+        const float out = rule->offset + rule->weight * mixer.input[rule->input];
+
+        switch (rule->oper)
+        {
+            case MIXER_OP_SET:
+                mixer.output[rule->output] = out;
+                break;
+            case MIXER_OP_ADD:
+                mixer.output[rule->output] += out;
+                break;
+            case MIXER_OP_MUL:
+                mixer.output[rule->output] *= out;
+                break;
         }
     }
 }
@@ -603,6 +614,30 @@ void INIT_CODE validateAndFixMixerConfig(void)
     }
 }
 
+// Compile the active rules into a dense program. The rules are kept in
+// their original order, as SET/ADD/MUL on the same output don't commute.
+static void INIT_CODE mixerInitRules(void)
+{
+    mixer.ruleCount = 0;
+
+    for (int i = 0; i < MIXER_RULE_COUNT; i++)
+    {
+        const mixerRule_t *rule = mixerRules(i);
+
+        if (rule->oper > MIXER_OP_NUL && rule->oper < MIXER_OP_COUNT &&
+            rule->input < MIXER_INPUT_COUNT && rule->output < MIXER_OUTPUT_COUNT)
+        {
+            mixerProgramRule_t *prog = &mixer.rules[mixer.ruleCount++];
+
+            prog->oper   = rule->oper;
+            prog->input  = rule->input;
+            prog->output = rule->output;
+            prog->weight = rule->weight * mixerInputs(rule->input)->rate / 1000000.0f;
+            prog->offset = rule->offset / 1000.0f;
+        }
+    }
+}
+
 void INIT_CODE mixerInitConfig(void)
 {
     if (mixerConfig()->swash_pitch_limit)
@@ -633,6 +668,8 @@ void INIT_CODE mixerInitConfig(void)
 
     mixer.tailMotorIdle = mixerConfig()->tail_motor_idle / 1000.0f;
     mixer.tailCenterTrim = mixerConfig()->tail_center_trim / 1000.0f;
+
+    mixerInitRules();
 }
 
 static void INIT_CODE setMapping(uint8_t in, uint8_t out)
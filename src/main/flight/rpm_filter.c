@@ -17,6 +17,7 @@
 
 #include <math.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -39,9 +40,6 @@
 
 #include "rpm_filter.h"
 
-// Number of banks to update in one cycle
-#define RPM_UPDATE_BANK_COUNT       3
-
 // Number of predefined presets
 #define RPM_FILTER_PRESET_COUNT     3
 
@@ -108,31 +106,94 @@ static const rpmNotchConfig_t rpmFilterPreset[RPM_FILTER_PRESET_COUNT] =
     },
 };
 
-// Internal data
+// Notch coefficient set.
+//
+// Banks with the same RPM source, ratio and Q have identical coefficients.
+// That is very common across the axes, so each unique set is calculated
+// only once per update and then copied to all banks using it.
 typedef struct
 {
     uint8_t  motor;
 
-    float    fader;
     float    ratio;
     float    notchQ;
 
-    biquadFilter_t notch;
+    float    fader;
+
+    float    b0;
+    float    b1;
+    float    a2;
+
+} rpmNotchCoeffs_t;
 
-} rpmFilterBank_t;
+// Notch bank for one axis
+typedef struct
+{
+    uint8_t  bank;
+    uint8_t  coeffs;
+
+} rpmNotchLane_t;
+
+// Notch bank in structure-of-arrays layout.
+//
+// One slot holds the same notch position of all axes, so that the
+// three axes can be processed side by side. For a notch b₂ = b₀ and
+// a₁ = b₁, thus only three coefficients are stored.
+typedef struct
+{
+    float b0[RPM_FILTER_AXIS_COUNT];
+    float b1[RPM_FILTER_AXIS_COUNT];
+    float a2[RPM_FILTER_AXIS_COUNT];
 
-FAST_DATA_ZERO_INIT static rpmFilterBank_t filterBank[XYZ_AXIS_COUNT][RPM_FILTER_NOTCH_COUNT];
+    float x1[RPM_FILTER_AXIS_COUNT];
+    float x2[RPM_FILTER_AXIS_COUNT];
+    float y1[RPM_FILTER_AXIS_COUNT];
+    float y2[RPM_FILTER_AXIS_COUNT];
 
-FAST_DATA_ZERO_INIT static uint8_t updateAxisNumber;
-FAST_DATA_ZERO_INIT static uint8_t updateBankNumber;
-FAST_DATA_ZERO_INIT static uint8_t updateBankCount;
-FAST_DATA_ZERO_INIT static uint8_t totalBankCount;
+    float fader[RPM_FILTER_AXIS_COUNT];
+
+} rpmNotchSlot_t;
+
+FAST_DATA_ZERO_INIT static rpmNotchSlot_t notchSlot[RPM_FILTER_NOTCH_COUNT];
+FAST_DATA_ZERO_INIT static uint8_t notchSlotCount;
+
+FAST_DATA_ZERO_INIT static rpmNotchLane_t notchLane[RPM_FILTER_AXIS_COUNT][RPM_FILTER_NOTCH_COUNT];
+FAST_DATA_ZERO_INIT static uint8_t notchLaneCount[RPM_FILTER_AXIS_COUNT];
+
+FAST_DATA_ZERO_INIT static rpmNotchCoeffs_t notchCoeffs[RPM_FILTER_AXIS_COUNT * RPM_FILTER_NOTCH_COUNT];
+FAST_DATA_ZERO_INIT static uint8_t notchCoeffsCount;
 
 FAST_DATA_ZERO_INIT static float notchMaxHz;
 FAST_DATA_ZERO_INIT static float notchMinHz;
 FAST_DATA_ZERO_INIT static float notchFadeHz;
 
 
+static FAST_CODE void rpmNotchCalcCoeffs(rpmNotchCoeffs_t *coeffs, float center, float sampleRate)
+{
+    biquadFilter_t notch;
+
+    biquadNotchUpdate(&notch, center, sampleRate, coeffs->notchQ);
+
+    coeffs->b0 = notch.b0;
+    coeffs->b1 = notch.b1;
+    coeffs->a2 = notch.a2;
+}
+
+static INIT_CODE int rpmNotchFindCoeffs(const rpmNotchCoeffs_t *entry)
+{
+    for (int index = 0; index < notchCoeffsCount; index++) {
+        const rpmNotchCoeffs_t *coeffs = &notchCoeffs[index];
+        if (coeffs->motor == entry->motor &&
+            coeffs->ratio == entry->ratio &&
+            coeffs->notchQ == entry->notchQ)
+            return index;
+    }
+
+    notchCoeffs[notchCoeffsCount] = *entry;
+
+    return notchCoeffsCount++;
+}
+
 INIT_CODE void validateAndFixRPMFilterConfig(void)
 {
     rpmFilterConfig_t *config = rpmFilterConfigMutable();
@@ -168,6 +229,15 @@ INIT_CODE void validateAndFixRPMFilterConfig(void)
 
 INIT_CODE void rpmFilterInit(void)
 {
+    // Start from a clean state - this is called again on config change
+    memset(notchSlot, 0, sizeof(notchSlot));
+    memset(notchLane, 0, sizeof(notchLane));
+    memset(notchLaneCount, 0, sizeof(notchLaneCount));
+    memset(notchCoeffs, 0, sizeof(notchCoeffs));
+
+    notchSlotCount = 0;
+    notchCoeffsCount = 0;
+
     if (featureIsEnabled(FEATURE_RPM_FILTER))
     {
         const rpmFilterConfig_t *config = rpmFilterConfig();
@@ -198,7 +268,8 @@ INIT_CODE void rpmFilterInit(void)
             for (int bank = 0; bank < RPM_FILTER_NOTCH_COUNT; bank++) {
                 if (notch->notch_source[axis][bank] && notch->notch_q[axis][bank])
                 {
-                    rpmFilterBank_t *filter = &filterBank[axis][bank];
+                    rpmNotchCoeffs_t entry = { 0, };
+                    rpmNotchCoeffs_t *filter = &entry;
 
                     // RPM source for this bank
                     const unsigned source = notch->notch_source[axis][bank];
@@ -248,23 +319,31 @@ INIT_CODE void rpmFilterInit(void)
                     else {
                         goto error;
                     }
+
+                    // Keep only the active banks, packed to the front
+                    if (filter->notchQ) {
+                        rpmNotchLane_t *lane = &notchLane[axis][notchLaneCount[axis]++];
+                        lane->bank = bank;
+                        lane->coeffs = rpmNotchFindCoeffs(filter);
+                    }
                 }
             }
         }
 
         // Init all filters @minHz. As soon as the motor is running, the filters are updated to the real RPM.
-        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            for (int bank = 0; bank < RPM_FILTER_NOTCH_COUNT; bank++) {
-                rpmFilterBank_t *filter = &filterBank[axis][bank];
-                if (filter->notchQ) {
-                    biquadFilterInit(&filter->notch, notchMinHz, gyro.filterRateHz, filter->notchQ, BIQUAD_NOTCH);
-                    totalBankCount++;
-                }
-            }
+        for (int index = 0; index < notchCoeffsCount; index++) {
+            rpmNotchCalcCoeffs(&notchCoeffs[index], notchMinHz, gyro.filterRateHz);
         }
 
-        // Number of banks to update in one update cycle
-        updateBankCount = MIN(totalBankCount, RPM_UPDATE_BANK_COUNT);
+        for (int axis = 0; axis < RPM_FILTER_AXIS_COUNT; axis++) {
+            for (int index = 0; index < notchLaneCount[axis]; index++) {
+                const rpmNotchCoeffs_t *coeffs = &notchCoeffs[notchLane[axis][index].coeffs];
+                notchSlot[index].b0[axis] = coeffs->b0;
+                notchSlot[index].b1[axis] = coeffs->b1;
+                notchSlot[index].a2[axis] = coeffs->a2;
+            }
+            notchSlotCount = MAX(notchSlotCount, notchLaneCount[axis]);
+        }
     }
 
     return;
@@ -273,66 +352,83 @@ norpm:
     setArmingDisabled(ARMING_DISABLED_RPM_SIGNAL);
 error:
     setArmingDisabled(ARMING_DISABLED_RPMFILTER);
+
+    // No notches are active - don't keep updating the coefficients
+    memset(notchLaneCount, 0, sizeof(notchLaneCount));
+    notchCoeffsCount = 0;
 }
 
-FAST_CODE float rpmFilterGyro(int axis, float value)
+FAST_CODE void rpmFilterGyro(float *values)
 {
-    if (totalBankCount) {
-        for (int bank = 0; bank < RPM_FILTER_NOTCH_COUNT; bank++) {
-            rpmFilterBank_t *filter = &filterBank[axis][bank];
-            if (filter->notchQ) {
-                value += (biquadFilterApplyDF1(&filter->notch, value) - value) * filter->fader;
-            }
+    for (int slot = 0; slot < notchSlotCount; slot++) {
+        rpmNotchSlot_t *notch = &notchSlot[slot];
+
+        // Unused lanes have zero coefficients and zero fader => pass-through
+        for (int axis = 0; axis < RPM_FILTER_AXIS_COUNT; axis++) {
+            const float input = values[axis];
+            const float output =
+                notch->b0[axis] * (input + notch->x2[axis]) +
+                notch->b1[axis] * (notch->x1[axis] - notch->y1[axis]) -
+                notch->a2[axis] * notch->y2[axis];
+
+            notch->x2[axis] = notch->x1[axis];
+            notch->x1[axis] = input;
+            notch->y2[axis] = notch->y1[axis];
+            notch->y1[axis] = output;
+
+            values[axis] = input + (output - input) * notch->fader[axis];
         }
     }
-    return value;
 }
 
 void rpmFilterUpdate()
 {
-    if (totalBankCount)
+    if (notchCoeffsCount)
     {
         // Actual update rate - allow ±25% variation
         const float updateRate = gyro.filterRateHz * constrainf(schedulerGetCycleTimeMultiplier(), 0.75f, 1.25f);
 
-        // Number of banks to update in one update cycle
-        for (int count = 0; count < updateBankCount;) {
+        // Calculate each unique coefficient set once
+        for (int index = 0; index < notchCoeffsCount; index++) {
+            rpmNotchCoeffs_t *coeffs = &notchCoeffs[index];
 
-            // Current filter
-            rpmFilterBank_t *filter = &filterBank[updateAxisNumber][updateBankNumber];
+            // Calculate notch filter center frequency
+            const float freq = getMotorRPMf(coeffs->motor) * coeffs->ratio;
+            const float center = constrainf(freq, 1, notchMaxHz);
 
-            if (filter->notchQ) {
+            // Calculate fading
+            coeffs->fader = transition(freq, notchMinHz, notchFadeHz, 0, 1);
 
-                // Calculate notch filter center frequency
-                const float rpm = getMotorRPMf(filter->motor);
-                const float freq = rpm * filter->ratio;
-                const float center = constrainf(freq, 1, notchMaxHz);
+            // Update the filter coefficients
+            rpmNotchCalcCoeffs(coeffs, center, updateRate);
+        }
 
-                // Calculate fading
-                filter->fader = transition(freq, notchMinHz, notchFadeHz, 0, 1);
+        // Copy the coefficients to all banks
+        for (int axis = 0; axis < RPM_FILTER_AXIS_COUNT; axis++) {
+            for (int index = 0; index < notchLaneCount[axis]; index++) {
+                const rpmNotchLane_t *lane = &notchLane[axis][index];
+                const rpmNotchCoeffs_t *coeffs = &notchCoeffs[lane->coeffs];
+                rpmNotchSlot_t *notch = &notchSlot[index];
 
-                // Update the filter coefficients
-                biquadFilterUpdate(&filter->notch, center, updateRate, filter->notchQ, BIQUAD_NOTCH);
+                notch->b0[axis] = coeffs->b0;
+                notch->b1[axis] = coeffs->b1;
+                notch->a2[axis] = coeffs->a2;
+                notch->fader[axis] = coeffs->fader;
 
                 // Set debug if bank number matches
-                if (debugAxis == updateAxisNumber * RPM_FILTER_NOTCH_COUNT + updateBankNumber) {
+                if (debugAxis == axis * RPM_FILTER_NOTCH_COUNT + lane->bank) {
+                    const float rpm = getMotorRPMf(coeffs->motor);
+                    const float freq = rpm * coeffs->ratio;
                     DEBUG(RPM_FILTER, 0, rpm);
                     DEBUG(RPM_FILTER, 1, freq * 10);
-                    DEBUG(RPM_FILTER, 2, center * 10);
+                    DEBUG(RPM_FILTER, 2, constrainf(freq, 1, notchMaxHz) * 10);
                     DEBUG(RPM_FILTER, 3, updateRate * 10);
-                    DEBUG(RPM_FILTER, 4, filter->motor);
-                    DEBUG(RPM_FILTER, 6, filter->fader * 1000);
-                    DEBUG(RPM_FILTER, 7, filter->notchQ * 10);
+                    DEBUG(RPM_FILTER, 4, coeffs->motor);
+                    DEBUG(RPM_FILTER, 5, lane->coeffs);
+                    DEBUG(RPM_FILTER, 6, coeffs->fader * 1000);
+                    DEBUG(RPM_FILTER, 7, coeffs->notchQ * 10);
                 }
-
-                // Bank updated
-                count++;
             }
-
-            // Next bank
-            updateBankNumber = (updateBankNumber + 1) % RPM_FILTER_NOTCH_COUNT;
-            if (updateBankNumber == 0)
-                updateAxisNumber = (updateAxisNumber + 1) % RPM_FILTER_AXIS_COUNT;
         }
     }
 }
@@ -21,7 +21,7 @@
 #include "pg/rpm_filter.h"
 
 void  rpmFilterInit(void);
-float rpmFilterGyro(int axis, float values);
+void  rpmFilterGyro(float *values);
 void  rpmFilterUpdate(void);
 
 void validateAndFixRPMFilterConfig(void);
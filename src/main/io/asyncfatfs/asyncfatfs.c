@@ -62,8 +62,8 @@
 
 #define AFATFS_NUM_CACHE_SECTORS 11
 
-// FAT filesystems are allowed to differ from these parameters, but we choose not to support those weird filesystems:
-#define AFATFS_SECTOR_SIZE  512
+// FAT filesystems are allowed to differ from these parameters, but we choose not to support those weird filesystems
+// (AFATFS_SECTOR_SIZE is in asyncfatfs.h):
 #define AFATFS_NUM_FATS     2
 
 #define AFATFS_MAX_OPEN_FILES 3
@@ -560,7 +560,7 @@ static bool afatfs_assert(bool condition)
     return condition;
 }
 
-static bool afatfs_fileIsBusy(afatfsFilePtr_t file)
+bool afatfs_fileIsBusy(afatfsFilePtr_t file)
 {
     return file->operation.operation != AFATFS_FILE_OPERATION_NONE;
 }
@@ -3728,3 +3728,11 @@ uint32_t afatfs_getFreeBufferSpace(void)
     }
     return result;
 }
+
+/**
+ * Get the total size of the write cache, in bytes.
+ */
+uint32_t afatfs_getBufferSize(void)
+{
+    return AFATFS_SECTOR_SIZE * AFATFS_NUM_CACHE_SECTORS;
+}
@@ -25,6 +25,8 @@
 
 #include "fat_standard.h"
 
+#define AFATFS_SECTOR_SIZE  512
+
 typedef struct afatfsFile_t *afatfsFilePtr_t;
 
 typedef enum {
@@ -69,6 +71,7 @@ bool afatfs_fclose(afatfsFilePtr_t file, afatfsCallback_t callback);
 bool afatfs_funlink(afatfsFilePtr_t file, afatfsCallback_t callback);
 
 bool afatfs_feof(afatfsFilePtr_t file);
+bool afatfs_fileIsBusy(afatfsFilePtr_t file);
 void afatfs_fputc(afatfsFilePtr_t file, uint8_t c);
 uint32_t afatfs_fwrite(afatfsFilePtr_t file, const uint8_t *buffer, uint32_t len);
 uint32_t afatfs_fread(afatfsFilePtr_t file, uint8_t *buffer, uint32_t len);
@@ -88,6 +91,7 @@ bool afatfs_destroy(bool dirty);
 void afatfs_poll(void);
 
 uint32_t afatfs_getFreeBufferSpace(void);
+uint32_t afatfs_getBufferSize(void);
 uint32_t afatfs_getContiguousFreeSpace(void);
 bool afatfs_isFull(void);
 
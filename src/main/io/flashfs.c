@@ -39,6 +39,7 @@
 #include "platform.h"
 
 #include "build/debug.h"
+#include "common/maths.h"
 #include "common/printf.h"
 #include "drivers/flash.h"
 #include "drivers/light_led.h"
@@ -71,6 +72,7 @@ static const flashGeometry_t *flashGeometry = NULL;
 STATIC_UNIT_TESTED uint32_t flashfsSize = 0;
 static flashfsState_e flashfsState = FLASHFS_IDLE;
 static flashSector_t eraseSectorCurrent = 0;
+static flashSector_t eraseSectorEnd = 0;
 static uint16_t initialEraseSectors = 0;
 
 static DMA_DATA_ZERO_INIT uint8_t flashWriteBuffer[FLASHFS_WRITE_BUFFER_SIZE];
@@ -150,8 +152,18 @@ static inline uint32_t flashfsAddressShift(uint32_t address, int32_t offset)
 void flashfsEraseCompletely(void)
 {
     if (flashGeometry->sectors > 0 && flashPartitionCount() > 0) {
-        // if there's a single FLASHFS partition and it uses the entire flash then do a full erase
-        const bool doFullErase = (flashPartitionCount() == 1) && (FLASH_PARTITION_SECTOR_COUNT(flashPartition) == flashGeometry->sectors);
+        int partitionCount = 1;
+        eraseSectorEnd = flashPartition->endSector;
+
+        // The blackbox log directory describes the FLASHFS contents, so it goes with them
+        const flashPartition_t *logDirPartition = flashPartitionFindByType(FLASH_PARTITION_TYPE_LOGDIR);
+        if (logDirPartition && logDirPartition->startSector == flashPartition->endSector + 1) {
+            eraseSectorEnd = logDirPartition->endSector;
+            partitionCount++;
+        }
+
+        // if FLASHFS (and the log directory) are the only partitions and use the entire flash then do a full erase
+        const bool doFullErase = (flashPartitionCount() == partitionCount) && (eraseSectorEnd + 1 - flashPartition->startSector == flashGeometry->sectors);
         if (doFullErase) {
             flashEraseCompletely();
         } else {
@@ -506,7 +518,7 @@ void flashfsEraseAsync(void)
 {
     if ((flashfsIsSupported() && flashIsReady())) {
         if (flashfsState == FLASHFS_ALL_ERASING) {
-            if (eraseSectorCurrent <= flashPartition->endSector) {
+            if (eraseSectorCurrent <= eraseSectorEnd) {
                 // Erase sector
                 uint32_t sectorAddress =
                     eraseSectorCurrent * flashGeometry->sectorSize;
@@ -586,17 +598,67 @@ void flashfsWriteByte(uint8_t byte)
 }
 
 /**
- * Write the given buffer to the flash either synchronously or asynchronously depending on the 'sync' parameter.
+ * Reserve the contiguous free space at the head of the write buffer, so that a producer can write into it directly.
  *
- * If writing asynchronously, data will be silently discarded if the buffer overflows.
- * If writing synchronously, the routine will block waiting for the flash to become ready so will never drop data.
+ * Returns the number of bytes that may be written at *data. The data must then be added to the buffer with
+ * flashfsWriteCommit(). The reserved space stays valid until then, as flushing only ever frees more space.
  */
-void flashfsWrite(const uint8_t *data, unsigned int len)
+uint32_t flashfsWriteReserve(uint8_t **data)
 {
-    // Buffer up the data the user supplied instead of writing it right away
-    for (unsigned int i = 0; i < len; i++) {
-        flashfsWriteByte(data[i]);
+    const uint16_t tail = bufferTail;
+    uint32_t space;
+
+    if (tail > bufferHead) {
+        space = tail - bufferHead - 1;
+    } else {
+        // Up to the end of the buffer, leaving one byte free if the tail is at the start
+        space = FLASHFS_WRITE_BUFFER_SIZE - bufferHead - (tail == 0 ? 1 : 0);
     }
+
+    *data = flashWriteBuffer + bufferHead;
+
+    return space;
+}
+
+/**
+ * Add `len` bytes written into space obtained from flashfsWriteReserve() to the write buffer.
+ */
+void flashfsWriteCommit(uint32_t len)
+{
+    uint32_t newHead = bufferHead + len;
+    if (newHead >= FLASHFS_WRITE_BUFFER_SIZE) {
+        newHead -= FLASHFS_WRITE_BUFFER_SIZE;
+    }
+
+    bufferHead = newHead;
+}
+
+/**
+ * Write the given buffer to the flash asynchronously.
+ *
+ * Returns the number of bytes actually buffered. If the buffer overflows, the rest of the data is discarded.
+ */
+uint32_t flashfsWrite(const uint8_t *data, unsigned int len)
+{
+    uint32_t written = 0;
+
+    // The free space is at most two segments, the second one starting from the beginning of the buffer
+    for (int segment = 0; segment < 2 && written < len; segment++) {
+        uint8_t *dest;
+        const uint32_t space = flashfsWriteReserve(&dest);
+        const uint32_t count = MIN(space, len - written);
+
+        if (count == 0) {
+            break;
+        }
+
+        memcpy(dest, data + written, count);
+        flashfsWriteCommit(count);
+
+        written += count;
+    }
+
+    return written;
 }
 
 /**
@@ -36,7 +36,10 @@ const struct flashGeometry_s* flashfsGetGeometry(void);
 void flashfsSeekPhysical(uint32_t offset);
 
 void flashfsWriteByte(uint8_t byte);
-void flashfsWrite(const uint8_t *data, unsigned int len);
+uint32_t flashfsWrite(const uint8_t *data, unsigned int len);
+
+uint32_t flashfsWriteReserve(uint8_t **data);
+void flashfsWriteCommit(uint32_t len);
 
 int flashfsReadAbs(uint32_t offset, uint8_t *data, unsigned int len);
 int flashfsReadPhysical(uint32_t offset, uint8_t *data, unsigned int len);
@@ -57,8 +60,9 @@ bool flashfsVerifyEntireFlash(void);
 
 int flashfsIdentifyStartOfFreeSpace(void);
 
-#ifdef USE_FLASHFS_LOOP
-void flashfsLoopInitialErase(void);
 uint32_t flashfsGetHeadAddress(void);
 uint32_t flashfsGetTailAddress(void);
+
+#ifdef USE_FLASHFS_LOOP
+void flashfsLoopInitialErase(void);
 #endif
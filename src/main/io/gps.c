@@ -755,13 +755,20 @@ void gpsUpdate(timeUs_t currentTimeUs)
 
     // read out available GPS bytes
     if (gpsPort) {
-        while (serialRxBytesWaiting(gpsPort)) {
-            if (cmpTimeUs(micros(), currentTimeUs) > GPS_MAX_WAIT_DATA_RX) {
-                // Wait 1ms and come back
-                rescheduleTask(TASK_SELF, TASK_PERIOD_HZ(TASK_GPS_RATE_FAST));
-                return;
+        const uint8_t *data;
+        uint32_t count;
+
+        while ((count = serialPeekRx(gpsPort, &data)) > 0) {
+            for (uint32_t used = 0; used < count; used++) {
+                if (cmpTimeUs(micros(), currentTimeUs) > GPS_MAX_WAIT_DATA_RX) {
+                    serialConsumeRx(gpsPort, used);
+                    // Wait 1ms and come back
+                    rescheduleTask(TASK_SELF, TASK_PERIOD_HZ(TASK_GPS_RATE_FAST));
+                    return;
+                }
+                gpsNewData(data[used]);
             }
-            gpsNewData(serialRead(gpsPort));
+            serialConsumeRx(gpsPort, count);
         }
         // Restore default task rate
         rescheduleTask(TASK_SELF, TASK_PERIOD_HZ(TASK_GPS_RATE));
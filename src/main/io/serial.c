@@ -167,6 +167,7 @@ void pgResetFn_serialConfig(serialConfig_t *serialConfig)
 
     serialConfig->reboot_character = 'R';
     serialConfig->serial_update_rate_hz = 100;
+    serialConfig->msp_budget_us = 200;
 }
 
 baudRate_e lookupBaudRateIndex(uint32_t baudRate)
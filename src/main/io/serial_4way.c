@@ -401,6 +401,19 @@ static uint8_t ReadByteCrc(void)
     return b;
 }
 
+static void ReadBufCrc(uint8_t *buf, int count)
+{
+    // need timeout?
+    while (count > 0) {
+        const int len = serialReadBuf(port, buf, count);
+        for (int i = 0; i < len; i++) {
+            CRC_in.word = _crc_xmodem_update(CRC_in.word, buf[i]);
+        }
+        buf += len;
+        count -= len;
+    }
+}
+
 static void WriteByte(uint8_t b)
 {
     serialWrite(port, b);
@@ -425,7 +438,6 @@ void esc4wayProcess(serialPort_t *mspPort)
     uint8_16_u Dummy;
     uint8_t O_PARAM_LEN;
     uint8_t *O_PARAM;
-    uint8_t *InBuff;
     ioMem_t ioMem;
 
     port = mspPort;
@@ -455,13 +467,8 @@ void esc4wayProcess(serialPort_t *mspPort)
         ioMem.D_FLASH_ADDR_L = ReadByteCrc();
         I_PARAM_LEN = ReadByteCrc();
 
-        InBuff = ParamBuf;
-        uint8_t i = I_PARAM_LEN;
-        do {
-          *InBuff = ReadByteCrc();
-          InBuff++;
-          i--;
-        } while (i != 0);
+        // zero length means 256 bytes
+        ReadBufCrc(ParamBuf, I_PARAM_LEN ? I_PARAM_LEN : 256);
 
         CRC_check.bytes[1] = ReadByte();
         CRC_check.bytes[0] = ReadByte();
@@ -886,7 +893,7 @@ void esc4wayProcess(serialPort_t *mspPort)
         WriteByteCrc(ioMem.D_FLASH_ADDR_L);
         WriteByteCrc(O_PARAM_LEN);
 
-        i=O_PARAM_LEN;
+        uint8_t i = O_PARAM_LEN;
         do {
             while (!serialTxBytesFree(port));
 
@@ -503,23 +503,34 @@ void read_boot_sector(const emfat_t *emfat, uint8_t *sect)
 
 emfat_entry_t *find_entry(const emfat_t *emfat, uint32_t clust, emfat_entry_t *nearest)
 {
-    if (nearest == NULL) {
-        nearest = emfat->priv.entries;
+    emfat_entry_t *entries = emfat->priv.entries;
+
+    // Sequential reads usually continue in the same or the next entry
+    if (nearest != NULL) {
+        if (IS_CLUST_OF(clust, nearest))
+            return nearest;
+        if (nearest + 1 < entries + emfat->priv.num_entries && IS_CLUST_OF(clust, nearest + 1))
+            return nearest + 1;
     }
 
-    if (nearest->priv.first_clust > clust) {
-        while (nearest >= emfat->priv.entries) { // backward finding
-            if (IS_CLUST_OF(clust, nearest))
-                return nearest;
-            nearest--;
-        }
-    } else {
-        while (nearest->name != NULL) { // forward finding
-            if (IS_CLUST_OF(clust, nearest))
-                return nearest;
-            nearest++;
+    // emfat_init() lays the entries out back to back in cluster order,
+    // so the entry table doubles as a sorted index of cluster ranges
+    int lo = 0;
+    int hi = emfat->priv.num_entries;
+
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (entries[mid].priv.first_clust <= clust) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
+
+    if (lo > 0 && IS_CLUST_OF(clust, &entries[lo - 1])) {
+        return &entries[lo - 1];
+    }
+
     return NULL;
 }
 
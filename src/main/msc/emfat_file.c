@@ -27,8 +27,9 @@
 #include "emfat.h"
 #include "emfat_file.h"
 
+#include "blackbox/blackbox_logdir.h"
+
 #include "common/printf.h"
-#include "common/strtol.h"
 #include "common/time.h"
 #include "common/utils.h"
 
@@ -48,8 +49,6 @@
 
 #define FILESYSTEM_MIN_SIZE_MB 256
 
-#define HDR_BUF_SIZE 32
-
 #ifdef USE_EMFAT_AUTORUN
 static const char autorun_file[] =
     "[autorun]\r\n"
@@ -272,109 +271,43 @@ static void emfat_set_log_entry(emfat_entry_t *entry, uint32_t offset, uint32_t
     entry->cma_time[2] = entry->cma_time[0];
 }
 
-static int emfat_find_log(emfat_entry_t *entry, int maxCount, int flashfsUsedSpace)
-{
-    static uint8_t buffer[HDR_BUF_SIZE];
-
-    const char *logHeader = "H Product:Blackbox";
-    int lenLogHeader = strlen(logHeader);
-    const char *timeHeader = "H Log start datetime:";
-    int lenTimeHeader = strlen(timeHeader);
-
-    int timeHeaderMatched = 0;
-    int lastOffset = -1;
-    int currOffset = 0;
-    int buffOffset;
-    int hdrOffset;
-    int fileNumber = 1;
-    int logCount = 0;
+typedef struct {
+    emfat_entry_t *entry;
+    int count;
+    int maxCount;
+} emfatLogList_t;
 
-    for ( ; currOffset < flashfsUsedSpace ; currOffset += flashGetGeometry()->pageSize) {
-
-        mscSetActive();
-        mscActivityLed();
-
-        flashfsReadAbs(currOffset, buffer, HDR_BUF_SIZE);
-
-        if (strncmp((char *)buffer, logHeader, lenLogHeader)) {
-            continue;
-        }
+static bool emfat_add_log(const blackboxLogEntry_t *log, void *context)
+{
+    emfatLogList_t *list = context;
+    emfat_entry_t *entry = &list->entry[list->count++];
 
-        // The length of the previous record is now known
-        if (lastOffset != -1) {
-            // Record the previous entry
-            emfat_set_log_file_name(entry, fileNumber);
-            emfat_set_log_entry(entry, lastOffset, currOffset - lastOffset);
+    // Set the file creation time, or the default timestamp if the log has none
+    entry->cma_time[0] = log->startTime ? emfat_cma_time_from_unix(log->startTime) : cmaTime;
 
-            entry++;
-            logCount++;
-            fileNumber++;
-        }
+    emfat_set_log_file_name(entry, list->count);
+    emfat_set_log_entry(entry, log->offset, log->size);
 
-        // Find the "Log start datetime" entry, example encoding "H Log start datetime:2019-08-15T13:18:22.199+00:00"
-        buffOffset = lenLogHeader;
-        hdrOffset = currOffset;
-
-        // Set the default timestamp for this log entry in case the timestamp is not found
-        entry->cma_time[0] = cmaTime;
-
-        // Search for the timestamp record
-        while (true) {
-            if (buffer[buffOffset++] == timeHeader[timeHeaderMatched]) {
-                // This matches the header we're looking for so far
-                if (++timeHeaderMatched == lenTimeHeader) {
-                    // Complete match so read date/time into buffer
-                    flashfsReadAbs(hdrOffset + buffOffset, buffer, HDR_BUF_SIZE);
-
-                    // Extract the time values to create the CMA time
-                    char *nextToken = (char *)buffer;
-                    int year = strtoul(nextToken, &nextToken, 10);
-                    int month = strtoul(++nextToken, &nextToken, 10);
-                    int day = strtoul(++nextToken, &nextToken, 10);
-                    int hour = strtoul(++nextToken, &nextToken, 10);
-                    int min = strtoul(++nextToken, &nextToken, 10);
-                    int sec = strtoul(++nextToken, NULL, 10);
-
-                    // Set the file creation time
-                    if (year) {
-                        entry->cma_time[0] = EMFAT_ENCODE_CMA_TIME(day, month, year, hour, min, sec);
-                    }
-
-                    break;
-                }
-            } else {
-                timeHeaderMatched = 0;
-            }
-
-            if (buffOffset == HDR_BUF_SIZE) {
-                // Read the next portion of the header
-                hdrOffset += HDR_BUF_SIZE;
-
-                // Check for flash overflow
-                if (hdrOffset > flashfsUsedSpace) {
-                    break;
-                }
-
-                flashfsReadAbs(hdrOffset, buffer, HDR_BUF_SIZE);
-                buffOffset = 0;
-            }
-        }
+    return list->count < list->maxCount;
+}
 
-        if (fileNumber == maxCount) {
-            break;
-        }
+static void emfat_scan_progress(void)
+{
+    mscSetActive();
+    mscActivityLed();
+}
 
-        lastOffset = currOffset;
-    }
+static int emfat_find_log(emfat_entry_t *entry, int maxCount)
+{
+    emfatLogList_t list = {
+        .entry = entry,
+        .count = 0,
+        .maxCount = maxCount,
+    };
 
-    // Now add the final entry
-    if (fileNumber < maxCount && lastOffset != currOffset && lastOffset != -1) {
-        emfat_set_log_file_name(entry, fileNumber);
-        emfat_set_log_entry(entry, lastOffset, currOffset - lastOffset);
-        logCount++;
-    }
+    blackboxLogDirEnumerate(emfat_add_log, emfat_scan_progress, &list);
 
-    return logCount;
+    return list.count;
 }
 #endif  // USE_FLASHFS
 
@@ -410,7 +343,7 @@ void emfat_init_files(void)
     const int flashfsUsedSpace = flashfsGetOffset();
 
     // Detect and create entries for each individual log
-    const int logCount = emfat_find_log(entry, EMFAT_MAX_LOG_ENTRY, flashfsUsedSpace);
+    const int logCount = emfat_find_log(entry, EMFAT_MAX_LOG_ENTRY);
     entry += logCount;
 
     if (logCount > 0) {
@@ -30,6 +30,7 @@
 
 #include "blackbox/blackbox.h"
 #include "blackbox/blackbox_io.h"
+#include "blackbox/blackbox_logdir.h"
 
 #include "build/build_config.h"
 #include "build/debug.h"
@@ -105,6 +106,7 @@
 #include "io/vtx.h"
 
 #include "msp/msp_box.h"
+#include "msp/msp_dataflash.h"
 #include "msp/msp_protocol.h"
 #include "msp/msp_protocol_v2_betaflight.h"
 #include "msp/msp_protocol_v2_common.h"
@@ -506,6 +508,54 @@ static void serializeDataflashSummaryReply(sbuf_t *dst)
 }
 
 #ifdef USE_FLASHFS
+typedef struct {
+    sbuf_t *dst;
+    uint16_t start;
+    uint16_t index;
+    uint8_t count;
+} mspDataflashLogList_t;
+
+static bool mspDataflashLogVisitor(const blackboxLogEntry_t *entry, void *context)
+{
+    mspDataflashLogList_t *list = context;
+
+    if (list->index++ >= list->start && list->count < UINT8_MAX && sbufBytesRemaining(list->dst) >= 16) {
+        sbufWriteU32(list->dst, entry->offset);
+        sbufWriteU32(list->dst, entry->size);
+        sbufWriteU32(list->dst, entry->startTime);
+        sbufWriteU32(list->dst, entry->fieldHash);
+        list->count++;
+    }
+
+    // Keep going to count all the logs
+    return true;
+}
+
+static void serializeDataflashLogsReply(sbuf_t *dst, uint16_t start)
+{
+    mspDataflashLogList_t list = {
+        .dst = dst,
+        .start = start,
+    };
+
+    uint8_t *hdr = sbufPtr(dst);
+
+    sbufWriteU16(dst, 0);
+    sbufWriteU16(dst, start);
+    sbufWriteU8(dst, 0);
+
+    // The gaps between the directory records are not scanned, that would stall the MSP task.
+    // Without a usable directory the flash is scanned, as the only way to find the logs.
+    if (flashfsIsSupported()) {
+        blackboxLogDirEnumerateRecords(mspDataflashLogVisitor, &list);
+    }
+
+    // Total number of logs, and the number in this reply
+    hdr[0] = list.index & 0xFF;
+    hdr[1] = list.index >> 8;
+    hdr[4] = list.count;
+}
+
 enum compressionType_e {
     NO_COMPRESSION,
     HUFFMAN
@@ -1736,6 +1786,7 @@ static bool mspProcessOutCommand(int16_t cmdMSP, sbuf_t *dst)
         sbufWriteU16(dst, blackboxConfig()->initialEraseFreeSpaceKiB);
         sbufWriteU8(dst, blackboxConfig()->rollingErase);
         sbufWriteU8(dst, blackboxConfig()->gracePeriod);
+        sbufWriteU8(dst, blackboxConfig()->adaptiveRate);
 #else
         sbufWriteU8(dst, 0); // Blackbox not supported
         sbufWriteU8(dst, 0);
@@ -1745,6 +1796,7 @@ static bool mspProcessOutCommand(int16_t cmdMSP, sbuf_t *dst)
         sbufWriteU16(dst, 0);
         sbufWriteU8(dst, 0);
         sbufWriteU8(dst, 0);
+        sbufWriteU8(dst, 0);
 #endif
         break;
 
@@ -2060,6 +2112,71 @@ static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, int16_
         break;
 #endif
 
+#if defined(USE_SCHEDULER_TRACE)
+    case MSP_SCHEDULER_TRACE:
+        {
+            // Send as many events as fit, starting from the requested sequence number
+            const uint32_t head = schedulerTraceHead();
+            uint32_t seq = (sbufBytesRemaining(src) >= 4) ? sbufReadU32(src) : head - SCHEDULER_TRACE_SIZE;
+
+            // Skip the events that have already been overwritten
+            if ((uint32_t)(head - seq) > SCHEDULER_TRACE_SIZE)
+                seq = head - SCHEDULER_TRACE_SIZE;
+
+            sbufWriteU32(dst, head);
+            sbufWriteU32(dst, seq);
+
+            uint8_t *countPtr = sbufPtr(dst);
+            sbufWriteU8(dst, 0);
+
+            schedulerTraceEvent_t event;
+            uint8_t count = 0;
+
+            while (count < UINT8_MAX && sbufBytesRemaining(dst) >= 9 && schedulerTraceRead(seq + count, &event)) {
+                sbufWriteU8(dst, event.taskId);
+                sbufWriteU32(dst, event.startUs);
+                sbufWriteU16(dst, event.duration10thUs);
+                sbufWriteU16(dst, event.margin10thUs);
+                count++;
+            }
+
+            *countPtr = count;
+        }
+        break;
+#endif
+
+#ifdef USE_FLASHFS
+    case MSP_DATAFLASH_LOGS:
+        {
+            // Listing the logs reads the flash, don't do it in flight
+            if (ARMING_FLAG(ARMED)) {
+                return MSP_RESULT_ERROR;
+            }
+
+            // Send as many logs as fit, starting from the requested index
+            const uint16_t start = (sbufBytesRemaining(src) >= 2) ? sbufReadU16(src) : 0;
+            serializeDataflashLogsReply(dst, start);
+        }
+        break;
+
+    case MSP2_DATAFLASH_STREAM:
+        {
+            // Zero length stops the stream in progress
+            const uint32_t address = sbufReadU32(src);
+            const uint32_t length = sbufReadU32(src);
+            const bool allowCompression = sbufBytesRemaining(src) ? sbufReadU8(src) : false;
+            if (length > 0 && flashfsIsSupported()) {
+                mspDataflashStreamStart(srcDesc, dst, address, length, allowCompression);
+            } else {
+                mspDataflashStreamStop(srcDesc);
+                sbufWriteU32(dst, address);
+                sbufWriteU32(dst, 0);
+                sbufWriteU8(dst, 0);
+            }
+        }
+        break;
+#endif
+
     case MSP_BOXNAMES:
         {
             const int page = sbufBytesRemaining(src) ? sbufReadU8(src) : 0;
@@ -2844,6 +2961,9 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, int16_t cmdMSP,
             if (sbufBytesRemaining(src) >= 1) {
                 blackboxConfigMutable()->gracePeriod = sbufReadU8(src);
             }
+            if (sbufBytesRemaining(src) >= 1) {
+                blackboxConfigMutable()->adaptiveRate = sbufReadU8(src);
+            }
         }
         break;
 #endif
@@ -3140,6 +3260,7 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, int16_t cmdMSP,
         mixerInputsMutable(i)->rate = sbufReadU16(src);
         mixerInputsMutable(i)->min = sbufReadU16(src);
         mixerInputsMutable(i)->max = sbufReadU16(src);
+        mixerInitConfig();
         break;
 
     case MSP_SET_MIXER_RULE:
@@ -3152,6 +3273,7 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, int16_t cmdMSP,
         mixerRulesMutable(i)->output = sbufReadU8(src);
         mixerRulesMutable(i)->offset = sbufReadU16(src);
         mixerRulesMutable(i)->weight = sbufReadU16(src);
+        mixerInitConfig();
         break;
 
     case MSP_SET_MIXER_OVERRIDE:
@@ -3725,6 +3847,24 @@ mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPa
     return ret;
 }
 
+/*
+ * Fills the next packet of a stream started by srcDesc, if any
+ */
+bool mspFcProcessStream(mspDescriptor_t srcDesc, mspPacket_t *packet)
+{
+#ifdef USE_FLASHFS
+    if (mspDataflashStreamNext(srcDesc, &packet->buf)) {
+        packet->cmd = MSP2_DATAFLASH_STREAM;
+        packet->result = MSP_RESULT_ACK;
+        return true;
+    }
+#else
+    UNUSED(srcDesc);
+    UNUSED(packet);
+#endif
+    return false;
+}
+
 void mspFcProcessReply(mspPacket_t *reply)
 {
     //sbuf_t *src = &reply->buf;
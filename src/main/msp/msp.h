@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <stdbool.h>
+
 #include "common/streambuf.h"
 
 #define MSP_V2_FRAME_ID         255
@@ -60,10 +62,12 @@ struct serialPort_s;
 typedef void (*mspPostProcessFnPtr)(struct serialPort_s *port); // msp post process function, used for gracefully handling reboots, etc.
 typedef mspResult_e (*mspProcessCommandFnPtr)(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn);
 typedef void (*mspProcessReplyFnPtr)(mspPacket_t *cmd);
+typedef bool (*mspProcessStreamFnPtr)(mspDescriptor_t srcDesc, mspPacket_t *packet); // fills the next unsolicited reply of a stream
 
 
 void mspInit(void);
 mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn);
 void mspFcProcessReply(mspPacket_t *reply);
+bool mspFcProcessStream(mspDescriptor_t srcDesc, mspPacket_t *packet);
 
 mspDescriptor_t mspDescriptorAlloc(void);
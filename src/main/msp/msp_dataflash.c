@@ -0,0 +1,232 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Streamed dataflash download.
+ *
+ * The host requests a range with MSP2_DATAFLASH_STREAM and the FC then pushes
+ * the range as a sequence of MSP2_DATAFLASH_STREAM replies, as fast as the
+ * port drains, without waiting for a request per chunk. Each chunk is
+ *
+ *   u16 sequence, u32 address, u16 size, u8 compression, data[size]
+ *
+ * i.e. the MSP_DATAFLASH_READ reply prefixed with a sequence number, so
+ * the host can detect dropped frames. A chunk with size 0 ends the stream.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_FLASHFS
+
+#include "common/huffman.h"
+#include "common/maths.h"
+#include "common/streambuf.h"
+#include "common/utils.h"
+
+#include "io/flashfs.h"
+
+#include "msp/msp_dataflash.h"
+
+enum {
+    STREAM_NO_COMPRESSION,
+    STREAM_HUFFMAN,
+};
+
+// Compress in small blocks so the chunk can be filled closely
+#define STREAM_HUFFMAN_BLOCK_SIZE   32
+
+typedef struct {
+    bool active;
+    uint8_t compression;
+    mspDescriptor_t descriptor;
+    uint16_t sequence;
+    uint32_t address;           // Next address to send
+    uint32_t endAddress;
+    uint32_t bufferAddress;     // Flash address of the read-ahead buffer
+    uint32_t bufferLength;
+} mspDataflashStream_t;
+
+static mspDataflashStream_t stream;
+
+static DMA_DATA_ZERO_INIT uint8_t streamBuffer[MSP_DATAFLASH_STREAM_BUFFER_SIZE];
+
+
+// Returns the number of bytes available at the stream address, reading ahead if needed
+static uint32_t streamFill(void)
+{
+    uint32_t offset = stream.address - stream.bufferAddress;
+
+    if (stream.address < stream.bufferAddress || offset >= stream.bufferLength) {
+        const uint32_t length = MIN(stream.endAddress - stream.address, sizeof(streamBuffer));
+        const int bytesRead = flashfsReadAbs(stream.address, streamBuffer, length);
+
+        stream.bufferAddress = stream.address;
+        stream.bufferLength = MAX(bytesRead, 0);
+        offset = 0;
+
+        if (stream.bufferLength == 0) {
+            // Read failure, end the stream here
+            stream.endAddress = stream.address;
+        }
+    }
+
+    return stream.bufferLength - offset;
+}
+
+static void streamCopy(sbuf_t *dst)
+{
+    while (stream.address < stream.endAddress && sbufBytesRemaining(dst) > 0) {
+        const uint32_t available = streamFill();
+        const uint32_t length = MIN(available, (uint32_t)sbufBytesRemaining(dst));
+
+        sbufWriteData(dst, streamBuffer + stream.address - stream.bufferAddress, length);
+        stream.address += length;
+    }
+}
+
+#ifdef USE_HUFFMAN
+static uint16_t streamCompress(sbuf_t *dst)
+{
+    // The encoder clears the byte after the last one it writes
+    huffmanState_t state = {
+        .bytesWritten = 0,
+        .outByte = sbufPtr(dst),
+        .outBufLen = sbufBytesRemaining(dst) - 1,
+        .outBit = 0x80,
+    };
+    *state.outByte = 0;
+
+    uint16_t count = 0;
+
+    while (stream.address < stream.endAddress) {
+        const uint32_t available = streamFill();
+        const uint32_t length = MIN(available, (uint32_t)STREAM_HUFFMAN_BLOCK_SIZE);
+        const huffmanState_t saved = state;
+
+        if (length == 0) {
+            break;
+        }
+        if (huffmanEncodeBufStreaming(&state, streamBuffer + stream.address - stream.bufferAddress, length, huffmanTable) < 0) {
+            // Block does not fit, leave it for the next chunk
+            state = saved;
+            break;
+        }
+
+        stream.address += length;
+        count += length;
+    }
+
+    if (state.outBit != 0x80) {
+        ++state.bytesWritten;
+    }
+
+    sbufAdvance(dst, state.bytesWritten);
+
+    return count;
+}
+#endif
+
+/*
+ * Starts streaming [address, address + length) to srcDesc, replacing any
+ * stream in progress. Writes the range actually served and the compression
+ * method into dst.
+ */
+void mspDataflashStreamStart(mspDescriptor_t srcDesc, sbuf_t *dst, uint32_t address, uint32_t length, bool allowCompression)
+{
+    const uint32_t flashfsSize = flashfsGetSize();
+
+    address = MIN(address, flashfsSize);
+    length = MIN(length, flashfsSize - address);
+
+    stream.active = true;
+    stream.descriptor = srcDesc;
+    stream.sequence = 0;
+    stream.address = address;
+    stream.endAddress = address + length;
+    stream.bufferAddress = 0;
+    stream.bufferLength = 0;
+#ifdef USE_HUFFMAN
+    stream.compression = allowCompression ? STREAM_HUFFMAN : STREAM_NO_COMPRESSION;
+#else
+    UNUSED(allowCompression);
+    stream.compression = STREAM_NO_COMPRESSION;
+#endif
+
+    sbufWriteU32(dst, address);
+    sbufWriteU32(dst, length);
+    sbufWriteU8(dst, stream.compression);
+}
+
+void mspDataflashStreamStop(mspDescriptor_t srcDesc)
+{
+    if (stream.descriptor == srcDesc) {
+        stream.active = false;
+    }
+}
+
+/*
+ * Writes the next chunk of the stream owned by srcDesc into dst.
+ * Returns false if there is nothing to send or no room for a chunk.
+ */
+bool mspDataflashStreamNext(mspDescriptor_t srcDesc, sbuf_t *dst)
+{
+    if (!stream.active || stream.descriptor != srcDesc || sbufBytesRemaining(dst) < MSP_DATAFLASH_STREAM_CHUNK_MIN) {
+        return false;
+    }
+
+    sbufWriteU16(dst, stream.sequence++);
+    sbufWriteU32(dst, stream.address);
+
+    uint8_t *sizePtr = sbufPtr(dst);
+    sbufWriteU16(dst, 0);
+    sbufWriteU8(dst, stream.compression);
+
+    uint8_t *dataStart = sbufPtr(dst);
+    const uint32_t startAddress = stream.address;
+
+#ifdef USE_HUFFMAN
+    if (stream.compression == STREAM_HUFFMAN) {
+        uint8_t *countPtr = sbufPtr(dst);
+        sbufWriteU16(dst, 0);
+
+        const uint16_t count = streamCompress(dst);
+        countPtr[0] = count & 0xFF;
+        countPtr[1] = count >> 8;
+    } else
+#endif
+    {
+        streamCopy(dst);
+    }
+
+    if (stream.address == startAddress) {
+        // Empty chunk marks the end
+        dst->ptr = dataStart;
+        stream.active = false;
+    }
+
+    const uint16_t size = sbufPtr(dst) - dataStart;
+    sizePtr[0] = size & 0xFF;
+    sizePtr[1] = size >> 8;
+
+    return true;
+}
+
+#endif // USE_FLASHFS
@@ -0,0 +1,35 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/streambuf.h"
+
+#include "msp/msp.h"
+
+// Flash is read ahead of the port in blocks of this size
+#define MSP_DATAFLASH_STREAM_BUFFER_SIZE    2048
+
+// Smallest chunk payload worth sending (header plus some data)
+#define MSP_DATAFLASH_STREAM_CHUNK_MIN      64
+
+void mspDataflashStreamStart(mspDescriptor_t srcDesc, sbuf_t *dst, uint32_t address, uint32_t length, bool allowCompression);
+void mspDataflashStreamStop(mspDescriptor_t srcDesc);
+bool mspDataflashStreamNext(mspDescriptor_t srcDesc, sbuf_t *dst);
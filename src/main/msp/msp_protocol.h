@@ -210,6 +210,8 @@
 #define MSP_SET_MIXER_INPUT                  171
 #define MSP_MIXER_RULES                      172
 #define MSP_SET_MIXER_RULE                   173
+#define MSP_SCHEDULER_TRACE                  174    //out message         Raw scheduler task invocation trace
+#define MSP_DATAFLASH_LOGS                   175    //out message         Blackbox logs on the dataflash
 
 #define MSP_OSD_VIDEO_CONFIG                 180
 #define MSP_SET_OSD_VIDEO_CONFIG             181
@@ -24,3 +24,4 @@
 #define MSP2_SEND_DSHOT_COMMAND             0x3003
 #define MSP2_GET_VTX_DEVICE_STATUS          0x3004
 #define MSP2_GET_OSD_WARNINGS               0x3005  // returns active OSD warning message text
+#define MSP2_DATAFLASH_STREAM               0x3006  // in/out message: start/stop a streamed dataflash read, chunks follow as replies
@@ -28,6 +28,7 @@
 
 #include "cli/cli.h"
 
+#include "common/maths.h"
 #include "common/streambuf.h"
 #include "common/utils.h"
 #include "common/crc.h"
@@ -42,6 +43,8 @@
 
 static mspPort_t mspPorts[MAX_MSP_PORT_COUNT];
 
+static uint8_t mspSerialOutBuf[MSP_PORT_OUTBUF_SIZE];
+
 static void resetMspPort(mspPort_t *mspPortToReset, serialPort_t *serialPort, bool sharedWithTelemetry)
 {
     memset(mspPortToReset, 0, sizeof(mspPort_t));
@@ -393,8 +396,6 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
 
 static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
 {
-    static uint8_t mspSerialOutBuf[MSP_PORT_OUTBUF_SIZE];
-
     mspPacket_t reply = {
         .buf = { .ptr = mspSerialOutBuf, .end = ARRAYEND(mspSerialOutBuf), },
         .cmd = -1,
@@ -483,12 +484,57 @@ static void mspSerialProcessReceivedReply(mspPort_t *msp, mspProcessReplyFnPtr m
     msp->c_state = MSP_IDLE;
 }
 
+static void mspSerialProcessStream(mspPort_t *msp, mspProcessStreamFnPtr mspProcessStreamFn)
+{
+    // Stream frames are always MSPv2 native, the port may have switched versions since the request
+    const int frameOverhead = 3 + sizeof(mspHeaderV2_t) + 1;
+    int budget = MSP_PORT_STREAM_BYTES_PER_RUN;
+
+    while (budget > 0) {
+        const int payloadSize = MIN((int)serialTxBytesFree(msp->port) - frameOverhead, (int)sizeof(mspSerialOutBuf));
+        if (payloadSize <= 0) {
+            break;
+        }
+
+        mspPacket_t packet = {
+            .buf = { .ptr = mspSerialOutBuf, .end = mspSerialOutBuf + payloadSize, },
+            .cmd = -1,
+            .flags = 0,
+            .result = 0,
+            .direction = MSP_DIRECTION_REPLY,
+        };
+
+        if (!mspProcessStreamFn(msp->descriptor, &packet)) {
+            break;
+        }
+
+        sbufSwitchToReader(&packet.buf, mspSerialOutBuf);
+        const int frameLength = mspSerialEncode(msp, &packet, MSP_V2_NATIVE);
+        if (frameLength == 0) {
+            break;
+        }
+
+        budget -= frameLength;
+    }
+}
+
+// Another command may follow while within budget and an ordinary reply still fits in the TX buffer
+static bool mspSerialCanProcessMore(mspPort_t *msp, timeUs_t startUs, timeDelta_t budgetUs)
+{
+    if (cmpTimeUs(micros(), startUs) >= budgetUs) {
+        return false;
+    }
+
+    return isSerialTransmitBufferEmpty(msp->port) || serialTxBytesFree(msp->port) >= MSP_PORT_OUTBUF_SIZE_MIN + MSP_MAX_HEADER_SIZE + 2;
+}
+
 /*
  * Process MSP commands from serial ports configured as MSP ports.
  *
- * Called periodically by the scheduler.
+ * Called periodically by the scheduler. One command is processed per port and
+ * run, more while budgetUs has not been used up.
  */
-void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn)
+void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn, mspProcessStreamFnPtr mspProcessStreamFn, timeDelta_t budgetUs)
 {
     for (uint8_t portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
         mspPort_t * const mspPort = &mspPorts[portIndex];
@@ -503,24 +549,41 @@ void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessComm
             mspPort->lastActivityMs = millis();
             mspPort->pendingRequest = MSP_PENDING_NONE;
 
-            while (serialRxBytesWaiting(mspPort->port)) {
-                const uint8_t c = serialRead(mspPort->port);
-                const bool consumed = mspSerialProcessReceivedData(mspPort, c);
+            const timeUs_t startUs = micros();
+            const uint8_t *data;
+            uint32_t available;
+            bool done = false;
 
-                if (!consumed && evaluateNonMspData == MSP_EVALUATE_NON_MSP_DATA) {
-                    mspEvaluateNonMspData(mspPort, c);
-                }
+            // Parse straight from the receive buffer, releasing only the bytes parsed so far
+            while (!done && (available = serialPeekRx(mspPort->port, &data)) > 0) {
+                uint32_t used = 0;
+
+                while (used < available) {
+                    const uint8_t c = data[used++];
+                    const bool consumed = mspSerialProcessReceivedData(mspPort, c);
 
-                if (mspPort->c_state == MSP_COMMAND_RECEIVED) {
-                    if (mspPort->packetType == MSP_PACKET_COMMAND) {
-                        mspPostProcessFn = mspSerialProcessReceivedCommand(mspPort, mspProcessCommandFn);
-                    } else if (mspPort->packetType == MSP_PACKET_REPLY) {
-                        mspSerialProcessReceivedReply(mspPort, mspProcessReplyFn);
+                    if (!consumed && evaluateNonMspData == MSP_EVALUATE_NON_MSP_DATA) {
+                        mspEvaluateNonMspData(mspPort, c);
                     }
 
-                    mspPort->c_state = MSP_IDLE;
-                    break; // process one command at a time so as not to block.
+                    if (mspPort->c_state == MSP_COMMAND_RECEIVED) {
+                        if (mspPort->packetType == MSP_PACKET_COMMAND) {
+                            mspPostProcessFn = mspSerialProcessReceivedCommand(mspPort, mspProcessCommandFn);
+                        } else if (mspPort->packetType == MSP_PACKET_REPLY) {
+                            mspSerialProcessReceivedReply(mspPort, mspProcessReplyFn);
+                        }
+
+                        mspPort->c_state = MSP_IDLE;
+
+                        // process one command at a time so as not to block, unless there is budget for more
+                        if (mspPostProcessFn || !mspSerialCanProcessMore(mspPort, startUs, budgetUs)) {
+                            done = true;
+                            break;
+                        }
+                    }
                 }
+
+                serialConsumeRx(mspPort->port, used);
             }
 
             if (mspPostProcessFn) {
@@ -530,6 +593,10 @@ void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessComm
         } else {
             mspProcessPendingRequest(mspPort);
         }
+
+        if (mspProcessStreamFn && !mspPostProcessFn) {
+            mspSerialProcessStream(mspPort, mspProcessStreamFn);
+        }
     }
 }
 
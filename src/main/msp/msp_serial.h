@@ -95,6 +95,9 @@ typedef struct __attribute__((packed)) {
 
 #define MSP_MAX_HEADER_SIZE     9
 
+// Upper limit for streamed replies per port and scheduler run, for ports that never run out of TX space
+#define MSP_PORT_STREAM_BYTES_PER_RUN   8192
+
 struct serialPort_s;
 typedef struct mspPort_s {
     struct serialPort_s *port; // null when port unused.
@@ -116,7 +119,7 @@ typedef struct mspPort_s {
 
 void mspSerialInit(void);
 bool mspSerialWaiting(void);
-void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn);
+void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn, mspProcessStreamFnPtr mspProcessStreamFn, timeDelta_t budgetUs);
 void mspSerialAllocatePorts(void);
 void mspSerialReleasePortIfAllocated(struct serialPort_s *serialPort);
 void mspSerialReleaseSharedTelemetryPorts(void);
@@ -63,6 +63,7 @@ PG_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig,
     .initialEraseFreeSpaceKiB = 0,
     .rollingErase = 0,
     .gracePeriod = 5,
+    .adaptiveRate = 0,
 );
 
 #endif
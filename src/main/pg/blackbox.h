@@ -46,6 +46,7 @@ typedef struct blackboxConfig_s {
     uint16_t    initialEraseFreeSpaceKiB;
     uint8_t     rollingErase;
     uint8_t     gracePeriod;
+    uint8_t     adaptiveRate;
 } blackboxConfig_t;
 
 PG_DECLARE(blackboxConfig_t, blackboxConfig);
@@ -34,6 +34,7 @@ PG_RESET_TEMPLATE(dynNotchConfig_t, dynNotchConfig,
     .dyn_notch_q = 25,
     .dyn_notch_min_hz = 20,
     .dyn_notch_max_hz = 240,
+    .dyn_notch_engine = DYN_NOTCH_ENGINE_SDFT,
 );
 
 #endif // USE_DYN_NOTCH_FILTER
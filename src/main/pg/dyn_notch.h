@@ -24,12 +24,18 @@
 
 #include "pg/pg.h"
 
+typedef enum {
+    DYN_NOTCH_ENGINE_SDFT = 0,
+    DYN_NOTCH_ENGINE_FFT,
+} dynNotchEngine_e;
+
 typedef struct dynNotchConfig_s
 {
     uint8_t  dyn_notch_count;
     uint8_t  dyn_notch_q;
     uint16_t dyn_notch_min_hz;
     uint16_t dyn_notch_max_hz;
+    uint8_t  dyn_notch_engine;
 
 } dynNotchConfig_t;
 
@@ -127,10 +127,10 @@ extern const uint8_t __pg_resetdata_end[];
         .length = 1,                                                    \
         .size = sizeof(_type) | PGR_SIZE_SYSTEM_FLAG,                   \
         .address = (uint8_t*)&_name ## _System,                         \
-        .fnv_hash = &_name ## _fnv_hash,                                \
         .copy = (uint8_t*)&_name ## _Copy,                              \
         .ptr = 0,                                                       \
         _reset,                                                         \
+        .fnv_hash = &_name ## _fnv_hash,                                \
     }                                                                   \
     /**/
 
@@ -159,10 +159,10 @@ extern const uint8_t __pg_resetdata_end[];
         .length = _length,                                              \
         .size = (sizeof(_type) * _length) | PGR_SIZE_SYSTEM_FLAG,       \
         .address = (uint8_t*)&_name ## _SystemArray,                    \
-        .fnv_hash = &_name ## _fnv_hash,                                \
         .copy = (uint8_t*)&_name ## _CopyArray,                         \
         .ptr = 0,                                                       \
         _reset,                                                         \
+        .fnv_hash = &_name ## _fnv_hash,                                \
     }                                                                   \
     /**/
 
@@ -37,6 +37,7 @@ typedef struct {
     serialPortConfig_t portConfigs[SERIAL_PORT_COUNT];
     uint16_t    serial_update_rate_hz;
     uint8_t     reboot_character;
+    uint16_t    msp_budget_us;          // time for processing more than one MSP command per run when disarmed
 } serialConfig_t;
 
 PG_DECLARE(serialConfig_t, serialConfig);
@@ -103,6 +103,15 @@ static FAST_DATA_ZERO_INIT bool gyroEnabled;
 static int32_t desiredPeriodCycles;
 static uint32_t lastTargetCycles;
 
+#if defined(USE_SCHEDULER_TRACE)
+STATIC_ASSERT((SCHEDULER_TRACE_SIZE & (SCHEDULER_TRACE_SIZE - 1)) == 0, scheduler_trace_size_not_power_of_two);
+
+// Single producer ring, the sequence number is only advanced after the event is written
+static schedulerTraceEvent_t traceEvents[SCHEDULER_TRACE_SIZE];
+static volatile uint32_t traceHead;
+static uint32_t traceDeadlineCycles;
+#endif
+
 static uint8_t skippedRxAttempts = 0;
 #ifdef USE_OSD
 static uint8_t skippedOSDAttempts = 0;
@@ -121,11 +130,33 @@ static timeMs_t lastFailsafeCheckMs = 0;
 
 STATIC_UNIT_TESTED FAST_DATA_ZERO_INIT task_t* taskQueueArray[TASK_COUNT + 1]; // extra item for NULL pointer at end of queue
 
+#if defined(USE_SCHEDULER_HEAP)
+/*
+ * Time-driven tasks that are not yet due are kept in a min-heap keyed by
+ * their due time, so that they cost nothing until they are due. Due tasks
+ * and event-driven tasks are kept in a ready list in queue order, and only
+ * those are aged and prioritised on each scheduler pass.
+ *
+ * Both are rebuilt from the task queue whenever it changes.
+ */
+static FAST_DATA_ZERO_INIT task_t *taskHeapArray[TASK_COUNT];
+static FAST_DATA_ZERO_INIT int taskHeapSize;
+
+static FAST_DATA_ZERO_INIT task_t *taskReadyArray[TASK_COUNT];
+static FAST_DATA_ZERO_INIT int taskReadyCount;
+
+static FAST_DATA_ZERO_INIT uint8_t taskQueueOrder[TASK_COUNT];
+static FAST_DATA_ZERO_INIT bool taskHeapDirty;
+#endif
+
 void queueClear(void)
 {
     memset(taskQueueArray, 0, sizeof(taskQueueArray));
     taskQueuePos = 0;
     taskQueueSize = 0;
+#if defined(USE_SCHEDULER_HEAP)
+    taskHeapDirty = true;
+#endif
 }
 
 bool queueContains(task_t *task)
@@ -148,6 +179,9 @@ bool queueAdd(task_t *task)
             memmove(&taskQueueArray[ii+1], &taskQueueArray[ii], sizeof(task) * (taskQueueSize - ii));
             taskQueueArray[ii] = task;
             ++taskQueueSize;
+#if defined(USE_SCHEDULER_HEAP)
+            taskHeapDirty = true;
+#endif
             return true;
         }
     }
@@ -160,6 +194,9 @@ bool queueRemove(task_t *task)
         if (taskQueueArray[ii] == task) {
             memmove(&taskQueueArray[ii], &taskQueueArray[ii+1], sizeof(task) * (taskQueueSize - ii));
             --taskQueueSize;
+#if defined(USE_SCHEDULER_HEAP)
+            taskHeapDirty = true;
+#endif
             return true;
         }
     }
@@ -169,7 +206,7 @@ bool queueRemove(task_t *task)
 /*
  * Returns first item queue or NULL if queue empty
  */
-static inline task_t *queueFirst(void)
+STATIC_INLINE_UNIT_TESTED task_t *queueFirst(void)
 {
     taskQueuePos = 0;
     return taskQueueArray[0]; // guaranteed to be NULL if queue is empty
@@ -178,11 +215,126 @@ static inline task_t *queueFirst(void)
 /*
  * Returns next item in queue or NULL if at end of queue
  */
-static inline task_t *queueNext(void)
+STATIC_INLINE_UNIT_TESTED task_t *queueNext(void)
 {
     return taskQueueArray[++taskQueuePos]; // guaranteed to be NULL at end of queue
 }
 
+#if defined(USE_SCHEDULER_HEAP)
+static inline timeUs_t taskDueAtUs(const task_t *task)
+{
+    return task->lastExecutedAtUs + task->attribute->desiredPeriodUs;
+}
+
+static inline bool taskDueBefore(const task_t *a, const task_t *b)
+{
+    return cmpTimeUs(taskDueAtUs(a), taskDueAtUs(b)) < 0;
+}
+
+static void taskHeapPush(task_t *task)
+{
+    int ii = taskHeapSize++;
+
+    while (ii > 0) {
+        const int parent = (ii - 1) / 2;
+        if (!taskDueBefore(task, taskHeapArray[parent]))
+            break;
+        taskHeapArray[ii] = taskHeapArray[parent];
+        ii = parent;
+    }
+
+    taskHeapArray[ii] = task;
+}
+
+static task_t *taskHeapPop(void)
+{
+    task_t *first = taskHeapArray[0];
+    task_t *last = taskHeapArray[--taskHeapSize];
+    int ii = 0;
+
+    while (true) {
+        int child = 2 * ii + 1;
+        if (child >= taskHeapSize)
+            break;
+        if (child + 1 < taskHeapSize && taskDueBefore(taskHeapArray[child + 1], taskHeapArray[child]))
+            child++;
+        if (!taskDueBefore(taskHeapArray[child], last))
+            break;
+        taskHeapArray[ii] = taskHeapArray[child];
+        ii = child;
+    }
+
+    taskHeapArray[ii] = last;
+
+    return first;
+}
+
+// Keep the ready list in queue order, so that ties are broken as in the queue scan
+static void taskReadyInsert(task_t *task)
+{
+    const uint8_t order = taskQueueOrder[task - tasks];
+    int ii = taskReadyCount++;
+
+    while (ii > 0 && taskQueueOrder[taskReadyArray[ii - 1] - tasks] > order) {
+        taskReadyArray[ii] = taskReadyArray[ii - 1];
+        ii--;
+    }
+
+    taskReadyArray[ii] = task;
+}
+
+static void taskReadyRemove(task_t *task)
+{
+    for (int ii = 0; ii < taskReadyCount; ii++) {
+        if (taskReadyArray[ii] == task) {
+            memmove(&taskReadyArray[ii], &taskReadyArray[ii+1], sizeof(task) * (taskReadyCount - ii - 1));
+            taskReadyCount--;
+            break;
+        }
+    }
+}
+
+static void taskHeapBuild(void)
+{
+    taskHeapSize = 0;
+    taskReadyCount = 0;
+
+    for (int ii = 0; ii < taskQueueSize; ii++) {
+        task_t *task = taskQueueArray[ii];
+        taskQueueOrder[task - tasks] = ii;
+        if (task->attribute->staticPriority != TASK_PRIORITY_REALTIME) {
+            if (task->attribute->checkFunc)
+                taskReadyArray[taskReadyCount++] = task;
+            else
+                taskHeapPush(task);
+        }
+    }
+
+    taskHeapDirty = false;
+}
+
+// Move the time-driven tasks that have become due to the ready list
+static FAST_CODE void taskHeapUpdate(timeUs_t currentTimeUs)
+{
+    if (taskHeapDirty) {
+        taskHeapBuild();
+    }
+
+    while (taskHeapSize > 0 && cmpTimeUs(currentTimeUs, taskDueAtUs(taskHeapArray[0])) >= 0) {
+        taskReadyInsert(taskHeapPop());
+    }
+}
+
+// Return an executed time-driven task to the heap until it is due again
+static FAST_CODE void taskHeapRequeue(task_t *task)
+{
+    if (!taskHeapDirty && !task->attribute->checkFunc) {
+        taskReadyRemove(task);
+        taskHeapPush(task);
+    }
+}
+#endif
+
 void taskSystemLoad(timeUs_t currentTimeUs)
 {
     static timeUs_t lastExecutedAtUs;
@@ -260,6 +412,13 @@ void rescheduleTask(taskId_e taskId, timeDelta_t newPeriodUs)
     }
     task->attribute->desiredPeriodUs = MAX(SCHEDULER_DELAY_LIMIT, newPeriodUs);  // Limit delay to 100us (10 kHz) to prevent scheduler clogging
 
+#if defined(USE_SCHEDULER_HEAP)
+    // The running task is put back into the heap with its new period after it returns
+    if (task != currentTask) {
+        taskHeapDirty = true;
+    }
+#endif
+
     // Catch the case where the gyro loop is adjusted
     if (taskId == TASK_GYRO) {
         desiredPeriodCycles = (int32_t)clockMicrosToCycles((uint32_t)getTask(TASK_GYRO)->attribute->desiredPeriodUs);
@@ -406,9 +565,24 @@ FAST_CODE timeUs_t schedulerExecuteTask(task_t *selectedTask, timeUs_t currentTi
 
         // Execute task
         const timeUs_t currentTimeBeforeTaskCallUs = micros();
+#if defined(USE_SCHEDULER_TRACE)
+        const uint32_t traceStartCycles = getCycleCounter();
+#endif
         selectedTask->attribute->taskFunc(currentTimeBeforeTaskCallUs);
+#if defined(USE_SCHEDULER_TRACE)
+        const uint32_t traceEndCycles = getCycleCounter();
+#endif
         const timeUs_t currentTimeAfterTaskCallUs = micros();
 
+#if defined(USE_SCHEDULER_TRACE)
+        schedulerTraceEvent_t *event = &traceEvents[traceHead & (SCHEDULER_TRACE_SIZE - 1)];
+        event->taskId = selectedTask - tasks;
+        event->startUs = currentTimeBeforeTaskCallUs;
+        event->duration10thUs = MIN(clockCyclesTo10thMicros(traceEndCycles - traceStartCycles), UINT16_MAX);
+        event->margin10thUs = constrain(clockCyclesTo10thMicros(cmpTimeCycles(traceDeadlineCycles, traceStartCycles)), 0, UINT16_MAX);
+        traceHead++;
+#endif
+
         taskExecutionTimeUs = currentTimeAfterTaskCallUs - currentTimeBeforeTaskCallUs;
         taskTotalExecutionTime += taskExecutionTimeUs;
 
@@ -511,12 +685,17 @@ FAST_CODE void scheduler(void)
             if (schedLoopStartCycles > schedLoopStartMinCycles) {
                 schedLoopStartCycles -= schedLoopStartDeltaDownCycles;
             }
-#if !defined(UNIT_TEST)
+#if !defined(UNIT_TEST) && !defined(SIMULATOR_LOCKSTEP)
+            // In lockstep the clock only advances between scheduler runs
             while (schedLoopRemainingCycles > 0) {
                 nowCycles = getCycleCounter();
                 schedLoopRemainingCycles = cmpTimeCycles(nextTargetCycles, nowCycles);
             }
             DEBUG_SET(DEBUG_SCHEDULER_DETERMINISM, 0, clockCyclesTo10thMicros(cmpTimeCycles(nowCycles, lastTargetCycles)));
+#endif
+#if defined(USE_SCHEDULER_TRACE)
+            // The realtime tasks must complete before the next gyro cycle is due
+            traceDeadlineCycles = nextTargetCycles + desiredPeriodCycles;
 #endif
             currentTimeUs = micros();
             taskExecutionTimeUs += schedulerExecuteTask(gyroTask, currentTimeUs);
@@ -620,7 +799,14 @@ FAST_CODE void scheduler(void)
         currentTimeUs = micros();
 
         // Update task dynamic priorities
+#if defined(USE_SCHEDULER_HEAP)
+        taskHeapUpdate(currentTimeUs);
+
+        for (int ii = 0; ii < taskReadyCount; ii++) {
+            task_t *task = taskReadyArray[ii];
+#else
         for (task_t *task = queueFirst(); task != NULL; task = queueNext()) {
+#endif
             if (task->attribute->staticPriority != TASK_PRIORITY_REALTIME) {
                 // Task has checkFunc - event driven
                 if (task->attribute->checkFunc) {
@@ -693,8 +879,14 @@ FAST_CODE void scheduler(void)
 
             if (!gyroEnabled || (taskRequiredTimeCycles < schedLoopRemainingCycles)) {
                 uint32_t antipatedEndCycles = nowCycles + taskRequiredTimeCycles;
+#if defined(USE_SCHEDULER_TRACE)
+                traceDeadlineCycles = gyroEnabled ? nextTargetCycles : nowCycles;
+#endif
                 taskExecutionTimeUs += schedulerExecuteTask(selectedTask, currentTimeUs);
                 nowCycles = getCycleCounter();
+#if defined(USE_SCHEDULER_HEAP)
+                taskHeapRequeue(selectedTask);
+#endif
                 int32_t cyclesOverdue = cmpTimeCycles(nowCycles, antipatedEndCycles);
 
 #if defined(USE_LATE_TASK_STATISTICS)
@@ -751,6 +943,26 @@ FAST_CODE void scheduler(void)
     scheduleCount++;
 }
 
+#if defined(USE_SCHEDULER_TRACE)
+uint32_t schedulerTraceHead(void)
+{
+    return traceHead;
+}
+
+// Returns false if the event has not been recorded yet or has already been overwritten
+bool schedulerTraceRead(uint32_t seq, schedulerTraceEvent_t *event)
+{
+    if ((uint32_t)(traceHead - seq - 1) >= SCHEDULER_TRACE_SIZE) {
+        return false;
+    }
+
+    *event = traceEvents[seq & (SCHEDULER_TRACE_SIZE - 1)];
+
+    // Check that the producer didn't overwrite the event while it was copied
+    return (uint32_t)(traceHead - seq) <= SCHEDULER_TRACE_SIZE;
+}
+#endif
+
 void schedulerEnableGyro(void)
 {
     gyroEnabled = true;
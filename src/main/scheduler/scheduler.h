@@ -57,6 +57,11 @@
 #define GYRO_RATE_COUNT 10000
 #define GYRO_LOCK_COUNT 50
 
+// Number of task invocations kept in the trace ring, must be a power of two
+#ifndef SCHEDULER_TRACE_SIZE
+#define SCHEDULER_TRACE_SIZE 256
+#endif
+
 typedef enum {
     TASK_PRIORITY_REALTIME = -1, // Task will be run outside the scheduler logic
     TASK_PRIORITY_LOWEST = 1,
@@ -222,6 +227,18 @@ typedef struct {
 #endif
 } task_t;
 
+#if defined(USE_SCHEDULER_TRACE)
+typedef struct {
+    timeUs_t startUs;
+    uint16_t duration10thUs;
+    uint16_t margin10thUs;              // time left to the task's gyro cycle deadline when it started
+    uint8_t  taskId;
+} schedulerTraceEvent_t;
+
+uint32_t schedulerTraceHead(void);
+bool schedulerTraceRead(uint32_t seq, schedulerTraceEvent_t *event);
+#endif
+
 void getCheckFuncInfo(cfCheckFuncInfo_t *checkFuncInfo);
 void getTaskInfo(taskId_e taskId, taskInfo_t *taskInfo);
 void rescheduleTask(taskId_e taskId, timeDelta_t newPeriodUs);
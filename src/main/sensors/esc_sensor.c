@@ -140,6 +140,10 @@ static volatile uint8_t bufferPos = 0;
 
 static volatile uint8_t readBytes = 0;
 static volatile uint8_t readIngoreBytes = 0;
+
+static uint8_t rxChunk[32];
+static uint8_t rxChunkSize = 0;
+static uint8_t rxChunkPos = 0;
 static uint32_t syncCount = 0;
 
 static uint8_t reqLength = 0;
@@ -165,6 +169,21 @@ static void paramEscNeedRestart(void)
     escSensorData[0].id = ESC_SIG_RESTART;
 }
 
+// Fetch received bytes from the port in bulk, hand them out one at a time
+static bool escSensorReadByte(uint8_t *data)
+{
+    if (rxChunkPos >= rxChunkSize) {
+        rxChunkSize = serialReadBuf(escSensorPort, rxChunk, sizeof(rxChunk));
+        rxChunkPos = 0;
+        if (rxChunkSize == 0) {
+            return false;
+        }
+    }
+
+    *data = rxChunk[rxChunkPos++];
+    return true;
+}
+
 
 bool isEscSensorActive(void)
 {
@@ -639,9 +658,11 @@ static uint8_t processHW4TelemetryStream(uint8_t dataByte)
 
 static void hw4SensorProcess(timeUs_t currentTimeUs)
 {
+    uint8_t data;
+
     // check for any available bytes in the rx buffer
-    while (serialRxBytesWaiting(escSensorPort)) {
-        const uint8_t frameType = processHW4TelemetryStream(serialRead(escSensorPort));
+    while (escSensorReadByte(&data)) {
+        const uint8_t frameType = processHW4TelemetryStream(data);
 
         if (frameType == HW4_FRAME_DATA) {
             if (buffer[4] < 4 && buffer[6] < 4 && buffer[11] < 0x10 &&
@@ -880,9 +901,11 @@ static bool processKontronikTelemetryStream(uint8_t dataByte)
 
 static void kontronikSensorProcess(timeUs_t currentTimeUs)
 {
+    uint8_t data;
+
     // check for any available bytes in the rx buffer
-    while (serialRxBytesWaiting(escSensorPort)) {
-        if (processKontronikTelemetryStream(serialRead(escSensorPort))) {
+    while (escSensorReadByte(&data)) {
+        if (processKontronikTelemetryStream(data)) {
             uint32_t crc = kontronikDecodeCRC(kontronikPacketLength - KON_CRC_LENGTH);
             if (calculateCRC32(buffer, kontronikPacketLength - kontronikCrcExclude - KON_CRC_LENGTH) == crc) {
                 uint32_t rpm = buffer[7] << 24 | buffer[6] << 16 | buffer[5] << 8 | buffer[4];
@@ -999,9 +1022,11 @@ static bool processOMPTelemetryStream(uint8_t dataByte)
 
 static void ompSensorProcess(timeUs_t currentTimeUs)
 {
+    uint8_t data;
+
     // check for any available bytes in the rx buffer
-    while (serialRxBytesWaiting(escSensorPort)) {
-        if (processOMPTelemetryStream(serialRead(escSensorPort))) {
+    while (escSensorReadByte(&data)) {
+        if (processOMPTelemetryStream(data)) {
             // Make sure this is OMP M4 ESC
             if (buffer[1] == 0x01 && buffer[2] == 0x20 && buffer[11] == 0 && buffer[18] == 0 && buffer[20] == 0) {
                 uint16_t rpm = buffer[8] << 8 | buffer[9];
@@ -1121,9 +1146,11 @@ static bool processZTWTelemetryStream(uint8_t dataByte)
 
 static void ztwSensorProcess(timeUs_t currentTimeUs)
 {
+    uint8_t data;
+
     // check for any available bytes in the rx buffer
-    while (serialRxBytesWaiting(escSensorPort)) {
-        if (processZTWTelemetryStream(serialRead(escSensorPort))) {
+    while (escSensorReadByte(&data)) {
+        if (processZTWTelemetryStream(data)) {
             if (buffer[1] == 0x01 && buffer[2] == 0x20) {
                 uint16_t rpm = buffer[8] << 8 | buffer[9];
                 uint16_t temp = buffer[10];
@@ -1263,9 +1290,11 @@ static bool processAPDTelemetryStream(uint8_t dataByte)
 
 static void apdSensorProcess(timeUs_t currentTimeUs)
 {
+    uint8_t data;
+
     // check for any available bytes in the rx buffer
-    while (serialRxBytesWaiting(escSensorPort)) {
-        if (processAPDTelemetryStream(serialRead(escSensorPort))) {
+    while (escSensorReadByte(&data)) {
+        if (processAPDTelemetryStream(data)) {
             uint16_t crc = buffer[21] << 8 | buffer[20];
 
             if (calculateFletcher16(buffer + 2, 18) == crc) {
@@ -3733,10 +3762,8 @@ static void recordSensorProcess(timeUs_t currentTimeUs)
     UNUSED(currentTimeUs);
 
     // check for any available bytes in the rx buffer
-    while (serialRxBytesWaiting(escSensorPort) && readBytes < 32) {
-        totalByteCount++;
-        buffer[readBytes++] = serialRead(escSensorPort);
-    }
+    readBytes = serialReadBuf(escSensorPort, buffer, 32);
+    totalByteCount += readBytes;
 
     if (readBytes > 0) {
         blackboxLogCustomData(buffer, readBytes);
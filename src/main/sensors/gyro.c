@@ -58,6 +58,7 @@
 #include "sensors/boardalignment.h"
 #include "sensors/gyro.h"
 #include "sensors/gyro_init.h"
+#include "sensors/gyro_integrator.h"
 
 #if ((TARGET_FLASH_SIZE > 128) && (defined(USE_GYRO_SPI_ICM20601) || defined(USE_GYRO_SPI_ICM20689) || defined(USE_GYRO_SPI_MPU6500)))
 #define USE_GYRO_SLEW_LIMITER
@@ -65,6 +66,8 @@
 
 FAST_DATA_ZERO_INIT gyro_t gyro;
 
+static FAST_DATA_ZERO_INIT gyroIntegrator_t gyroIntegrator;
+
 static FAST_DATA_ZERO_INIT bool overflowDetected;
 #ifdef USE_GYRO_OVERFLOW_CHECK
 static FAST_DATA_ZERO_INIT timeUs_t overflowTimeUs;
@@ -376,6 +379,8 @@ FAST_CODE void gyroFiltering(timeUs_t currentTimeUs)
         filterGyroDebug();
     }
 
+    gyroIntegratorUpdate(&gyroIntegrator, gyro.gyroADCf, gyro.filterLooptime * 1e-6f);
+
 #ifdef USE_MULTI_GYRO
     if (gyro.useDualGyroDebugging) {
         switch (gyro.gyroToUse) {
@@ -415,6 +420,18 @@ FAST_CODE void gyroFiltering(timeUs_t currentTimeUs)
 #endif
 }
 
+bool gyroGetAccumulationAverage(float *accumulationAverage)
+{
+    if (gyroIntegratorGetAverage(&gyroIntegrator, accumulationAverage)) {
+        return true;
+    } else {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            accumulationAverage[axis] = 0.0f;
+        }
+        return false;
+    }
+}
+
 int16_t gyroReadSensorTemperature(gyroSensor_t gyroSensor)
 {
     if (gyroSensor.gyroDev.temperatureFn) {
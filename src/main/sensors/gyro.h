@@ -122,7 +122,7 @@ extern uint8_t activeFilterLoopDenom;
 
 void gyroUpdate(void);
 void gyroFiltering(timeUs_t currentTimeUs);
-bool gyroGetAccumulationAverage(float *accumulation);
+bool gyroGetAccumulationAverage(float *accumulationAverage);
 void gyroStartCalibration(bool isFirstArmingCalibration);
 bool isFirstArmingGyroCalibrationRunning(void);
 bool gyroIsCalibrationComplete(void);
@@ -19,6 +19,12 @@
 
 static FAST_CODE void GYRO_FILTER_FUNCTION_NAME(void)
 {
+#ifdef USE_RPM_FILTER
+    // RPM filter processes all axes side by side
+    float gyroADCr[XYZ_AXIS_COUNT] = { gyro.gyroADCd[X], gyro.gyroADCd[Y], gyro.gyroADCd[Z] };
+    rpmFilterGyro(gyroADCr);
+#endif
+
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         // DEBUG_GYRO_RAW records the raw value read from the sensor (not zero offset, not scaled)
         GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_RAW, axis, gyro.rawSensorDev->gyroADCRaw[axis]);
@@ -37,7 +43,7 @@ static FAST_CODE void GYRO_FILTER_FUNCTION_NAME(void)
         GYRO_FILTER_AXIS_DEBUG_SET(axis, DEBUG_GYRO_SAMPLE, 1, lrintf(gyroADCf));
 
 #ifdef USE_RPM_FILTER
-        gyroADCf = rpmFilterGyro(axis, gyroADCf);
+        gyroADCf = gyroADCr[axis];
 #endif
 
         // DEBUG_GYRO_SAMPLE(2) Record the post-RPM Filter value for the selected debug axis
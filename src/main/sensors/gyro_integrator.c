@@ -0,0 +1,89 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Gyro delta angle pre-integrator
+ *
+ * Accumulates the rotation between two attitude updates from every
+ * filtered gyro sample, instead of letting the IMU look at a single
+ * sample only. The delta angles are integrated with the trapezoidal
+ * rule, and the non-commutativity of the rotations (coning) is corrected
+ * with the two-sample algorithm from Savage, "Strapdown Inertial Navigation
+ * Integration Algorithm Design Part 1: Attitude Algorithms".
+ *
+ * The result is handed out as the average rate that yields the same
+ * rotation vector over the integration time.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "sensors/gyro_integrator.h"
+
+
+void gyroIntegratorReset(gyroIntegrator_t *integ)
+{
+    memset(integ, 0, sizeof(*integ));
+}
+
+FAST_CODE void gyroIntegratorUpdate(gyroIntegrator_t *integ, const float *rate, float dt)
+{
+    float delta[XYZ_AXIS_COUNT];
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float value = DEGREES_TO_RADIANS(rate[axis]);
+        delta[axis] = (value + integ->lastRate[axis]) * dt * 0.5f;
+        integ->lastRate[axis] = value;
+    }
+
+    // Coning correction: 0.5 * (alpha + lastDelta/6) x delta
+    const float ax = integ->alpha[X] + integ->lastDelta[X] * (1.0f / 6);
+    const float ay = integ->alpha[Y] + integ->lastDelta[Y] * (1.0f / 6);
+    const float az = integ->alpha[Z] + integ->lastDelta[Z] * (1.0f / 6);
+
+    integ->beta[X] += (ay * delta[Z] - az * delta[Y]) * 0.5f;
+    integ->beta[Y] += (az * delta[X] - ax * delta[Z]) * 0.5f;
+    integ->beta[Z] += (ax * delta[Y] - ay * delta[X]) * 0.5f;
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        integ->alpha[axis] += delta[axis];
+        integ->lastDelta[axis] = delta[axis];
+    }
+
+    integ->time += dt;
+}
+
+bool gyroIntegratorGetAverage(gyroIntegrator_t *integ, float *average)
+{
+    if (integ->time > 0) {
+        const float scale = 1.0f / (M_RADf * integ->time);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            average[axis] = (integ->alpha[axis] + integ->beta[axis]) * scale;
+            integ->alpha[axis] = 0;
+            integ->beta[axis] = 0;
+        }
+        integ->time = 0;
+        return true;
+    }
+
+    return false;
+}
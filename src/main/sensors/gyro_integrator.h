@@ -0,0 +1,34 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "common/axis.h"
+
+typedef struct {
+    float alpha[XYZ_AXIS_COUNT];        // Integrated delta angle [rad]
+    float beta[XYZ_AXIS_COUNT];         // Coning correction [rad]
+    float lastRate[XYZ_AXIS_COUNT];     // Previous rate sample [rad/s]
+    float lastDelta[XYZ_AXIS_COUNT];    // Previous delta angle [rad]
+    float time;                         // Integration time [s]
+} gyroIntegrator_t;
+
+void gyroIntegratorReset(gyroIntegrator_t *integ);
+void gyroIntegratorUpdate(gyroIntegrator_t *integ, const float *rate, float dt);
+bool gyroIntegratorGetAverage(gyroIntegrator_t *integ, float *average);
@@ -54,6 +54,8 @@ const timerHardware_t timerHardware[1]; // unused
 
 #include "rx/rx.h"
 
+#include "sensors/gyro.h"
+
 #include "dyad.h"
 #include "target/SITL/udplink.h"
 
@@ -70,6 +72,13 @@ static udpLink_t stateLink, pwmLink;
 static pthread_mutex_t updateLock;
 static pthread_mutex_t mainLoopLock;
 
+#if defined(SIMULATOR_LOCKSTEP)
+// Simulated time, advanced by one gyro period for every fdm_packet
+static uint64_t lockstepTimeUs;
+static bool lockstepStarted;
+static int lockstepCalls;
+#endif
+
 int timeval_sub(struct timespec *result, struct timespec *x, struct timespec *y);
 
 int lockMainPID(void) {
@@ -82,27 +91,7 @@ int lockMainPID(void) {
 void sendMotorUpdate() {
     udpSend(&pwmLink, &pwmPkt, sizeof(servo_packet));
 }
-void updateState(const fdm_packet* pkt) {
-    static double last_timestamp = 0; // in seconds
-    static uint64_t last_realtime = 0; // in uS
-    static struct timespec last_ts; // last packet
-
-    struct timespec now_ts;
-    clock_gettime(CLOCK_MONOTONIC, &now_ts);
-
-    const uint64_t realtime_now = micros64_real();
-    if (realtime_now > last_realtime + 500*1e3) { // 500ms timeout
-        last_timestamp = pkt->timestamp;
-        last_realtime = realtime_now;
-        sendMotorUpdate();
-        return;
-    }
-
-    const double deltaSim = pkt->timestamp - last_timestamp;  // in seconds
-    if (deltaSim < 0) { // don't use old packet
-        return;
-    }
-
+static void updateSensors(const fdm_packet* pkt) {
     int16_t x,y,z;
     x = constrain(-pkt->imu_linear_acceleration_xyz[0] * ACC_SCALE, -32767, 32767);
     y = constrain(-pkt->imu_linear_acceleration_xyz[1] * ACC_SCALE, -32767, 32767);
@@ -146,6 +135,30 @@ void updateState(const fdm_packet* pkt) {
     imuSetAttitudeQuat(pkt->imu_orientation_quat[0], pkt->imu_orientation_quat[1], pkt->imu_orientation_quat[2], pkt->imu_orientation_quat[3]);
 #endif
 #endif
+}
+
+void updateState(const fdm_packet* pkt) {
+    static double last_timestamp = 0; // in seconds
+    static uint64_t last_realtime = 0; // in uS
+    static struct timespec last_ts; // last packet
+
+    struct timespec now_ts;
+    clock_gettime(CLOCK_MONOTONIC, &now_ts);
+
+    const uint64_t realtime_now = micros64_real();
+    if (realtime_now > last_realtime + 500*1e3) { // 500ms timeout
+        last_timestamp = pkt->timestamp;
+        last_realtime = realtime_now;
+        sendMotorUpdate();
+        return;
+    }
+
+    const double deltaSim = pkt->timestamp - last_timestamp;  // in seconds
+    if (deltaSim < 0) { // don't use old packet
+        return;
+    }
+
+    updateSensors(pkt);
 
 #if defined(SIMULATOR_IMU_SYNC)
     imuSetHasNewData(deltaSim*1e6);
@@ -174,6 +187,34 @@ void updateState(const fdm_packet* pkt) {
 #endif
 }
 
+#if defined(SIMULATOR_LOCKSTEP)
+// Called after every scheduler() run. Every LOCKSTEP_SCHEDULER_CALLS runs
+// the step is complete: the servo_packet is sent back, and the main loop
+// blocks until the next fdm_packet arrives. The packet then advances the
+// simulated time by exactly one gyro period, so the gyro task is due on the
+// first run of the new step and the background tasks get the remaining ones.
+void simulatorLockstepUpdate(void) {
+    if (++lockstepCalls < LOCKSTEP_SCHEDULER_CALLS) {
+        return;
+    }
+    lockstepCalls = 0;
+
+    if (lockstepStarted) {
+        sendMotorUpdate();
+    }
+
+    while (udpRecv(&stateLink, &fdmPkt, sizeof(fdm_packet), 100) != sizeof(fdm_packet)) {
+        if (!workerRunning) {
+            return;
+        }
+    }
+    lockstepStarted = true;
+
+    updateSensors(&fdmPkt);
+
+    lockstepTimeUs += gyro.sampleLooptime ? gyro.sampleLooptime : TASK_GYROPID_DESIRED_PERIOD;
+}
+#else
 static void* udpThread(void* data) {
     UNUSED(data);
     int n = 0;
@@ -189,6 +230,7 @@ static void* udpThread(void* data) {
     printf("udpThread end!!\n");
     return NULL;
 }
+#endif
 
 static void* tcpThread(void* data) {
     UNUSED(data);
@@ -237,11 +279,16 @@ void systemInit(void) {
     ret = udpInit(&stateLink, NULL, 9003, true);
     printf("start UDP server...%d\n", ret);
 
+#if defined(SIMULATOR_LOCKSTEP)
+    UNUSED(udpWorker);
+    printf("lockstep mode, waiting for simulator\n");
+#else
     ret = pthread_create(&udpWorker, NULL, udpThread, NULL);
     if (ret != 0) {
         printf("Create udpWorker error!\n");
         exit(1);
     }
+#endif
 
     // serial can't been slow down
     rescheduleTask(TASK_SERIAL, 1);
@@ -251,7 +298,9 @@ void systemResetHard(void){
     printf("[system]Reset!\n");
     workerRunning = false;
     pthread_join(tcpWorker, NULL);
+#if !defined(SIMULATOR_LOCKSTEP)
     pthread_join(udpWorker, NULL);
+#endif
     exit(0);
 }
 
@@ -293,6 +342,15 @@ uint64_t millis64_real() {
     return 1.0e3*((ts.tv_sec + (ts.tv_nsec*1.0e-9)) - (start_time.tv_sec + (start_time.tv_nsec*1.0e-9)));
 }
 
+#if defined(SIMULATOR_LOCKSTEP)
+uint64_t micros64() {
+    return lockstepTimeUs;
+}
+
+uint64_t millis64() {
+    return lockstepTimeUs / 1000;
+}
+#else
 uint64_t micros64() {
     static uint64_t last = 0;
     static uint64_t out = 0;
@@ -316,6 +374,7 @@ uint64_t millis64() {
     return out*1e-6;
 //    return millis64_real();
 }
+#endif
 
 uint32_t micros(void) {
     return micros64() & 0xFFFFFFFF;
@@ -351,20 +410,31 @@ void microsleep(uint32_t usec) {
     while (nanosleep(&ts, &ts) == -1 && errno == EINTR) ;
 }
 
+#if defined(SIMULATOR_LOCKSTEP)
+// Simulated time only moves by packets and by explicit delays
+void delayMicroseconds(uint32_t us) {
+    lockstepTimeUs += us;
+}
+#else
 void delayMicroseconds(uint32_t us) {
     microsleep(us / simRate);
 }
+#endif
 
 void delayMicroseconds_real(uint32_t us) {
     microsleep(us);
 }
 
 void delay(uint32_t ms) {
+#if defined(SIMULATOR_LOCKSTEP)
+    lockstepTimeUs += ms * 1000ULL;
+#else
     uint64_t start = millis64();
 
     while ((millis64() - start) < ms) {
         microsleep(1000);
     }
+#endif
 }
 
 // Subtract the ‘struct timespec’ values X and Y,  storing the result in RESULT.
@@ -465,9 +535,11 @@ static void pwmCompleteMotorUpdate(void)
     pwmPkt.motor_speed[1] = motorsPwm[2] / outScale;
     pwmPkt.motor_speed[2] = motorsPwm[3] / outScale;
 
+#if !defined(SIMULATOR_LOCKSTEP)
     // get one "fdm_packet" can only send one "servo_packet"!!
     if (pthread_mutex_trylock(&updateLock) != 0) return;
     udpSend(&pwmLink, &pwmPkt, sizeof(servo_packet));
+#endif
 //    printf("[pwm]%u:%u,%u,%u,%u\n", idlePulse, motorsPwm[0], motorsPwm[1], motorsPwm[2], motorsPwm[3]);
 }
 
@@ -40,6 +40,16 @@
 //#define SIMULATOR_IMU_SYNC
 //#define SIMULATOR_GYROPID_SYNC
 
+// deterministic mode, time is advanced by the simulator packets only
+//#define SIMULATOR_LOCKSTEP
+
+#if defined(SIMULATOR_LOCKSTEP)
+#if defined(SIMULATOR_IMU_SYNC) || defined(SIMULATOR_GYROPID_SYNC)
+#error "SIMULATOR_LOCKSTEP can't be combined with the SYNC modes"
+#endif
+#define LOCKSTEP_SCHEDULER_CALLS        8
+#endif
+
 // file name to save config
 #define EEPROM_FILENAME "eeprom.bin"
 #define CONFIG_IN_FILE
@@ -259,5 +269,6 @@ uint64_t micros64(void);
 uint64_t millis64(void);
 
 int lockMainPID(void);
+void simulatorLockstepUpdate(void);
 
 
@@ -284,6 +284,10 @@
 #undef USE_USB_MSC
 #endif
 
+#if !defined(USE_FLASHFS) || !defined(USE_BLACKBOX)
+#undef USE_BLACKBOX_LOGDIR
+#endif
+
 #if (!defined(USE_FLASHFS) || !defined(USE_RTC_TIME) || !defined(USE_USB_MSC) || !defined(USE_PERSISTENT_OBJECTS))
 #undef USE_PERSISTENT_MSC_RTC
 #endif
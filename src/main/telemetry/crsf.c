@@ -345,7 +345,7 @@ static void crsfFrameGps(sbuf_t *dst)
     sbufWriteS32BE(dst, gpsSol.llh.lon);
     sbufWriteU16BE(dst, (gpsSol.groundSpeed * 36 + 50) / 100); // cm/s
     sbufWriteU16BE(dst, gpsSol.groundCourse * 10); // degrees * 10
-    sbufWriteU16BE(dst, getEstimatedAltitudeCm() / 100 + 1000);
+    sbufWriteU16BE(dst, telemetryGetValue(TELEM_ALTITUDE) / 100 + 1000);
     sbufWriteU8(dst, gpsSol.numSat);
 }
 
@@ -357,7 +357,7 @@ static void crsfFrameGps(sbuf_t *dst)
 static void crsfFrameVarioSensor(sbuf_t *dst)
 {
     sbufWriteU8(dst, CRSF_FRAMETYPE_VARIO_SENSOR);
-    sbufWriteS16BE(dst, getEstimatedVarioCms());
+    sbufWriteS16BE(dst, telemetryGetValue(TELEM_VARIOMETER));
 }
 
 /*
@@ -373,8 +373,8 @@ static void crsfFrameBatterySensor(sbuf_t *dst)
     sbufWriteU8(dst, CRSF_FRAMETYPE_BATTERY_SENSOR);
     sbufWriteU16BE(dst, getLegacyBatteryVoltage());
     sbufWriteU16BE(dst, getLegacyBatteryCurrent());
-    sbufWriteU24BE(dst, getBatteryCapacityUsed());
-    sbufWriteU8(dst, calculateBatteryPercentageRemaining());
+    sbufWriteU24BE(dst, telemetryGetValue(TELEM_BATTERY_CONSUMPTION));
+    sbufWriteU8(dst, telemetryGetValue(TELEM_BATTERY_CHARGE_LEVEL));
 }
 
 /*
@@ -386,8 +386,8 @@ static void crsfFrameBatterySensor(sbuf_t *dst)
 static void crsfFrameAltitudeSensor(sbuf_t *dst)
 {
     sbufWriteU8(dst, CRSF_FRAMETYPE_ALTITUDE_SENSOR);
-    sbufWriteU16BE(dst, getEstimatedAltitudeCm() / 10 + 10000);
-    sbufWriteS16BE(dst, getEstimatedVarioCms());
+    sbufWriteU16BE(dst, telemetryGetValue(TELEM_ALTITUDE) / 10 + 10000);
+    sbufWriteS16BE(dst, telemetryGetValue(TELEM_VARIOMETER));
 }
 
 /*
@@ -592,7 +592,7 @@ void crsfSensorEncodeCellVolt(telemetrySensor_t *sensor, sbuf_t *buf)
 void crsfSensorEncodeCells(telemetrySensor_t *sensor, sbuf_t *buf)
 {
     UNUSED(sensor);
-    const int cells = MIN(getBatteryCellCount(), 16);
+    const int cells = MIN(telemetryGetValue(TELEM_BATTERY_CELL_COUNT), 16);
     sbufWriteU8(buf, cells);
     for (int i = 0; i < cells; i++) {
         int volt = constrain(getBatteryCellVoltage(i), 200, 455) - 200;
@@ -692,6 +692,8 @@ static telemetrySensor_t crsfNativeTelemetrySensors[] =
     TLM_SENSOR(GPS,                 0,  100,  100,  0,  Nil),
 };
 
+STATIC_ASSERT(ARRAYLEN(crsfNativeTelemetrySensors) <= TELEM_SCHEDULE_QUEUE_SIZE, crsf_native_sensor_table_too_large);
+
 static telemetrySensor_t crsfCustomTelemetrySensors[] =
 {
     TLM_SENSOR(NONE,                    0x1000,  1000,  1000,    0,     Nil),
@@ -802,6 +804,8 @@ static telemetrySensor_t crsfCustomTelemetrySensors[] =
     TLM_SENSOR(DEBUG_7,                 0xDB07,   100,  3000,    0,     S32),
 };
 
+STATIC_ASSERT(ARRAYLEN(crsfCustomTelemetrySensors) <= TELEM_SCHEDULE_QUEUE_SIZE, crsf_custom_sensor_table_too_large);
+
 telemetrySensor_t * crsfGetNativeSensor(sensor_id_e id)
 {
     for (size_t i = 0; i < ARRAYLEN(crsfNativeTelemetrySensors); i++) {
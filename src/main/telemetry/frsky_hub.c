@@ -185,7 +185,7 @@ static void sendAccel(void)
 
 static void sendHeadSpeed(void)
 {
-    frSkyHubWriteFrame(ID_RPM, getHeadSpeed());
+    frSkyHubWriteFrame(ID_RPM, telemetryGetValue(TELEM_HEADSPEED));
 }
 
 static void sendTemperature1(void)
@@ -333,7 +333,7 @@ static void sendVoltageCells(void)
 {
     static uint16_t currentCell;
     uint32_t cellVoltage = 0;
-    const uint8_t cellCount = getBatteryCellCount();
+    const uint8_t cellCount = telemetryGetValue(TELEM_BATTERY_CELL_COUNT);
 
     if (cellCount) {
         currentCell %= cellCount;
@@ -348,7 +348,7 @@ static void sendVoltageCells(void)
         * The actual value sent for cell voltage has resolution of 0.002 volts
         * Since vbat has resolution of 0.1 volts it has to be multiplied by 50
         */
-        cellVoltage = ((uint32_t)getBatteryVoltage() * 100 + cellCount) / (cellCount * 2);
+        cellVoltage = ((uint32_t)telemetryGetValue(TELEM_BATTERY_VOLTAGE) * 100 + cellCount) / (cellCount * 2);
     } else {
         currentCell = 0;
     }
@@ -373,7 +373,7 @@ static void sendVoltageCells(void)
 static void sendVoltageAmp(void)
 {
     uint16_t voltage = getLegacyBatteryVoltage();
-    const uint8_t cellCount = getBatteryCellCount();
+    const uint8_t cellCount = telemetryGetValue(TELEM_BATTERY_CELL_COUNT);
 
     if (telemetryConfig()->frsky_vfas_precision == FRSKY_VFAS_PRECISION_HIGH) {
         // Use new ID 0x39 to send voltage directly in 0.1 volts resolution
@@ -402,9 +402,9 @@ static void sendFuelLevel(void)
 {
     int16_t data;
     if (batteryConfig()->batteryCapacity > 0) {
-        data = (uint16_t)calculateBatteryPercentageRemaining();
+        data = (uint16_t)telemetryGetValue(TELEM_BATTERY_CHARGE_LEVEL);
     } else {
-        data = (uint16_t)constrain(getBatteryCapacityUsed(), 0, 0xFFFF);
+        data = (uint16_t)constrain(telemetryGetValue(TELEM_BATTERY_CONSUMPTION), 0, 0xFFFF);
     }
     frSkyHubWriteFrame(ID_FUEL_LEVEL, data);
 }
@@ -516,13 +516,13 @@ void processFrSkyHubTelemetry(timeUs_t currentTimeUs)
         // Unit is cm/s
 #ifdef USE_VARIO
         if (telemetryIsSensorEnabled(SENSOR_VARIO)) {
-            frSkyHubWriteFrame(ID_VERT_SPEED, getEstimatedVarioCms());
+            frSkyHubWriteFrame(ID_VERT_SPEED, telemetryGetValue(TELEM_VARIOMETER));
         }
 #endif
 
         // Sent every 500ms
         if ((cycleNum % 4) == 0 && telemetryIsSensorEnabled(SENSOR_ALTITUDE)) {
-            int32_t altitudeCm = getEstimatedAltitudeCm();
+            int32_t altitudeCm = telemetryGetValue(TELEM_ALTITUDE);
 
             /* Allow 5s to boot correctly othervise send zero to prevent OpenTX
              * sensor lost notifications after warm boot. */
@@ -98,13 +98,13 @@ void ghstFramePackTelemetry(sbuf_t *dst)
     sbufWriteU8(dst, 0x23);                     // GHST_DL_PACK_STAT
 
     if (telemetryConfig()->report_cell_voltage) {
-        sbufWriteU16(dst, getBatteryAverageCellVoltage());      // units of 10mV
+        sbufWriteU16(dst, telemetryGetValue(TELEM_BATTERY_CELL_VOLTAGE));      // units of 10mV
     } else {
-        sbufWriteU16(dst, getBatteryVoltage());
+        sbufWriteU16(dst, telemetryGetValue(TELEM_BATTERY_VOLTAGE));
     }
-    sbufWriteU16(dst, getBatteryCurrent());                           // units of 10mA
+    sbufWriteU16(dst, telemetryGetValue(TELEM_BATTERY_CURRENT));                           // units of 10mA
 
-    sbufWriteU16(dst, getBatteryCapacityUsed() / 10);                      // units of 10mAh (range of 0-655.36Ah)
+    sbufWriteU16(dst, telemetryGetValue(TELEM_BATTERY_CONSUMPTION) / 10);                      // units of 10mAh (range of 0-655.36Ah)
 
     sbufWriteU8(dst, 0x00);                     // Rx Voltage, units of 100mV (not passed from BF, added in Ghost Rx)
 
@@ -166,7 +166,7 @@ void ghstFrameMagBaro(sbuf_t *dst)
 
 #ifdef USE_VARIO
     if (sensors(SENSOR_VARIO) && telemetryIsSensorEnabled(SENSOR_VARIO)) {
-        vario = getEstimatedVarioCms();       // vario, cm/s
+        vario = telemetryGetValue(TELEM_VARIOMETER);       // vario, cm/s
         flags |= MISC_FLAGS_VARIO;
     }
 #endif
@@ -174,7 +174,7 @@ void ghstFrameMagBaro(sbuf_t *dst)
 #ifdef USE_BARO
     if (sensors(SENSOR_BARO) && telemetryIsSensorEnabled(SENSOR_ALTITUDE)) {
         flags |= MISC_FLAGS_BAROALT;
-        altitude = (constrain(getEstimatedAltitudeCm(), -32000 * 100, 32000 * 100) / 100);
+        altitude = (constrain(telemetryGetValue(TELEM_ALTITUDE), -32000 * 100, 32000 * 100) / 100);
     }
 #endif
 
@@ -211,7 +211,7 @@ static void setIbusSensorType(ibusAddress_t address)
 
 static uint16_t getVoltage()
 {
-    return (telemetryConfig()->report_cell_voltage ? getBatteryAverageCellVoltage() : getBatteryVoltage());
+    return (telemetryConfig()->report_cell_voltage ? telemetryGetValue(TELEM_BATTERY_CELL_VOLTAGE) : telemetryGetValue(TELEM_BATTERY_VOLTAGE));
 }
 
 static uint16_t getTemperature()
@@ -230,16 +230,16 @@ static uint16_t getFuel()
 {
     uint16_t fuel = 0;
     if (batteryConfig()->batteryCapacity > 0) {
-        fuel = (uint16_t)calculateBatteryPercentageRemaining();
+        fuel = (uint16_t)telemetryGetValue(TELEM_BATTERY_CHARGE_LEVEL);
     } else {
-        fuel = (uint16_t)constrain(getBatteryCapacityUsed(), 0, 0xFFFF);
+        fuel = (uint16_t)constrain(telemetryGetValue(TELEM_BATTERY_CONSUMPTION), 0, 0xFFFF);
     }
     return fuel;
 }
 
 static uint16_t getRPM()
 {
-    return getHeadSpeed();
+    return telemetryGetValue(TELEM_HEADSPEED);
 }
 
 static uint16_t getMode()
@@ -368,7 +368,7 @@ static void setValue(uint8_t* bufferPtr, uint8_t sensorType, uint8_t length)
             value.uint16 = getTemperature();
             break;
         case IBUS_SENSOR_TYPE_RPM_FLYSKY:
-            value.int16 = getHeadSpeed();
+            value.int16 = telemetryGetValue(TELEM_HEADSPEED);
             break;
         case IBUS_SENSOR_TYPE_FUEL:
             value.uint16 = getFuel();
@@ -380,10 +380,10 @@ static void setValue(uint8_t* bufferPtr, uint8_t sensorType, uint8_t length)
             value.uint16 = getMode();
             break;
         case IBUS_SENSOR_TYPE_CELL:
-            value.uint16 = (uint16_t)(getBatteryAverageCellVoltage());
+            value.uint16 = (uint16_t)(telemetryGetValue(TELEM_BATTERY_CELL_VOLTAGE));
             break;
         case IBUS_SENSOR_TYPE_BAT_CURR:
-            value.uint16 = (uint16_t)getBatteryCurrent();
+            value.uint16 = (uint16_t)telemetryGetValue(TELEM_BATTERY_CURRENT);
             break;
 #if defined(USE_ACC)
         case IBUS_SENSOR_TYPE_ACC_X:
@@ -407,13 +407,13 @@ static void setValue(uint8_t* bufferPtr, uint8_t sensorType, uint8_t length)
 #ifdef USE_VARIO
         case IBUS_SENSOR_TYPE_VERTICAL_SPEED:
         case IBUS_SENSOR_TYPE_CLIMB_RATE:
-            value.int16 = (int16_t) constrain(getEstimatedVarioCms(), SHRT_MIN, SHRT_MAX);
+            value.int16 = (int16_t) constrain(telemetryGetValue(TELEM_VARIOMETER), SHRT_MIN, SHRT_MAX);
             break;
 #endif
 #ifdef USE_BARO
         case IBUS_SENSOR_TYPE_ALT:
         case IBUS_SENSOR_TYPE_ALT_MAX:
-            value.int32 = getEstimatedAltitudeCm();
+            value.int32 = telemetryGetValue(TELEM_ALTITUDE);
             break;
         case IBUS_SENSOR_TYPE_PRES:
             value.uint32 = baro.baroPressure | (((uint32_t)getTemperature()) << 19);
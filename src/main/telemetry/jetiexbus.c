@@ -354,19 +354,19 @@ int32_t getSensorValue(uint8_t sensor)
         break;
 
     case EX_CURRENT:
-        return getBatteryCurrent();
+        return telemetryGetValue(TELEM_BATTERY_CURRENT);
         break;
 
     case EX_ALTITUDE:
-        return getEstimatedAltitudeCm();
+        return telemetryGetValue(TELEM_ALTITUDE);
         break;
 
     case EX_CAPACITY:
-        return getBatteryCapacityUsed();
+        return telemetryGetValue(TELEM_BATTERY_CONSUMPTION);
         break;
 
     case EX_POWER:
-        return (getBatteryVoltage() * getBatteryCurrent() / 1000);
+        return (telemetryGetValue(TELEM_BATTERY_VOLTAGE) * telemetryGetValue(TELEM_BATTERY_CURRENT) / 1000);
         break;
 
     case EX_ROLL_ANGLE:
@@ -383,7 +383,7 @@ int32_t getSensorValue(uint8_t sensor)
 
 #ifdef USE_VARIO
     case EX_VARIO:
-        return getEstimatedVarioCms();
+        return telemetryGetValue(TELEM_VARIOMETER);
         break;
 #endif
 
@@ -145,7 +145,7 @@ static void ltm_gframe(void)
     ltm_serialise_32(gpsSol.llh.lat);
     ltm_serialise_32(gpsSol.llh.lon);
     ltm_serialise_8((uint8_t)(gpsSol.groundSpeed / 100));
-    ltm_alt = getEstimatedAltitudeCm();
+    ltm_alt = telemetryGetValue(TELEM_ALTITUDE);
     ltm_serialise_32(ltm_alt);
     ltm_serialise_8((gpsSol.numSat << 2) | gps_fix_type);
     ltm_finalise();
@@ -182,8 +182,8 @@ static void ltm_sframe(void)
     if (failsafeIsActive())
         lt_statemode |= 2;
     ltm_initialise_packet('S');
-    ltm_serialise_16(getBatteryVoltage() * 10); // vbat converted to mV
-    ltm_serialise_16((uint16_t)constrain(getBatteryCapacityUsed(), 0, UINT16_MAX)); // consumption in mAh (65535 mAh max)
+    ltm_serialise_16(telemetryGetValue(TELEM_BATTERY_VOLTAGE) * 10); // vbat converted to mV
+    ltm_serialise_16((uint16_t)constrain(telemetryGetValue(TELEM_BATTERY_CONSUMPTION), 0, UINT16_MAX)); // consumption in mAh (65535 mAh max)
     ltm_serialise_8(constrain(scaleRange(getRssi(), 0, RSSI_MAX_VALUE, 0, 255), 0, 255));        // scaled RSSI (uchar)
     ltm_serialise_8(0);              // no airspeed
     ltm_serialise_8((lt_flightmode << 2) | lt_statemode);
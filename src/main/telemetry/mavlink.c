@@ -138,7 +138,7 @@ static int16_t headingOrScaledMilliAmpereHoursDrawn(void)
 {
     if (isBatteryCurrentConfigured() && telemetryConfig()->mavlink_mah_as_heading_divisor > 0) {
         // In the Connex Prosight OSD, this goes between 0 and 999, so it will need to be scaled in that range.
-        return getBatteryCapacityUsed() / telemetryConfig()->mavlink_mah_as_heading_divisor;
+        return telemetryGetValue(TELEM_BATTERY_CONSUMPTION) / telemetryConfig()->mavlink_mah_as_heading_divisor;
     }
     // heading Current heading in degrees, in compass units (0..360, 0=north)
     return DECIDEGREES_TO_DEGREES(attitude.values.yaw);
@@ -225,9 +225,9 @@ void mavlinkSendSystemStatus(void)
     int8_t batteryRemaining = 100;
 
     if (getBatteryState() < BATTERY_NOT_PRESENT) {
-        batteryVoltage = isBatteryVoltageConfigured() ? getBatteryVoltage() * 10 : batteryVoltage;
-        batteryAmperage = isBatteryCurrentConfigured() ? getBatteryCurrent() : batteryAmperage;
-        batteryRemaining = isBatteryVoltageConfigured() ? calculateBatteryPercentageRemaining() : batteryRemaining;
+        batteryVoltage = isBatteryVoltageConfigured() ? telemetryGetValue(TELEM_BATTERY_VOLTAGE) * 10 : batteryVoltage;
+        batteryAmperage = isBatteryCurrentConfigured() ? telemetryGetValue(TELEM_BATTERY_CURRENT) : batteryAmperage;
+        batteryRemaining = isBatteryVoltageConfigured() ? telemetryGetValue(TELEM_BATTERY_CHARGE_LEVEL) : batteryRemaining;
     }
 
     mavlink_msg_sys_status_pack(0, 200, &mavMsg,
@@ -351,7 +351,7 @@ void mavlinkSendPosition(void)
         // alt Altitude in 1E3 meters (millimeters) above MSL
         gpsSol.llh.altCm * 10,
         // relative_alt Altitude above ground in meters, expressed as * 1000 (millimeters)
-        getEstimatedAltitudeCm() * 10,
+        telemetryGetValue(TELEM_ALTITUDE) * 10,
         // Ground X Speed (Latitude), expressed as m/s * 100
         0,
         // Ground Y Speed (Longitude), expressed as m/s * 100
@@ -413,7 +413,7 @@ void mavlinkSendHUDAndHeartbeat(void)
     }
 #endif
 
-    mavAltitude = getEstimatedAltitudeCm() / 100.0;
+    mavAltitude = telemetryGetValue(TELEM_ALTITUDE) / 100.0;
 
     mavlink_msg_vfr_hud_pack(0, 200, &mavMsg,
         // airspeed Current airspeed in m/s
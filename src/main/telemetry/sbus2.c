@@ -79,13 +79,13 @@ void handleSbus2Telemetry(timeUs_t currentTimeUs)
 {
     UNUSED(currentTimeUs);
 
-    float voltage = getBatteryVoltage() * 0.01f;
-    float cellVoltage =  getBatteryAverageCellVoltage() * 0.01f;
+    float voltage = telemetryGetValue(TELEM_BATTERY_VOLTAGE) * 0.01f;
+    float cellVoltage =  telemetryGetValue(TELEM_BATTERY_CELL_VOLTAGE) * 0.01f;
     escSensorData_t *escData = getEscSensorData(ESC_SENSOR_COMBINED);
-    float current =  getBatteryCurrent() * 0.01f;
-    float capacity = getBatteryCapacityUsed();
+    float current =  telemetryGetValue(TELEM_BATTERY_CURRENT) * 0.01f;
+    float capacity = telemetryGetValue(TELEM_BATTERY_CONSUMPTION);
     float temperature =  getCoreTemperatureCelsius();
-    uint32_t rpm = getHeadSpeed();
+    uint32_t rpm = telemetryGetValue(TELEM_HEADSPEED);
 
     // 2 slots
     send_voltagef(1, voltage, cellVoltage);
@@ -336,6 +336,61 @@ int telemetrySensorValue(sensor_id_e id)
 }
 
 
+/** Telemetry value snapshot **/
+
+/*
+ * Values shared by all the telemetry protocols. Each value is read at most
+ * once per telemetry cycle, on first use, so the protocols don't compute
+ * the same values again and send consistent values within a cycle.
+ */
+
+typedef struct {
+    int32_t     value;
+    uint16_t    seq;        // incremented when the value changes
+    uint32_t    version;    // snapshot version when the value was read
+} telemetryValue_t;
+
+static telemetryValue_t telemetrySnapshot[TELEM_SENSOR_COUNT];
+
+static uint32_t telemetrySnapshotCycle = 1;
+
+
+void telemetrySnapshotUpdate(void)
+{
+    telemetrySnapshotCycle++;
+}
+
+uint32_t telemetrySnapshotVersion(void)
+{
+    return telemetrySnapshotCycle;
+}
+
+static telemetryValue_t * telemetrySnapshotField(sensor_id_e id)
+{
+    telemetryValue_t * field = &telemetrySnapshot[id];
+
+    if (field->version != telemetrySnapshotCycle) {
+        const int value = telemetrySensorValue(id);
+        if (value != field->value)
+            field->seq++;
+        field->value = value;
+        field->version = telemetrySnapshotCycle;
+    }
+
+    return field;
+}
+
+int telemetryGetValue(sensor_id_e id)
+{
+    return (id < TELEM_SENSOR_COUNT) ? telemetrySnapshotField(id)->value : 0;
+}
+
+uint16_t telemetryGetValueSeq(sensor_id_e id)
+{
+    return (id < TELEM_SENSOR_COUNT) ? telemetrySnapshotField(id)->seq : 0;
+}
+
+
 bool telemetrySensorActive(sensor_id_e id)
 {
     switch (id) {
@@ -26,6 +26,7 @@
 #include "pg/telemetry.h"
 
 #include "common/streambuf.h"
+#include "common/time.h"
 
 #include "flight/motors.h"
 #include "flight/servos.h"
@@ -192,6 +193,10 @@ struct telemetrySensor_s {
     bool                    update;
 
     int                     bucket;
+    timeUs_t                bucket_time;
+
+    timeUs_t                due_time;
+    timeUs_t                check_time;
 
     telemetryEncode_f       encode;
 };
@@ -201,6 +206,15 @@ int telemetrySensorValue(sensor_id_e id);
 bool telemetrySensorActive(sensor_id_e id);
 
 
+/** Telemetry value snapshot **/
+
+void telemetrySnapshotUpdate(void);
+uint32_t telemetrySnapshotVersion(void);
+
+int telemetryGetValue(sensor_id_e id);
+uint16_t telemetryGetValueSeq(sensor_id_e id);
+
+
 /** Legacy sensors **/
 
 typedef enum {
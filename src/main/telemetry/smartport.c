@@ -252,6 +252,8 @@ static telemetrySensor_t smartportTelemetrySensors[] =
     TLM_SENSOR(DEBUG_7,                 0x52F8,   100,  3000,   1,  10,   0,    INT),
 };
 
+STATIC_ASSERT(ARRAYLEN(smartportTelemetrySensors) <= TELEM_SCHEDULE_QUEUE_SIZE, smartport_sensor_table_too_large);
+
 
 void smartPortSendByte(uint8_t c, uint16_t *checksum, serialPort_t *port)
 {
@@ -188,7 +188,7 @@ uint16_t getMotorAveragePeriod(void)
     if (!isRpmSourceActive()) {
         return SPEKTRUM_RPM_UNUSED;
     }
-    rpm = getHeadSpeed();
+    rpm = telemetryGetValue(TELEM_HEADSPEED);
 
     if (rpm > SPEKTRUM_MIN_RPM && rpm < SPEKTRUM_MAX_RPM) {
         period_us = MICROSEC_PER_MINUTE / rpm; // revs/minute -> microSeconds
@@ -215,9 +215,9 @@ bool srxlFrameRpm(sbuf_t *dst, timeUs_t currentTimeUs)
 
     if ( isBatteryVoltageConfigured() ) {
       if (telemetryConfig()->report_cell_voltage) {
-        sbufWriteU16BigEndian(dst, getBatteryAverageCellVoltage()); // Cell voltage is in units of 0.01V
+        sbufWriteU16BigEndian(dst, telemetryGetValue(TELEM_BATTERY_CELL_VOLTAGE)); // Cell voltage is in units of 0.01V
       } else {
-        sbufWriteU16BigEndian(dst, getBatteryVoltage());   // vbat is in units of 0.01V
+        sbufWriteU16BigEndian(dst, telemetryGetValue(TELEM_BATTERY_VOLTAGE));   // vbat is in units of 0.01V
       }
     } else {
       sbufWriteU16(dst, SPEKTRUM_VOLT_UNUSED);   // NA
@@ -425,7 +425,7 @@ typedef struct
 bool srxlFrameFlightPackCurrent(sbuf_t *dst, timeUs_t currentTimeUs)
 {
     uint16_t amps = getLegacyBatteryCurrent();
-    uint16_t mah  = getBatteryCapacityUsed();
+    uint16_t mah  = telemetryGetValue(TELEM_BATTERY_CONSUMPTION);
     static uint16_t sentAmps;
     static uint16_t sentMah;
     static timeUs_t lastTimeSentFPmAh = 0;
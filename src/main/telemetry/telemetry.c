@@ -110,6 +110,8 @@ bool telemetryCheckRxPortShared(const serialPortConfig_t *portConfig, const Seri
 
 void telemetryProcess(timeUs_t currentTime)
 {
+    telemetrySnapshotUpdate();
+
 #ifdef USE_TELEMETRY_FRSKY_HUB
     handleFrSkyHubTelemetry(currentTime);
 #endif
@@ -229,95 +231,303 @@ void INIT_CODE telemetryInit(void)
 
 /** Telemetry scheduling framework **/
 
+/*
+ * Each sensor has a bucket that fills up at the rate of its interval, fast if
+ * the value has changed since it was last sent, slow otherwise. The sensor is
+ * ready to be sent when the bucket reaches zero.
+ *
+ * The buckets are evaluated only when needed, from the level and time of the
+ * last change. The sensors waiting are kept in a queue ordered by the time
+ * their bucket reaches zero, and move to the ready list when it does. Sensors
+ * in slow mode check their value for changes a few times per fast interval,
+ * instead of on every update.
+ *
+ * With use_excess, a waiting sensor is sent early when nothing is ready. The
+ * one needing the least excess per weight is picked, and every bucket is
+ * credited with that excess times its weight. The queue is then re-heaped in
+ * place, and sensors filled up by the credit join the ready list.
+ */
+
+#define TELEM_SCHEDULE_CHECK_RATIO  4
+
 static telemetryScheduler_t sch = INIT_ZERO;
 
 
+static int telemetrySensorInterval(const telemetrySensor_t * sensor)
+{
+    return (sensor->update) ? sensor->fast_interval : sensor->slow_interval;
+}
+
+static int telemetrySensorLevel(const telemetrySensor_t * sensor, timeUs_t currentTime)
+{
+    const timeDelta_t delta = cmpTimeUs(currentTime, sensor->bucket_time);
+    const int interval = telemetrySensorInterval(sensor);
+
+    // Long enough to fill up the bucket from empty. Also catches buckets
+    // not looked at for over half an hour, which are full anyway.
+    if (delta < 0 || delta / interval >= (sch.max_level - sch.min_level) / 1000)
+        return sch.max_level;
+
+    const int level = sensor->bucket + (delta / interval) * 1000 + (delta % interval) * 1000 / interval;
+
+    return constrain(level, sch.min_level, sch.max_level);
+}
+
+static void telemetrySensorRebase(telemetrySensor_t * sensor, timeUs_t currentTime)
+{
+    sensor->bucket = telemetrySensorLevel(sensor, currentTime);
+    sensor->bucket_time = currentTime;
+}
+
+static bool telemetrySensorNeedsCheck(const telemetrySensor_t * sensor)
+{
+    return !sensor->update && sensor->fast_interval != sensor->slow_interval;
+}
+
+static void telemetrySensorRead(telemetrySensor_t * sensor, timeUs_t currentTime)
+{
+    int value = telemetryGetValue(sensor->sensor_id);
+    if (sensor->ratio_den)
+        value = value * sensor->ratio_num / sensor->ratio_den;
+
+    if (value != sensor->value && !sensor->update) {
+        telemetrySensorRebase(sensor, currentTime);
+        sensor->update = true;
+    }
+
+    sensor->value = value;
+}
+
+static timeUs_t telemetrySensorDueTime(const telemetrySensor_t * sensor)
+{
+    const int interval = telemetrySensorInterval(sensor);
+    const int deficit = MAX(-sensor->bucket, 0);
+    const timeUs_t ready = sensor->bucket_time + (deficit / 1000) * interval + ((deficit % 1000) * interval + 999) / 1000;
+
+    if (telemetrySensorNeedsCheck(sensor) && cmpTimeUs(sensor->check_time, ready) < 0)
+        return sensor->check_time;
+
+    return ready;
+}
+
+static bool telemetryQueueBefore(int a, int b)
+{
+    return cmpTimeUs(sch.sensors[sch.queue[a]].due_time, sch.sensors[sch.queue[b]].due_time) < 0;
+}
+
+static void telemetryQueueSwap(int a, int b)
+{
+    const uint8_t tmp = sch.queue[a];
+    sch.queue[a] = sch.queue[b];
+    sch.queue[b] = tmp;
+}
+
+static void telemetryQueueSiftDown(int pos)
+{
+    while (true) {
+        const int left = 2 * pos + 1;
+        const int right = left + 1;
+        int next = pos;
+
+        if (left < sch.queue_count && telemetryQueueBefore(left, next))
+            next = left;
+        if (right < sch.queue_count && telemetryQueueBefore(right, next))
+            next = right;
+        if (next == pos)
+            break;
+
+        telemetryQueueSwap(pos, next);
+        pos = next;
+    }
+}
+
+static void telemetryQueuePush(telemetrySensor_t * sensor)
+{
+    int pos = sch.queue_count++;
+
+    sensor->due_time = telemetrySensorDueTime(sensor);
+    sch.queue[pos] = sensor->index;
+
+    while (pos > 0) {
+        const int parent = (pos - 1) / 2;
+        if (!telemetryQueueBefore(pos, parent))
+            break;
+        telemetryQueueSwap(pos, parent);
+        pos = parent;
+    }
+}
+
+static void telemetryQueuePop(void)
+{
+    sch.queue[0] = sch.queue[--sch.queue_count];
+    telemetryQueueSiftDown(0);
+}
+
+static void telemetryQueueRemove(const telemetrySensor_t * sensor)
+{
+    for (int pos = 0; pos < sch.queue_count; pos++) {
+        if (sch.queue[pos] == sensor->index) {
+            sch.queue[pos] = sch.queue[--sch.queue_count];
+            if (pos < sch.queue_count) {
+                // The moved entry may belong either above or below
+                telemetryQueueSiftDown(pos);
+                while (pos > 0 && telemetryQueueBefore(pos, (pos - 1) / 2)) {
+                    telemetryQueueSwap(pos, (pos - 1) / 2);
+                    pos = (pos - 1) / 2;
+                }
+            }
+            break;
+        }
+    }
+}
+
+static void telemetryReadyPush(telemetrySensor_t * sensor)
+{
+    sch.ready[(sch.ready_head + sch.ready_count++) % TELEM_SCHEDULE_QUEUE_SIZE] = sensor->index;
+}
+
+static void telemetryReadyPop(void)
+{
+    sch.ready_head = (sch.ready_head + 1) % TELEM_SCHEDULE_QUEUE_SIZE;
+    sch.ready_count--;
+}
+
+static void telemetryScheduleSort(telemetrySensor_t * sensor)
+{
+    if (telemetrySensorLevel(sensor, sch.update_time) >= 0)
+        telemetryReadyPush(sensor);
+    else
+        telemetryQueuePush(sensor);
+}
+
+static void telemetryScheduleCredit(uint32_t excess)
+{
+    for (int i = 0; i < sch.ready_count; i++) {
+        telemetrySensor_t * sensor = &sch.sensors[sch.ready[(sch.ready_head + i) % TELEM_SCHEDULE_QUEUE_SIZE]];
+        const uint16_t weight = (sensor->update) ? sensor->fast_weight : sensor->slow_weight;
+        telemetrySensorRebase(sensor, sch.update_time);
+        sensor->bucket += excess * weight;
+    }
+
+    // The due times move by a different amount for each sensor, so pick
+    // out the sensors now ready and restore the heap order in place
+    int count = 0;
+
+    for (int i = 0; i < sch.queue_count; i++) {
+        telemetrySensor_t * sensor = &sch.sensors[sch.queue[i]];
+        const uint16_t weight = (sensor->update) ? sensor->fast_weight : sensor->slow_weight;
+        telemetrySensorRebase(sensor, sch.update_time);
+        sensor->bucket += excess * weight;
+        if (sensor->bucket >= 0) {
+            telemetryReadyPush(sensor);
+        }
+        else {
+            sensor->due_time = telemetrySensorDueTime(sensor);
+            sch.queue[count++] = sch.queue[i];
+        }
+    }
+
+    sch.queue_count = count;
+
+    for (int pos = count / 2 - 1; pos >= 0; pos--)
+        telemetryQueueSiftDown(pos);
+}
+
 void INIT_CODE telemetryScheduleAdd(telemetrySensor_t * sensor)
 {
     if (sensor) {
         sensor->bucket = 0;
+        sensor->bucket_time = sch.update_time;
+        sensor->check_time = sch.update_time;
         sensor->value = 0;
         sensor->update = true;
-        sensor->active = true;
+        if (!sensor->active) {
+            sensor->active = true;
+            telemetryReadyPush(sensor);
+        }
     }
 }
 
 void telemetryScheduleUpdate(timeUs_t currentTime)
 {
-    timeDelta_t delta = cmpTimeUs(currentTime, sch.update_time);
+    sch.update_time = currentTime;
 
-    for (int i = 0; i < sch.sensor_count; i++) {
-        telemetrySensor_t * sensor = &sch.sensors[i];
-        if (sensor->active) {
-            int value = telemetrySensorValue(sensor->sensor_id);
-            if (sensor->ratio_den)
-                value = value * sensor->ratio_num / sensor->ratio_den;
-            sensor->update |= (value != sensor->value);
-            sensor->value = value;
-
-            const int interval = (sensor->update) ? sensor->fast_interval : sensor->slow_interval;
-            sensor->bucket += delta * 1000 / interval;
-            sensor->bucket = constrain(sensor->bucket, sch.min_level, sch.max_level);
+    while (sch.queue_count > 0) {
+        telemetrySensor_t * sensor = &sch.sensors[sch.queue[0]];
+
+        if (cmpTimeUs(sensor->due_time, currentTime) > 0)
+            break;
+
+        if (telemetrySensorNeedsCheck(sensor) && cmpTimeUs(sensor->check_time, currentTime) <= 0) {
+            telemetrySensorRead(sensor, currentTime);
+            sensor->check_time = currentTime + sensor->fast_interval * (1000 / TELEM_SCHEDULE_CHECK_RATIO);
         }
-    }
 
-    sch.update_time = currentTime;
+        if (telemetrySensorLevel(sensor, currentTime) >= 0) {
+            telemetryQueuePop();
+            telemetryReadyPush(sensor);
+        }
+        else {
+            sensor->due_time = telemetrySensorDueTime(sensor);
+            telemetryQueueSiftDown(0);
+        }
+    }
 }
 
 telemetrySensor_t * telemetryScheduleNext(void)
 {
-    int index = sch.start_index;
+    telemetrySensor_t * sensor = NULL;
 
-    for (int i = 0; i < sch.sensor_count; i++) {
-        index = (index + 1) % sch.sensor_count;
-        telemetrySensor_t * sensor = &sch.sensors[index];
-        if (sensor->active && sensor->bucket >= 0)
-            return sensor;
+    if (sch.ready_count > 0) {
+        sensor = &sch.sensors[sch.ready[sch.ready_head]];
     }
-
-    if (sch.use_excess) {
-        telemetrySensor_t * sensor = NULL;
+    else if (sch.use_excess) {
         uint lowest = UINT_MAX;
 
-        for (int i = 0; i < sch.sensor_count; i++) {
-            telemetrySensor_t * iter = &sch.sensors[i];
-            if (iter->active && iter->bucket < 0) {
-                const uint16_t weight = (iter->update) ? iter->fast_weight : iter->slow_weight;
-                if (weight) {
-                    const uint32_t excess = -iter->bucket / weight;
-                    if (excess < lowest) {
-                        lowest = excess;
-                        sensor = iter;
-                    }
+        for (int i = 0; i < sch.queue_count; i++) {
+            telemetrySensor_t * iter = &sch.sensors[sch.queue[i]];
+            const uint16_t weight = (iter->update) ? iter->fast_weight : iter->slow_weight;
+            if (weight) {
+                const uint32_t excess = -telemetrySensorLevel(iter, sch.update_time) / weight;
+                if (excess < lowest) {
+                    lowest = excess;
+                    sensor = iter;
                 }
             }
         }
-
-        return sensor;
     }
 
-    return NULL;
+    if (sensor)
+        telemetrySensorRead(sensor, sch.update_time);
+
+    return sensor;
 }
 
 void telemetryScheduleCommit(telemetrySensor_t * sensor)
 {
     if (sensor) {
-        if (sch.use_excess && sensor->bucket < 0) {
+        const int level = telemetrySensorLevel(sensor, sch.update_time);
+
+        // The sensor is either at the head of the ready list or picked from the queue
+        if (sch.ready_count > 0 && &sch.sensors[sch.ready[sch.ready_head]] == sensor)
+            telemetryReadyPop();
+        else
+            telemetryQueueRemove(sensor);
+
+        if (sch.use_excess && level < 0) {
             const uint32_t weight = (sensor->update) ? sensor->fast_weight : sensor->slow_weight;
-            const uint32_t excess = -sensor->bucket / weight;
-            for (int i = 0; i < sch.sensor_count; i++) {
-                telemetrySensor_t * iter = &sch.sensors[i];
-                if (iter->active) {
-                    const uint16_t weight = (iter->update) ? iter->fast_weight : iter->slow_weight;
-                    iter->bucket += excess * weight;
-                }
-            }
+            const uint32_t excess = -level / weight;
+            telemetrySensorRebase(sensor, sch.update_time);
+            sensor->bucket += excess * weight;
+            telemetryScheduleCredit(excess);
         }
 
-        sensor->bucket = constrain(sensor->bucket - sch.quanta, sch.min_level, sch.max_level);
+        sensor->bucket = constrain(telemetrySensorLevel(sensor, sch.update_time) - sch.quanta, sch.min_level, sch.max_level);
+        sensor->bucket_time = sch.update_time;
+        sensor->check_time = sch.update_time;
         sensor->update = false;
 
-        sch.start_index = sensor->index;
+        telemetryScheduleSort(sensor);
     }
 }
 
@@ -327,7 +537,10 @@ void INIT_CODE telemetryScheduleInit(telemetrySensor_t * sensors, size_t count,
     sch.sensor_count = count;
 
     sch.update_time = 0;
-    sch.start_index = 0;
+
+    sch.queue_count = 0;
+    sch.ready_head = 0;
+    sch.ready_count = 0;
 
     sch.quanta = 1000000;
     sch.max_level = 500000;
@@ -338,6 +551,7 @@ void INIT_CODE telemetryScheduleInit(telemetrySensor_t * sensors, size_t count,
     for (uint i = 0; i < count; i++) {
         telemetrySensor_t * sensor = &sch.sensors[i];
         sensor->index = i;
+        sensor->active = false;
     }
 }
 
@@ -29,12 +29,20 @@
 #include "telemetry/sensors.h"
 
 
+#define TELEM_SCHEDULE_QUEUE_SIZE   128
+
 typedef struct {
 
     telemetrySensor_t *         sensors;
 
     uint16_t                    sensor_count;
-    uint16_t                    start_index;
+
+    uint8_t                     queue[TELEM_SCHEDULE_QUEUE_SIZE];
+    uint8_t                     queue_count;
+
+    uint8_t                     ready[TELEM_SCHEDULE_QUEUE_SIZE];
+    uint8_t                     ready_head;
+    uint8_t                     ready_count;
 
     timeUs_t                    update_time;
 
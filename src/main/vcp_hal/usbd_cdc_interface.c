@@ -406,6 +406,27 @@ uint32_t CDC_Receive_BytesAvailable(void)
     return rxAvailable;
 }
 
+// Expose the unread part of the current packet without copying.
+// The next packet is requested once it has been consumed completely.
+uint32_t CDC_Receive_Peek(const uint8_t **data)
+{
+    *data = rxBuffPtr;
+    return (rxBuffPtr != NULL) ? rxAvailable : 0;
+}
+
+void CDC_Receive_Consume(uint32_t len)
+{
+    if (rxBuffPtr != NULL && len > 0) {
+        if (len > rxAvailable) {
+            len = rxAvailable;
+        }
+        rxBuffPtr += len;
+        rxAvailable -= len;
+        if (rxAvailable < 1)
+            USBD_CDC_ReceivePacket(&USBD_Device);
+    }
+}
+
 uint32_t CDC_Send_FreeBytes(void)
 {
     /*
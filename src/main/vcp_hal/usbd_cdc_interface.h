@@ -88,6 +88,8 @@ uint32_t CDC_Send_DATA(const uint8_t *ptrBuffer, uint32_t sendLength);
 uint32_t CDC_Send_FreeBytes(void);
 uint32_t CDC_Receive_DATA(uint8_t* recvBuf, uint32_t len);
 uint32_t CDC_Receive_BytesAvailable(void);
+uint32_t CDC_Receive_Peek(const uint8_t **data);
+void CDC_Receive_Consume(uint32_t len);
 uint8_t usbIsConfigured(void);
 uint8_t usbIsConnected(void);
 uint32_t CDC_BaudRate(void);
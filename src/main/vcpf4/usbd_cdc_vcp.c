@@ -246,6 +246,25 @@ uint32_t CDC_Receive_BytesAvailable(void)
     return (APP_Tx_ptr_in + APP_TX_DATA_SIZE - APP_Tx_ptr_out) % APP_TX_DATA_SIZE;
 }
 
+/*******************************************************************************
+ * Function Name  : Receive Peek / Consume.
+ * Description    : expose the contiguous run of received data at the read
+ *                  position of the circular buffer without copying, then release it.
+ *******************************************************************************/
+uint32_t CDC_Receive_Peek(const uint8_t **data)
+{
+    const uint32_t in = APP_Tx_ptr_in;
+    const uint32_t out = APP_Tx_ptr_out;
+
+    *data = &APP_Tx_Buffer[out];
+    return (in >= out) ? in - out : APP_TX_DATA_SIZE - out;
+}
+
+void CDC_Receive_Consume(uint32_t len)
+{
+    APP_Tx_ptr_out = (APP_Tx_ptr_out + len) % APP_TX_DATA_SIZE;
+}
+
 /**
  * @brief  VCP_DataRx
  *         Data received over USB OUT endpoint are sent over CDC interface
@@ -22,6 +22,7 @@ extern "C" {
 
     #include "blackbox/blackbox.h"
     #include "blackbox/blackbox_encoding.h"
+    #include "blackbox/blackbox_io.h"
     #include "common/utils.h"
 
     #include "pg/pg.h"
@@ -118,6 +119,31 @@ TEST(BlackboxEncodingTest, TestWriteUnsignedVB)
     EXPECT_EQ(1, serialWriteBuffer[2]);
 }
 
+TEST(BlackboxEncodingTest, TestWriteStaged)
+{
+    serialTestResetBuffers();
+    uint8_t frame[3] = { 0 };
+
+    // Encoded bytes go to the staging buffer while it has room
+    blackboxFramePos = frame;
+    blackboxFrameLimit = frame + sizeof(frame);
+    blackboxWriteUnsignedVB(128);
+    EXPECT_EQ(frame + 2, blackboxFramePos);
+    EXPECT_EQ(0x80, frame[0]);
+    EXPECT_EQ(1, frame[1]);
+    EXPECT_EQ(0, serialWritePos);
+
+    // and overflow to the byte writer when full
+    blackboxWriteUnsignedVB(128);
+    EXPECT_EQ(frame + 3, blackboxFramePos);
+    EXPECT_EQ(0x80, frame[2]);
+    EXPECT_EQ(1, serialWritePos);
+    EXPECT_EQ(1, serialWriteBuffer[0]);
+
+    blackboxFramePos = NULL;
+    blackboxFrameLimit = NULL;
+}
+
 TEST(BlackboxTest, TestWriteTag2_3SVariable_BITS2)
 {
     serialTestResetBuffers();
@@ -245,7 +271,9 @@ extern "C" {
 PG_REGISTER(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 0);
 int32_t blackboxHeaderBudget;
 void mspSerialAllocatePorts(void) {}
-void blackboxWrite(uint8_t value) {serialWrite(blackboxPort, value);}
+uint8_t *blackboxFramePos = NULL;
+uint8_t *blackboxFrameLimit = NULL;
+void blackboxWriteByte(uint8_t value) {serialWrite(blackboxPort, value);}
 int blackboxWriteString(const char *s)
 {
     const uint8_t *pos = (uint8_t*)s;
@@ -0,0 +1,531 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The flash and FlashFS are replaced with a small in-memory model: 16
+ * sectors of FlashFS followed by the two directory sectors, with only
+ * four pages per sector so that the directory compacts quickly. Logs
+ * are written straight into the model, like FlashFS would lay them out.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "blackbox/blackbox_logdir.h"
+
+    #include "drivers/flash.h"
+
+    #include "io/flashfs.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+
+#define PAGE_SIZE           256
+#define PAGES_PER_SECTOR    4
+#define SECTOR_SIZE         (PAGE_SIZE * PAGES_PER_SECTOR)
+#define FLASHFS_SECTORS     16
+#define FLASHFS_SIZE        (FLASHFS_SECTORS * SECTOR_SIZE)
+#define FLASH_SECTORS       (FLASHFS_SECTORS + 2)
+#define FLASH_SIZE          (FLASH_SECTORS * SECTOR_SIZE)
+
+static uint8_t flashMemory[FLASH_SIZE];
+
+static const flashGeometry_t flashGeometry = {
+    .sectors = FLASH_SECTORS,
+    .pageSize = PAGE_SIZE,
+    .sectorSize = SECTOR_SIZE,
+    .totalSize = FLASH_SIZE,
+    .pagesPerSector = PAGES_PER_SECTOR,
+    .flashType = FLASH_TYPE_NAND,
+};
+
+static flashPartition_t logDirPartition = {
+    .type = FLASH_PARTITION_TYPE_LOGDIR,
+    .startSector = FLASHFS_SECTORS,
+    .endSector = FLASH_SECTORS - 1,
+};
+
+static bool haveLogDir;
+static bool flashReady;
+static int eraseCount;
+static uint32_t headAddress;
+static uint32_t usedSpace;
+static int progressCount;
+
+typedef struct {
+    uint32_t offset;
+    uint32_t size;
+    uint32_t startTime;
+    uint32_t fieldHash;
+} testLog_t;
+
+static std::vector<testLog_t> logs;
+
+static bool collectLog(const blackboxLogEntry_t *entry, void *context)
+{
+    UNUSED(context);
+    logs.push_back({ entry->offset, entry->size, entry->startTime, entry->fieldHash });
+    return true;
+}
+
+static void countProgress(void)
+{
+    progressCount++;
+}
+
+static int enumerateLogs(void)
+{
+    logs.clear();
+    progressCount = 0;
+    return blackboxLogDirEnumerate(collectLog, countProgress, NULL);
+}
+
+// Give the directory time to check its region, as after a flash erase
+static void idle(void)
+{
+    for (int i = 0; i < 2 * SECTOR_SIZE; i++) {
+        blackboxLogDirUpdate();
+    }
+}
+
+static void resetFlash(bool logDir)
+{
+    memset(flashMemory, 0xFF, sizeof(flashMemory));
+    blackboxLogDirCancel();
+    haveLogDir = logDir;
+    flashReady = true;
+    headAddress = 0;
+    usedSpace = 0;
+    idle();
+    eraseCount = 0;
+}
+
+// Write a log of the given size at the end of the used space, optionally through the directory
+static uint32_t writeLog(const char *dateTime, uint32_t size, uint32_t fieldHash, bool record = true)
+{
+    const uint32_t offset = usedSpace;
+
+    if (record) {
+        blackboxLogDirBegin(fieldHash);
+    }
+
+    // No header when continuing a log
+    std::string header;
+    if (dateTime) {
+        header = "H Product:Blackbox flight data recorder by Nicholas Sherlock\n"
+                 "H Data version:2\n"
+                 "H Log start datetime:";
+        header += dateTime;
+        header += "\n";
+    }
+
+    for (uint32_t i = 0; i < size; i++) {
+        const uint32_t address = (headAddress + offset + i) % FLASHFS_SIZE;
+        EXPECT_EQ(0xFF, flashMemory[address]);
+        flashMemory[address] = (i < header.size()) ? header[i] : 'x';
+    }
+
+    // flashfsClose() pads the log to a page
+    usedSpace += (size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+
+    if (record) {
+        blackboxLogDirEnd();
+        // The blackbox is stopped until the next log, erase both banks if needed
+        blackboxLogDirUpdate();
+        blackboxLogDirUpdate();
+    }
+
+    return offset;
+}
+
+// Emulate the rolling erase moving the head forward
+static void eraseHead(uint32_t sectors)
+{
+    for (uint32_t i = 0; i < sectors; i++) {
+        memset(&flashMemory[headAddress], 0xFF, SECTOR_SIZE);
+        headAddress = (headAddress + SECTOR_SIZE) % FLASHFS_SIZE;
+        usedSpace -= SECTOR_SIZE;
+    }
+}
+
+TEST(BlackboxLogDirTest, ScanWithoutDirectory)
+{
+    resetFlash(false);
+
+    writeLog("2024-05-01T12:30:45.123+00:00", 1000, 1);
+    writeLog("0000-01-01T00:00:00.000+00:00", 600, 2);
+
+    EXPECT_EQ(2, enumerateLogs());
+    EXPECT_EQ(0u, logs[0].offset);
+    EXPECT_EQ(1024u, logs[0].size);
+    EXPECT_EQ(1714566645u, logs[0].startTime);
+    EXPECT_EQ(0u, logs[0].fieldHash);
+    EXPECT_EQ(1024u, logs[1].offset);
+    EXPECT_EQ(768u, logs[1].size);
+    EXPECT_EQ(0u, logs[1].startTime);
+
+    // Every used page was looked at
+    EXPECT_EQ(7, progressCount);
+}
+
+TEST(BlackboxLogDirTest, RecordsReplaceScan)
+{
+    resetFlash(true);
+
+    writeLog("2024-05-01T12:30:45.123+00:00", 1000, 0x1234);
+    writeLog("2025-02-28T23:59:58.000+00:00", 3000, 0x5678);
+    writeLog("0000-01-01T00:00:00.000+00:00", 256, 0x9ABC);
+
+    EXPECT_EQ(3, enumerateLogs());
+    EXPECT_EQ(0, progressCount);
+
+    EXPECT_EQ(0u, logs[0].offset);
+    EXPECT_EQ(1024u, logs[0].size);
+    EXPECT_EQ(0x1234u, logs[0].fieldHash);
+    EXPECT_EQ(1024u, logs[1].offset);
+    EXPECT_EQ(3072u, logs[1].size);
+    EXPECT_EQ(0x5678u, logs[1].fieldHash);
+    EXPECT_EQ(4096u, logs[2].offset);
+    EXPECT_EQ(256u, logs[2].size);
+    EXPECT_EQ(0x9ABCu, logs[2].fieldHash);
+}
+
+TEST(BlackboxLogDirTest, GapsAreScanned)
+{
+    resetFlash(true);
+
+    // Written before the directory existed
+    writeLog("2024-05-01T12:30:45.123+00:00", 512, 1, false);
+    writeLog("2024-05-01T12:40:00.000+00:00", 512, 2, true);
+    // Never closed, e.g. power loss while logging
+    writeLog("2025-02-28T23:59:58.000+00:00", 768, 3, false);
+
+    EXPECT_EQ(3, enumerateLogs());
+    EXPECT_EQ(0u, logs[0].offset);
+    EXPECT_EQ(512u, logs[0].size);
+    EXPECT_EQ(1714566645u, logs[0].startTime);
+    EXPECT_EQ(512u, logs[1].offset);
+    EXPECT_EQ(2u, logs[1].fieldHash);
+    EXPECT_EQ(1024u, logs[2].offset);
+    EXPECT_EQ(768u, logs[2].size);
+    EXPECT_EQ(1740787198u, logs[2].startTime);
+
+    // Only the unrecorded pages were looked at
+    EXPECT_EQ(5, progressCount);
+}
+
+TEST(BlackboxLogDirTest, RecordsOnly)
+{
+    resetFlash(true);
+
+    writeLog("2024-05-01T12:30:45.123+00:00", 512, 1, false);
+    writeLog("2024-05-01T12:40:00.000+00:00", 512, 2, true);
+    writeLog("2025-02-28T23:59:58.000+00:00", 768, 3, false);
+
+    // The gaps are left out, nothing is scanned
+    logs.clear();
+    progressCount = 0;
+    EXPECT_EQ(1, blackboxLogDirEnumerateRecords(collectLog, NULL));
+    EXPECT_EQ(512u, logs[0].offset);
+    EXPECT_EQ(512u, logs[0].size);
+    EXPECT_EQ(2u, logs[0].fieldHash);
+    EXPECT_EQ(0, progressCount);
+
+    // Without a usable directory the flash is scanned
+    flashMemory[FLASHFS_SIZE + 4] = 0x40;
+    logs.clear();
+    EXPECT_EQ(3, blackboxLogDirEnumerateRecords(collectLog, NULL));
+    EXPECT_EQ(1024u, logs[2].offset);
+    EXPECT_EQ(1740787198u, logs[2].startTime);
+
+    resetFlash(false);
+    writeLog("2024-05-01T12:30:45.123+00:00", 512, 1);
+    logs.clear();
+    EXPECT_EQ(1, blackboxLogDirEnumerateRecords(collectLog, NULL));
+    EXPECT_EQ(1714566645u, logs[0].startTime);
+}
+
+TEST(BlackboxLogDirTest, Compaction)
+{
+    resetFlash(true);
+
+    uint32_t offsets[10];
+    for (int i = 0; i < 10; i++) {
+        offsets[i] = writeLog("2024-05-01T12:30:45.123+00:00", 300, i + 1);
+    }
+
+    // The oldest logs are merged, the rest are still listed one by one
+    const int count = enumerateLogs();
+    EXPECT_EQ(0, progressCount);
+    EXPECT_LT(count, 10);
+    EXPECT_GT(count, 2);
+
+    EXPECT_EQ(0u, logs[0].offset);
+    EXPECT_EQ(0u, logs[0].fieldHash);
+
+    uint32_t position = 0;
+    for (const auto &log : logs) {
+        EXPECT_EQ(position, log.offset);
+        position += log.size;
+    }
+    EXPECT_EQ(usedSpace, position);
+
+    for (int i = 1; i < count; i++) {
+        EXPECT_EQ(offsets[10 - count + i], logs[i].offset);
+        EXPECT_EQ((uint32_t)(10 - count + i + 1), logs[i].fieldHash);
+    }
+}
+
+TEST(BlackboxLogDirTest, CorruptDirectory)
+{
+    resetFlash(true);
+
+    writeLog("2024-05-01T12:30:45.123+00:00", 512, 1);
+    writeLog("2024-05-01T12:40:00.000+00:00", 512, 2);
+
+    // Garbage over the first record
+    flashMemory[FLASHFS_SIZE + 4] = 0x40;
+
+    EXPECT_EQ(2, enumerateLogs());
+    EXPECT_EQ(4, progressCount);
+    EXPECT_EQ(0u, logs[0].fieldHash);
+    EXPECT_EQ(512u, logs[1].offset);
+
+    // The next log finds the corruption and is left to the scan
+    writeLog("2024-05-01T12:50:00.000+00:00", 512, 3);
+
+    EXPECT_EQ(3, enumerateLogs());
+    EXPECT_EQ(6, progressCount);
+    EXPECT_EQ(2, eraseCount);
+
+    // The directory starts over once the banks are erased
+    writeLog("2024-05-01T13:00:00.000+00:00", 512, 4);
+
+    EXPECT_EQ(4, enumerateLogs());
+    EXPECT_EQ(6, progressCount);
+    EXPECT_EQ(1536u, logs[3].offset);
+    EXPECT_EQ(4u, logs[3].fieldHash);
+}
+
+TEST(BlackboxLogDirTest, EraseInBackground)
+{
+    resetFlash(true);
+
+    for (int i = 0; i < PAGES_PER_SECTOR; i++) {
+        writeLog("2024-05-01T12:30:45.123+00:00", 300, i + 1);
+    }
+    EXPECT_EQ(0, eraseCount);
+
+    // Compaction into the erased bank, the old one is not erased on close
+    blackboxLogDirBegin(5);
+    writeLog("2024-05-01T12:30:45.123+00:00", 300, 5, false);
+    blackboxLogDirEnd();
+    EXPECT_EQ(0, eraseCount);
+
+    // Without idle time the next compaction has nowhere to go
+    blackboxLogDirBegin(6);
+    writeLog("2024-05-01T12:30:45.123+00:00", 300, 6, false);
+    blackboxLogDirEnd();
+    EXPECT_EQ(0, eraseCount);
+
+    EXPECT_EQ(5, enumerateLogs());
+    EXPECT_EQ(2, progressCount);
+    EXPECT_EQ(5u, logs[3].fieldHash);
+    EXPECT_EQ(0u, logs[4].fieldHash);
+
+    // Nothing is erased while the flash is busy
+    flashReady = false;
+    blackboxLogDirUpdate();
+    EXPECT_EQ(0, eraseCount);
+
+    flashReady = true;
+    blackboxLogDirUpdate();
+    blackboxLogDirUpdate();
+    EXPECT_EQ(1, eraseCount);
+
+    // The log after that is recorded again
+    writeLog("2024-05-01T12:30:45.123+00:00", 300, 7);
+
+    EXPECT_EQ(5, enumerateLogs());
+    EXPECT_EQ(2, progressCount);
+    EXPECT_EQ(5u, logs[2].fieldHash);
+    EXPECT_EQ(0u, logs[3].fieldHash);
+    EXPECT_EQ(7u, logs[4].fieldHash);
+}
+
+TEST(BlackboxLogDirTest, ForeignRegionKept)
+{
+    resetFlash(true);
+
+    // Logs from before the upgrade reach into the directory sectors
+    memset(&flashMemory[FLASHFS_SIZE], 'x', SECTOR_SIZE + 100);
+    blackboxLogDirCancel();
+    idle();
+
+    writeLog("2024-05-01T12:30:45.123+00:00", 512, 1);
+    writeLog("2024-05-01T12:40:00.000+00:00", 512, 2);
+
+    // Nothing is written or erased there, the logs are found by the scan
+    EXPECT_EQ(0, eraseCount);
+    EXPECT_EQ('x', flashMemory[FLASHFS_SIZE]);
+    EXPECT_EQ('x', flashMemory[FLASHFS_SIZE + SECTOR_SIZE + 99]);
+    EXPECT_EQ(2, enumerateLogs());
+    EXPECT_EQ(4, progressCount);
+
+    // Same with the first records blank, but data further in
+    memset(&flashMemory[FLASHFS_SIZE], 0xFF, SECTOR_SIZE + 100);
+    flashMemory[FLASHFS_SIZE + SECTOR_SIZE + 300] = 0;
+    blackboxLogDirCancel();
+    idle();
+
+    writeLog("2024-05-01T12:50:00.000+00:00", 512, 3);
+    EXPECT_EQ(0, flashMemory[FLASHFS_SIZE + SECTOR_SIZE + 300]);
+    EXPECT_EQ(3, enumerateLogs());
+    EXPECT_EQ(6, progressCount);
+
+    // Taken over once the flash is erased
+    resetFlash(true);
+    writeLog("2024-05-01T12:30:45.123+00:00", 512, 1);
+    EXPECT_EQ(1, enumerateLogs());
+    EXPECT_EQ(0, progressCount);
+}
+
+TEST(BlackboxLogDirTest, RecordsBeforeBlankCheck)
+{
+    resetFlash(true);
+
+    writeLog("2024-05-01T12:30:45.123+00:00", 512, 1);
+
+    // Back to not knowing the region, as after a reboot. The records show it is in use.
+    blackboxLogDirCancel();
+    writeLog("2024-05-01T12:40:00.000+00:00", 512, 2);
+
+    EXPECT_EQ(2, enumerateLogs());
+    EXPECT_EQ(0, progressCount);
+}
+
+TEST(BlackboxLogDirTest, RollingErase)
+{
+    resetFlash(true);
+
+    writeLog("2024-05-01T12:30:45.123+00:00", 6 * SECTOR_SIZE, 1);
+    writeLog("2024-05-01T12:40:00.000+00:00", 6 * SECTOR_SIZE, 2);
+
+    // The first log loses its header, its remains need no scanning
+    eraseHead(2);
+    writeLog("2024-05-01T12:50:00.000+00:00", 5 * SECTOR_SIZE, 3);
+
+    EXPECT_EQ(2, enumerateLogs());
+    EXPECT_EQ(0, progressCount);
+    EXPECT_EQ(4u * SECTOR_SIZE, logs[0].offset);
+    EXPECT_EQ(2u, logs[0].fieldHash);
+    EXPECT_EQ(10u * SECTOR_SIZE, logs[1].offset);
+    EXPECT_EQ(3u, logs[1].fieldHash);
+
+    // The first log is gone completely
+    eraseHead(4);
+    writeLog("2024-05-01T13:00:00.000+00:00", 4 * SECTOR_SIZE, 4);
+
+    EXPECT_EQ(3, enumerateLogs());
+    EXPECT_EQ(0, progressCount);
+    EXPECT_EQ(2u, logs[0].fieldHash);
+    EXPECT_EQ(3u, logs[1].fieldHash);
+    EXPECT_EQ(4u, logs[2].fieldHash);
+    EXPECT_EQ(usedSpace, logs[2].offset + logs[2].size);
+}
+
+TEST(BlackboxLogDirTest, LogOverwritesItself)
+{
+    resetFlash(true);
+
+    blackboxLogDirBegin(1);
+    writeLog("2024-05-01T12:30:45.123+00:00", 14 * SECTOR_SIZE, 1, false);
+    eraseHead(4);
+    writeLog(NULL, 3 * SECTOR_SIZE, 1, false);
+    blackboxLogDirEnd();
+
+    // Without the header it can't be decoded, nor is there anything to scan
+    EXPECT_EQ(0, enumerateLogs());
+    EXPECT_EQ(0, progressCount);
+}
+
+// STUBS
+
+extern "C" {
+
+bool flashWaitForReady(void) { return true; }
+bool flashIsReady(void) { return flashReady; }
+bool flashIsSuspended(void) { return false; }
+void flashFlush(void) {}
+
+const flashGeometry_t *flashGetGeometry(void)
+{
+    return &flashGeometry;
+}
+
+flashPartition_t *flashPartitionFindByType(flashPartitionType_e type)
+{
+    return (type == FLASH_PARTITION_TYPE_LOGDIR && haveLogDir) ? &logDirPartition : NULL;
+}
+
+void flashEraseSector(uint32_t address)
+{
+    EXPECT_EQ(0u, address % SECTOR_SIZE);
+    memset(&flashMemory[address], 0xFF, SECTOR_SIZE);
+    eraseCount++;
+}
+
+void flashPageProgram(uint32_t address, const uint8_t *data, uint32_t length, void (*callback)(uint32_t length))
+{
+    EXPECT_TRUE(callback == NULL);
+    EXPECT_LE(address % PAGE_SIZE + length, (uint32_t)PAGE_SIZE);
+
+    for (uint32_t i = 0; i < length; i++) {
+        EXPECT_EQ(0xFF, flashMemory[address + i]);
+        flashMemory[address + i] = data[i];
+    }
+}
+
+int flashReadBytes(uint32_t address, uint8_t *buffer, uint32_t length)
+{
+    EXPECT_LE(address + length, (uint32_t)FLASH_SIZE);
+    memcpy(buffer, &flashMemory[address], length);
+    return length;
+}
+
+bool flashfsIsReady(void) { return true; }
+uint32_t flashfsGetSize(void) { return FLASHFS_SIZE; }
+uint32_t flashfsGetOffset(void) { return usedSpace; }
+uint32_t flashfsGetHeadAddress(void) { return headAddress; }
+
+int flashfsReadAbs(uint32_t offset, uint8_t *data, unsigned int len)
+{
+    for (unsigned i = 0; i < len; i++) {
+        data[i] = flashMemory[(headAddress + offset + i) % FLASHFS_SIZE];
+    }
+    return len;
+}
+
+}
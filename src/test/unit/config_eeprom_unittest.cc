@@ -0,0 +1,491 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <iostream>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/crc.h"
+
+    #include "config/config_eeprom.h"
+    #include "config/config_streamer.h"
+    #include "pg/pg.h"
+
+    #include "drivers/system.h"
+    #include "drivers/time.h"
+
+    typedef struct testConfig_s {
+        uint32_t value[4];
+    } testConfig_t;
+
+#define TEST_PGN_BASE       100
+#define TEST_PG_COUNT       32
+
+#define TEST_PG(n, k)       PG_REGISTER(testConfig_t, testConfig ## n ## k, (TEST_PGN_BASE + 4 * n + k), 0)
+#define TEST_PG4(n)         TEST_PG(n, 0); TEST_PG(n, 1); TEST_PG(n, 2); TEST_PG(n, 3)
+
+    TEST_PG4(0); TEST_PG4(1); TEST_PG4(2); TEST_PG4(3);
+    TEST_PG4(4); TEST_PG4(5); TEST_PG4(6); TEST_PG4(7);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Same layout as the records in config_eeprom.c
+typedef struct {
+    uint16_t size;
+    uint16_t pgn;
+    uint8_t version;
+    uint8_t flags;
+} __attribute__((packed)) testRecord_t;
+
+// Version of the images written by firmware without segments
+#define LEGACY_CONF_VERSION 174
+
+// Builds a config image in eepromData, in the format written by writeConfigToEEPROM()
+class ConfigImage {
+  public:
+    explicit ConfigImage(uint8_t version = EEPROM_CONF_VERSION) : pos_(0), crc_(0xFFFF)
+    {
+        memset(eepromData, 0xFF, sizeof(eepromData));
+        const uint8_t header[2] = { version, 0xBE };
+        Append(header, sizeof(header));
+    }
+
+    void AddRecord(uint16_t pgn, uint32_t seed)
+    {
+        testRecord_t record = { sizeof(testRecord_t) + sizeof(testConfig_t), pgn, 0, 0 };
+        testConfig_t config;
+        for (int i = 0; i < 4; i++) {
+            config.value[i] = seed * 4 + i;
+        }
+        Append(&record, sizeof(record));
+        Append(&config, sizeof(config));
+    }
+
+    void AddFiller(int count)
+    {
+        for (int i = 0; i < count; i++) {
+            AddRecord(1000 + i, 0);
+        }
+    }
+
+    void AddTestConfigs(uint32_t seed)
+    {
+        for (int i = 0; i < TEST_PG_COUNT; i++) {
+            AddRecord(TEST_PGN_BASE + i, seed + i);
+        }
+    }
+
+    void Finish()
+    {
+        const uint16_t terminator = 0;
+        Append(&terminator, sizeof(terminator));
+        const uint16_t invertedBigEndianCrc = ~(((crc_ & 0xFF) << 8) | (crc_ >> 8));
+        memcpy(&eepromData[pos_], &invertedBigEndianCrc, sizeof(invertedBigEndianCrc));
+    }
+
+  private:
+    void Append(const void *data, size_t length)
+    {
+        ASSERT_LE(pos_ + length, sizeof(eepromData));
+        memcpy(&eepromData[pos_], data, length);
+        crc_ = crc16_ccitt_update(crc_, data, length);
+        pos_ += length;
+    }
+
+    size_t pos_;
+    uint16_t crc_;
+};
+
+static const testConfig_t *testConfig(int index)
+{
+    const pgRegistry_t *reg = pgFind(TEST_PGN_BASE + index);
+    return reg ? (const testConfig_t *)reg->address : NULL;
+}
+
+static void expectTestConfigs(uint32_t seed)
+{
+    for (int i = 0; i < TEST_PG_COUNT; i++) {
+        const testConfig_t *config = testConfig(i);
+        ASSERT_NE(nullptr, config);
+        for (int j = 0; j < 4; j++) {
+            EXPECT_EQ((seed + i) * 4 + j, config->value[j]) << "pg " << i;
+        }
+    }
+}
+
+TEST(ConfigEepromTest, LoadIndexed)
+{
+    ConfigImage image;
+    image.AddFiller(600);
+    image.AddTestConfigs(7);
+    image.Finish();
+
+    EXPECT_TRUE(isEEPROMVersionValid());
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_TRUE(loadEEPROM());
+    expectTestConfigs(7);
+}
+
+TEST(ConfigEepromTest, LoadIndexOverflow)
+{
+    // More records than the index takes, falls back to scanning
+    ConfigImage image;
+    image.AddTestConfigs(11);
+    image.AddFiller(CONFIG_RECORD_INDEX_SIZE);
+    image.Finish();
+
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_TRUE(loadEEPROM());
+    expectTestConfigs(11);
+}
+
+TEST(ConfigEepromTest, LoadDuplicateRecord)
+{
+    // The first record of a pgn wins
+    ConfigImage image;
+    image.AddTestConfigs(3);
+    image.AddRecord(TEST_PGN_BASE, 99);
+    image.Finish();
+
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_TRUE(loadEEPROM());
+    expectTestConfigs(3);
+}
+
+TEST(ConfigEepromTest, LoadMissingRecord)
+{
+    ConfigImage image;
+    for (int i = 1; i < TEST_PG_COUNT; i++) {
+        image.AddRecord(TEST_PGN_BASE + i, i);
+    }
+    image.Finish();
+
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_FALSE(loadEEPROM());
+
+    // Missing PG is reset, the rest are loaded
+    EXPECT_EQ(0, testConfig(0)->value[0]);
+    EXPECT_EQ(4 * 1, testConfig(1)->value[0]);
+    EXPECT_EQ(4 * (TEST_PG_COUNT - 1), testConfig(TEST_PG_COUNT - 1)->value[0]);
+}
+
+TEST(ConfigEepromTest, CorruptImage)
+{
+    ConfigImage image;
+    image.AddTestConfigs(5);
+    image.Finish();
+
+    EXPECT_TRUE(isEEPROMStructureValid());
+    eepromData[20] ^= 0x01;
+    EXPECT_FALSE(isEEPROMStructureValid());
+}
+
+TEST(ConfigEepromTest, WriteAndLoad)
+{
+    ConfigImage image;
+    image.AddFiller(100);
+    image.AddTestConfigs(1);
+    image.Finish();
+
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_TRUE(loadEEPROM());
+
+    for (int i = 0; i < TEST_PG_COUNT; i++) {
+        testConfig_t *config = (testConfig_t *)pgFind(TEST_PGN_BASE + i)->address;
+        for (int j = 0; j < 4; j++) {
+            config->value[j] += 4;
+        }
+    }
+    writeConfigToEEPROM();
+    memset(testConfig00_System.value, 0, sizeof(testConfig00_System.value));
+
+    EXPECT_TRUE(loadEEPROM());
+    expectTestConfigs(2);
+}
+
+static int flashErases;
+
+static testConfig_t *mutableTestConfig(int index)
+{
+    return (testConfig_t *)pgFind(TEST_PGN_BASE + index)->address;
+}
+
+// Blank flash, config saved from the defaults
+static void eraseAndWriteDefaults(void)
+{
+    memset(eepromData, 0xFF, sizeof(eepromData));
+    flashErases = 0;
+    pgResetAll();
+    writeConfigToEEPROM();
+    ASSERT_TRUE(loadEEPROM());
+}
+
+TEST(ConfigEepromTest, AppendChangedPG)
+{
+    eraseAndWriteDefaults();
+    const uint16_t snapshotSize = getEEPROMConfigSize();
+    const int snapshotErases = flashErases;
+
+    // Only the changed PG is appended, nothing is erased
+    mutableTestConfig(5)->value[2] = 1234;
+    writeConfigToEEPROM();
+    EXPECT_EQ(snapshotErases, flashErases);
+    EXPECT_EQ(snapshotSize + 32, getEEPROMConfigSize());
+
+    // Nothing changed, nothing written
+    writeConfigToEEPROM();
+    EXPECT_EQ(snapshotSize + 32, getEEPROMConfigSize());
+
+    mutableTestConfig(5)->value[2] = 0;
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(1234, testConfig(5)->value[2]);
+}
+
+TEST(ConfigEepromTest, AppendAfterLegacyImage)
+{
+    const size_t bankSize = sizeof(eepromData) / 2;
+
+    // Saved by firmware without segments
+    ConfigImage image(LEGACY_CONF_VERSION);
+    image.AddTestConfigs(1);
+    image.Finish();
+
+    EXPECT_TRUE(isEEPROMVersionValid());
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_TRUE(loadEEPROM());
+    expectTestConfigs(1);
+
+    // The next save writes a current snapshot, the settings survive
+    mutableTestConfig(0)->value[0] = 77;
+    writeConfigToEEPROM();
+    EXPECT_EQ(EEPROM_CONF_VERSION, eepromData[bankSize]);
+
+    mutableTestConfig(0)->value[0] = 0;
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(77, testConfig(0)->value[0]);
+    EXPECT_EQ(4 * 1 + 1, testConfig(0)->value[1]);
+    EXPECT_EQ(4 * 2, testConfig(1)->value[0]);
+    EXPECT_EQ(4 * TEST_PG_COUNT, testConfig(TEST_PG_COUNT - 1)->value[0]);
+
+    // Appends go on from there
+    mutableTestConfig(1)->value[0] = 88;
+    writeConfigToEEPROM();
+    mutableTestConfig(1)->value[0] = 0;
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(77, testConfig(0)->value[0]);
+    EXPECT_EQ(88, testConfig(1)->value[0]);
+}
+
+TEST(ConfigEepromTest, PartialSegmentIgnored)
+{
+    eraseAndWriteDefaults();
+    const uint16_t snapshotSize = getEEPROMConfigSize();
+
+    mutableTestConfig(3)->value[0] = 1;
+    writeConfigToEEPROM();
+    mutableTestConfig(3)->value[0] = 2;
+    writeConfigToEEPROM();
+
+    // Power lost in the middle of the last segment
+    eepromData[snapshotSize + 32 + 20] ^= 0x01;
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_EQ(snapshotSize + 32, getEEPROMConfigSize());
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(1, testConfig(3)->value[0]);
+
+    // The next save doesn't program over the broken segment
+    mutableTestConfig(3)->value[0] = 3;
+    writeConfigToEEPROM();
+    mutableTestConfig(3)->value[0] = 0;
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(3, testConfig(3)->value[0]);
+}
+
+TEST(ConfigEepromTest, CompactionAlternatesBanks)
+{
+    constexpr int kSaves = 1200;
+    const size_t bankSize = sizeof(eepromData) / 2;
+
+    eraseAndWriteDefaults();
+
+    uint16_t size = getEEPROMConfigSize();
+    bool inSecondBank = false;
+    int compactions = 0;
+
+    for (int save = 1; save <= kSaves; save++) {
+        const int index = save % TEST_PG_COUNT;
+        const uint32_t previous = testConfig(index)->value[1];
+
+        mutableTestConfig(index)->value[1] = save;
+        writeConfigToEEPROM();
+        ASSERT_LE(getEEPROMConfigSize(), bankSize);
+
+        mutableTestConfig(index)->value[1] = 0;
+        ASSERT_TRUE(loadEEPROM());
+        ASSERT_EQ((uint32_t)save, testConfig(index)->value[1]);
+
+        // Compacted to the other bank when the log got full
+        if (getEEPROMConfigSize() < size) {
+            inSecondBank = !inSecondBank;
+            compactions++;
+            ASSERT_EQ(0xBE, eepromData[inSecondBank ? bankSize + 1 : 1]);
+
+            // If the new snapshot is lost, the old bank is still intact
+            const size_t offset = (inSecondBank ? bankSize : 0) + 10;
+            eepromData[offset] ^= 0x01;
+            ASSERT_TRUE(isEEPROMStructureValid());
+            ASSERT_TRUE(loadEEPROM());
+            EXPECT_EQ(previous, testConfig(index)->value[1]);
+
+            eepromData[offset] ^= 0x01;
+            ASSERT_TRUE(isEEPROMStructureValid());
+            ASSERT_TRUE(loadEEPROM());
+        }
+        size = getEEPROMConfigSize();
+    }
+
+    EXPECT_GE(compactions, 2);
+
+    // Rewriting the whole config erases a page for every save
+    std::cout << kSaves << " saves, " << compactions << " compactions, "
+              << flashErases << " page erases." << std::endl;
+    EXPECT_LT(flashErases, kSaves / 10);
+}
+
+static timeUs_t fakeMicros;
+
+TEST(ConfigEepromTest, LoadTime)
+{
+    ConfigImage image;
+    image.AddTestConfigs(0);
+    image.Finish();
+
+    EXPECT_TRUE(isEEPROMStructureValid());
+    fakeMicros = 1000;
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(1, getEEPROMLoadTime());
+}
+
+// Timing only, run by "make benchmark"
+TEST(ConfigEepromTest, LoadBenchmark)
+{
+    if (getenv("CONFIG_EEPROM_BENCH") == NULL) {
+        GTEST_SKIP();
+    }
+
+    constexpr int kRecords = 700;
+    constexpr int kRounds = 500;
+
+    // Worst case for a sequential scan, all the registered PGs at the end
+    ConfigImage image;
+    image.AddFiller(kRecords - TEST_PG_COUNT);
+    image.AddTestConfigs(9);
+    image.Finish();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < kRounds; round++) {
+        ASSERT_TRUE(isEEPROMStructureValid());
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int round = 0; round < kRounds; round++) {
+        ASSERT_TRUE(loadEEPROM());
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    expectTestConfigs(9);
+
+    // Same with the index overflowed, for comparison with the sequential scan
+    ConfigImage scanImage;
+    scanImage.AddFiller(CONFIG_RECORD_INDEX_SIZE);
+    scanImage.AddTestConfigs(9);
+    scanImage.Finish();
+
+    ASSERT_TRUE(isEEPROMStructureValid());
+    auto scanStart = std::chrono::steady_clock::now();
+    for (int round = 0; round < kRounds; round++) {
+        ASSERT_TRUE(loadEEPROM());
+    }
+    auto scanEnd = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double, std::micro> validateTime = middle - start;
+    std::chrono::duration<double, std::micro> loadTime = end - middle;
+    std::chrono::duration<double, std::micro> scanTime = scanEnd - scanStart;
+    std::cout << "Validate and index " << kRecords << " records = "
+              << validateTime.count() / kRounds << " us." << std::endl;
+    std::cout << "Indexed load of " << TEST_PG_COUNT << " PGs from " << kRecords << " records = "
+              << loadTime.count() / kRounds << " us." << std::endl;
+    std::cout << "Scanned load of " << TEST_PG_COUNT << " PGs from " << CONFIG_RECORD_INDEX_SIZE + TEST_PG_COUNT << " records = "
+              << scanTime.count() / kRounds << " us." << std::endl;
+}
+
+// STUBS
+extern "C" {
+    void failureMode(failureMode_e mode)
+    {
+        FAIL() << "failureMode " << mode;
+    }
+
+    void FLASH_Unlock(void)
+    {
+    }
+
+    void FLASH_Lock(void)
+    {
+    }
+
+    FLASH_Status FLASH_ErasePage(uintptr_t address)
+    {
+        const uint32_t pageSize = config_streamer_page_size();
+        const uintptr_t offset = address - (uintptr_t)eepromData;
+
+        EXPECT_EQ(0, address % pageSize);
+        EXPECT_LE(offset + pageSize, sizeof(eepromData));
+        memset(eepromData + offset, 0xFF, pageSize);
+        flashErases++;
+
+        return FLASH_COMPLETE;
+    }
+
+    // Flash can only be programmed once after an erase
+    FLASH_Status FLASH_ProgramWord(uintptr_t address, uint32_t data)
+    {
+        const uintptr_t offset = address - (uintptr_t)eepromData;
+        uint32_t erased;
+
+        EXPECT_LE(offset + sizeof(data), sizeof(eepromData));
+        memcpy(&erased, eepromData + offset, sizeof(erased));
+        EXPECT_EQ(0xFFFFFFFF, erased) << "offset " << offset;
+        memcpy(eepromData + offset, &data, sizeof(data));
+
+        return FLASH_COMPLETE;
+    }
+
+    timeUs_t micros(void)
+    {
+        return fakeMicros++;
+    }
+}
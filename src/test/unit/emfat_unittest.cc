@@ -15,6 +15,9 @@
  * along with this software. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <chrono>
+#include <iostream>
+
 #include "msc/emfat.h"
 #include "msc/emfat_file.h"
 
@@ -26,6 +29,7 @@ uint8_t sfn_checksum(const char* short_name, const char* extension);
 void emfat_init_sfn(emfat_entry_t *entry);
 bool emfat_init_entries(emfat_entry_t *entries);
 void fill_dir_sector(emfat_t *emfat, uint8_t *data, emfat_entry_t *entry, uint32_t rel_sect);
+emfat_entry_t *find_entry(const emfat_t *emfat, uint32_t clust, emfat_entry_t *nearest);
 }
 
 TEST(SfnChecksum, SpotTest)
@@ -282,3 +286,127 @@ TEST(Emfat, LFNAtSectorBoundary)
     EXPECT_EQ(de[1].name[0], 'E');  // SFN entry
     EXPECT_EQ(de[2].name[0], 0);    // NULL
 }
+
+// Tags each sector with the file it came from and its offset in the file
+static void readSyntheticLog(uint8_t *dest, int size, uint32_t offset, emfat_entry_t *entry)
+{
+    memset(dest, 0, size);
+    memcpy(dest, &entry->user_data, sizeof(uint32_t));
+    memcpy(dest + sizeof(uint32_t), &offset, sizeof(uint32_t));
+}
+
+class EmfatLargeVolume : public ::testing::Test
+{
+  public:
+    static constexpr int kLogs = 512;
+    static constexpr uint32_t kLogSize = 256 * 1024 + 1000;
+
+    void SetUp() override
+    {
+        entries_[0] = {
+            .name = "",
+            .dir = true,
+            .level = 0,
+        };
+
+        for (int i = 1; i <= kLogs; i++) {
+            names_[i] = "LOG" + std::to_string(i) + ".BBL";
+            entries_[i] = {
+                .name = names_[i].c_str(),
+                .dir = false,
+                .level = 1,
+                .curr_size = kLogSize,
+                .max_size = kLogSize,
+                .user_data = i,
+                .readcb = readSyntheticLog,
+            };
+        }
+
+        entries_[kLogs + 1] = {
+            NULL,
+        };
+
+        ASSERT_TRUE(emfat_init(&emfat_, "RTFL       ", entries_));
+    }
+
+    emfat_entry_t entries_[kLogs + 2] = {};
+    std::string names_[kLogs + 1];
+    emfat_t emfat_ = {};
+};
+
+TEST_F(EmfatLargeVolume, FindEntry)
+{
+    // Every cluster of every entry, from any starting point
+    for (int i = 0; i <= kLogs; i += 7) {
+        emfat_entry_t *e = &entries_[i];
+        EXPECT_EQ(find_entry(&emfat_, e->priv.first_clust, NULL), e);
+        EXPECT_EQ(find_entry(&emfat_, e->priv.last_reserved, &entries_[kLogs]), e);
+        EXPECT_EQ(find_entry(&emfat_, e->priv.first_clust + 1, &entries_[0]), e);
+    }
+
+    // Outside the volume
+    EXPECT_EQ(find_entry(&emfat_, 0, NULL), nullptr);
+    EXPECT_EQ(find_entry(&emfat_, 1, &entries_[10]), nullptr);
+    EXPECT_EQ(find_entry(&emfat_, emfat_.priv.num_clust + 2, &entries_[kLogs]), nullptr);
+}
+
+TEST_F(EmfatLargeVolume, SequentialReadThroughput)
+{
+    uint8_t data[512];
+    uint32_t eofCount = 0;
+    uint32_t chainErrors = 0;
+    uint32_t expectedLog = 1;
+    uint32_t expectedOffset = 0;
+    uint32_t dataErrors = 0;
+
+    ASSERT_GE(emfat_.vol_size, 128ULL * 1024 * 1024);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t sector = 0; sector < emfat_.disk_sectors; sector++) {
+        emfat_read(&emfat_, data, sector, 1);
+
+        if (sector >= emfat_.priv.fat1_lba && sector < emfat_.priv.fat2_lba) {
+            const uint32_t *values = (const uint32_t *)data;
+            const uint32_t first = (sector - emfat_.priv.fat1_lba) * 128;
+            for (uint32_t i = 0; i < 128; i++) {
+                const uint32_t clust = first + i;
+                if (clust < 2 || clust >= emfat_.priv.num_clust + 2) {
+                    continue;
+                }
+                if (values[i] == 0x0FFFFFFF) {
+                    eofCount++;
+                } else if (values[i] != clust + 1) {
+                    chainErrors++;
+                }
+            }
+        }
+        else if (sector >= emfat_.priv.root_lba + (entries_[1].priv.first_clust - 2) * 8) {
+            uint32_t log;
+            uint32_t offset;
+            memcpy(&log, data, sizeof(log));
+            memcpy(&offset, data + sizeof(log), sizeof(offset));
+
+            // Next file starts at the next cluster boundary
+            if (log == expectedLog + 1 && offset == 0) {
+                expectedLog++;
+                expectedOffset = 0;
+            }
+            if (log != expectedLog || offset != expectedOffset) {
+                dataErrors++;
+            }
+            expectedOffset += sizeof(data);
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(eofCount, kLogs + 1u);
+    EXPECT_EQ(chainErrors, 0u);
+    EXPECT_EQ(dataErrors, 0u);
+    EXPECT_EQ(expectedLog, (uint32_t)kLogs);
+
+    std::chrono::duration<double> elapsed = end - start;
+    std::cout << "Read " << emfat_.vol_size / (1024 * 1024) << " MB volume with " << kLogs << " files sector by sector = "
+              << emfat_.vol_size / (1024 * 1024) / elapsed.count() << " MB/s." << std::endl;
+}
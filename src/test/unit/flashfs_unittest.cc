@@ -146,6 +146,121 @@ TEST_F(FlashFSTestBase, flashfsWriteOverFlashSize)
     }
 }
 
+TEST_F(FlashFSTestBase, flashfsWritePartial)
+{
+    flashfsInit();
+
+    constexpr uint32_t kBufferSize = FLASHFS_WRITE_BUFFER_SIZE + 100;
+    auto buffer = std::make_unique<uint8_t[]>(kBufferSize);
+    memset(buffer.get(), 0x66, kBufferSize);
+
+    // Only the free space is taken, the rest is reported as not written
+    EXPECT_EQ(flashfsWrite(buffer.get(), 100), 100);
+    EXPECT_EQ(flashfsWrite(buffer.get(), kBufferSize),
+              FLASHFS_WRITE_BUFFER_USABLE - 100);
+    EXPECT_EQ(flashfsGetWriteBufferFreeSpace(), 0);
+    EXPECT_EQ(flashfsWrite(buffer.get(), 1), 0);
+}
+
+TEST_F(FlashFSTestBase, flashfsWriteWraparound)
+{
+    flashfsInit();
+    blackboxConfigMutable()->rollingErase = false;
+
+    // Odd sized writes move the buffer head over the end of the ring at
+    // every possible offset
+    constexpr uint32_t kChunkSize = 97;
+    constexpr uint32_t kTotalSize = 64 * kChunkSize;
+    uint8_t chunk[kChunkSize];
+    uint8_t value = 0;
+
+    for (uint32_t written = 0; written < kTotalSize; written += kChunkSize) {
+        for (uint32_t i = 0; i < kChunkSize; i++) {
+            chunk[i] = value++;
+        }
+        EXPECT_EQ(flashfsWrite(chunk, kChunkSize), kChunkSize);
+        flashfsFlushSync();
+    }
+
+    EXPECT_EQ(tailAddress, kTotalSize);
+    for (uint32_t i = 0; i < kTotalSize; i++) {
+        ASSERT_EQ(flash_emulator_->memory_[i], (uint8_t)i)
+            << "Mismatch address " << std::hex << i;
+    }
+}
+
+TEST_F(FlashFSTestBase, flashfsWriteReserveCommit)
+{
+    flashfsInit();
+    blackboxConfigMutable()->rollingErase = false;
+
+    constexpr uint32_t kTotalSize = 8 * FLASHFS_WRITE_BUFFER_SIZE;
+    uint32_t written = 0;
+
+    while (written < kTotalSize) {
+        uint8_t *data;
+        const uint32_t space = flashfsWriteReserve(&data);
+        ASSERT_GT(space, 0);
+        ASSERT_LE(space, flashfsGetWriteBufferFreeSpace());
+
+        // Commit a bit less than reserved to leave the head unaligned
+        const uint32_t count = std::min(space, 89U);
+        for (uint32_t i = 0; i < count; i++) {
+            data[i] = written + i;
+        }
+        flashfsWriteCommit(count);
+        written += count;
+
+        if (flashfsGetWriteBufferFreeSpace() < 100) {
+            flashfsFlushSync();
+        }
+    }
+    flashfsFlushSync();
+
+    EXPECT_EQ(tailAddress, written);
+    for (uint32_t i = 0; i < written; i++) {
+        ASSERT_EQ(flash_emulator_->memory_[i], (uint8_t)i)
+            << "Mismatch address " << std::hex << i;
+    }
+}
+
+TEST_F(FlashFSTestBase, flashfsWriteThroughput)
+{
+    flashfsInit();
+
+    constexpr uint32_t kChunkSize = 128;
+    constexpr uint32_t kRounds = 100000;
+    uint8_t chunk[kChunkSize];
+    memset(chunk, 0x77, kChunkSize);
+
+    // Fill the buffer up and then drain it without touching the flash
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < kRounds; round++) {
+        for (int i = 0; i < 3; i++) {
+            for (uint32_t j = 0; j < kChunkSize; j++) {
+                flashfsWriteByte(chunk[j]);
+            }
+        }
+        flashfsClearBuffer();
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < kRounds; round++) {
+        for (int i = 0; i < 3; i++) {
+            flashfsWrite(chunk, kChunkSize);
+        }
+        flashfsClearBuffer();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    const double bytes = 3.0 * kChunkSize * kRounds;
+    std::chrono::duration<double> byteSeconds = middle - start;
+    std::chrono::duration<double> bulkSeconds = end - middle;
+    std::cout << "Byte write throughput = "
+              << bytes / byteSeconds.count() / 1e6 << " MB/s." << std::endl;
+    std::cout << "Bulk write throughput = "
+              << bytes / bulkSeconds.count() / 1e6 << " MB/s." << std::endl;
+}
+
 class FlashFSBandwidthTest
     : public FlashFSTestBase,
       public testing::WithParamInterface<FlashEmulator::FlashType> {
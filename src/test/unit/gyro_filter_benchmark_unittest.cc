@@ -0,0 +1,613 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Host benchmark for the gyro filter chain.
+ *
+ * Replays a gyro stream through the RPM filter, the static lowpass and
+ * notch filters and the dynamic notch, and reports the cost of every
+ * stage in ns per gyro sample (all three axes). Each stage is checked
+ * against a budget, so a regression fails the test. The fast notch
+ * coefficient update is also checked for accuracy and compared against
+ * the generic biquad update.
+ *
+ * Wall clock timings are meaningless on a loaded machine (make -j test),
+ * so the timing tests are skipped unless GYRO_BENCH_TIMING is set in the
+ * environment, e.g. by "make benchmark". The correctness tests always run.
+ *
+ * The stream is synthetic (rotor harmonics + noise) unless the
+ * environment variable GYRO_BENCH_INPUT names a CSV file with one
+ * "roll,pitch,yaw" sample in deg/s per line, recorded at 8kHz.
+ *
+ * The budgets are host nanoseconds, not MCU cycles. They can be scaled
+ * for slow or instrumented build machines with GYRO_BENCH_BUDGET_SCALE.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "platform.h"
+
+#include "build/debug.h"
+
+#include "common/filter.h"
+#include "common/maths.h"
+#include "common/rfft.h"
+
+#include "config/feature.h"
+
+#include "drivers/time.h"
+
+#include "fc/runtime_config.h"
+
+#include "flight/dyn_notch_filter.h"
+#include "flight/rpm_filter.h"
+
+#include "pg/dyn_notch.h"
+#include "pg/rpm_filter.h"
+
+#include "sensors/gyro.h"
+
+void benchFilterGyro(void);
+}
+
+#define BENCH_GYRO_RATE_HZ      8000
+#define BENCH_SAMPLE_COUNT      16000
+#define BENCH_WARMUP_COUNT      2000
+
+#define BENCH_MAIN_GEAR_RATIO   (1.0f / 10.0f)
+#define BENCH_TAIL_GEAR_RATIO   (4.5f / 10.0f)
+#define BENCH_MOTOR_RPM         20000.0f
+
+static float mainGearRatio = BENCH_MAIN_GEAR_RATIO;
+static float tailGearRatio = BENCH_TAIL_GEAR_RATIO;
+static float motorRPM = BENCH_MOTOR_RPM;
+
+extern "C" {
+gyro_t gyro;
+
+bool featureIsEnabled(const uint32_t) { return true; }
+void setArmingDisabled(armingDisableFlags_e) {}
+float schedulerGetCycleTimeMultiplier(void) { return 1.0f; }
+bool isMotorFastRpmSourceActive(uint8_t) { return true; }
+float getMotorRPMf(uint8_t) { return motorRPM; }
+float getMainGearRatio(void) { return mainGearRatio; }
+float getTailGearRatio(void) { return tailGearRatio; }
+float getThrottle(void) { return 0.5f; }
+timeUs_t micros(void) { return 0; }
+}
+
+
+/*
+ * Gyro streams
+ */
+
+typedef std::vector<std::array<float,XYZ_AXIS_COUNT>> gyroStream_t;
+
+static gyroStream_t syntheticStream(int count)
+{
+    gyroStream_t stream(count);
+
+    const float headHz = motorRPM * mainGearRatio / 60;
+    const float tailHz = motorRPM * tailGearRatio / 60;
+
+    uint32_t seed = 0x12345678;
+
+    for (int n = 0; n < count; n++) {
+        const float t = (float)n / BENCH_GYRO_RATE_HZ;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            float value = 20 * sinf(0.5f * M_2PIf * t + axis);
+            for (int h = 1; h <= 4; h++)
+                value += (40.0f / h) * sinf(M_2PIf * headHz * h * t + axis * h);
+            for (int h = 1; h <= 2; h++)
+                value += (30.0f / h) * sinf(M_2PIf * tailHz * h * t + axis * h);
+            seed = seed * 1664525 + 1013904223;
+            value += 10.0f * ((float)(seed >> 8) / (1 << 24) - 0.5f);
+            stream[n][axis] = value;
+        }
+    }
+
+    return stream;
+}
+
+static gyroStream_t recordedStream(const char *path)
+{
+    gyroStream_t stream;
+    std::ifstream file(path);
+    std::string line;
+
+    while (std::getline(file, line)) {
+        std::array<float,XYZ_AXIS_COUNT> sample;
+        char sep;
+        std::istringstream in(line);
+        if (in >> sample[0] >> sep >> sample[1] >> sep >> sample[2])
+            stream.push_back(sample);
+    }
+
+    return stream;
+}
+
+static const gyroStream_t& benchStream(void)
+{
+    static gyroStream_t stream;
+
+    if (stream.empty()) {
+        const char *path = getenv("GYRO_BENCH_INPUT");
+        if (path)
+            stream = recordedStream(path);
+        if (stream.empty())
+            stream = syntheticStream(BENCH_SAMPLE_COUNT);
+    }
+
+    return stream;
+}
+
+static bool timingEnabled(void)
+{
+    return getenv("GYRO_BENCH_TIMING") != NULL;
+}
+
+static float budgetScale(void)
+{
+    const char *scale = getenv("GYRO_BENCH_BUDGET_SCALE");
+    return scale ? fmaxf(atof(scale), 0.1f) : 1.0f;
+}
+
+
+/*
+ * Filter chain setup
+ */
+
+static void initGyroChain(int rpmPreset, int dynNotchCount, int dynNotchEngine = DYN_NOTCH_ENGINE_SDFT)
+{
+    memset(&gyro, 0, sizeof(gyro));
+
+    gyro.sampleRateHz = BENCH_GYRO_RATE_HZ;
+    gyro.filterRateHz = BENCH_GYRO_RATE_HZ;
+    gyro.targetRateHz = BENCH_GYRO_RATE_HZ;
+    gyro.sampleLooptime = 1000000 / BENCH_GYRO_RATE_HZ;
+    gyro.filterLooptime = 1000000 / BENCH_GYRO_RATE_HZ;
+    gyro.targetLooptime = 1000000 / BENCH_GYRO_RATE_HZ;
+
+    // Default gyro filter setup: LPF1 1st order @100Hz, LPF2 and notches off
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        lowpassFilterInit(&gyro.lowpassFilter[axis], LPF_1ST_ORDER, 100, gyro.filterRateHz, 0);
+        lowpassFilterInit(&gyro.lowpass2Filter[axis], LPF_NONE, 0, gyro.filterRateHz, 0);
+        notchFilterInit(&gyro.notchFilter1[axis], 0, 0, gyro.filterRateHz, 0);
+        notchFilterInit(&gyro.notchFilter2[axis], 0, 0, gyro.filterRateHz, 0);
+    }
+
+    rpmFilterConfig_t *rpmConfig = rpmFilterConfigMutable();
+    memset(rpmConfig, 0, sizeof(*rpmConfig));
+    rpmConfig->preset = rpmPreset;
+    rpmConfig->min_hz = 20;
+    validateAndFixRPMFilterConfig();
+    rpmFilterInit();
+
+    const dynNotchConfig_t dynConfig = {
+        .dyn_notch_count = (uint8_t)dynNotchCount,
+        .dyn_notch_q = 20,
+        .dyn_notch_min_hz = 20,
+        .dyn_notch_max_hz = 600,
+        .dyn_notch_engine = (uint8_t)dynNotchEngine,
+    };
+    dynNotchInit(&dynConfig);
+}
+
+
+/*
+ * Stage runner
+ */
+
+typedef enum {
+    STAGE_RPM_FILTER,
+    STAGE_LOWPASS,
+    STAGE_NOTCH,
+    STAGE_DYN_NOTCH,
+    STAGE_RPM_UPDATE,
+    STAGE_DYN_UPDATE,
+    STAGE_CHAIN,
+    STAGE_COUNT
+} stage_e;
+
+static const char * const stageNames[STAGE_COUNT] = {
+    "rpm_filter",
+    "lowpass",
+    "notch",
+    "dyn_notch",
+    "rpm_update",
+    "dyn_update",
+    "chain",
+};
+
+static volatile float benchSink;
+
+static void runStage(stage_e stage, const std::array<float,XYZ_AXIS_COUNT>& sample)
+{
+    float sink = 0;
+
+    switch (stage) {
+        case STAGE_RPM_FILTER: {
+            float values[XYZ_AXIS_COUNT] = { sample[0], sample[1], sample[2] };
+            rpmFilterGyro(values);
+            sink = values[0] + values[1] + values[2];
+            break;
+        }
+        case STAGE_LOWPASS:
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                float value = filterApply(&gyro.lowpass2Filter[axis], sample[axis]);
+                sink += filterApply(&gyro.lowpassFilter[axis], value);
+            }
+            break;
+        case STAGE_NOTCH:
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                float value = filterApply(&gyro.notchFilter2[axis], sample[axis]);
+                sink += filterApply(&gyro.notchFilter1[axis], value);
+            }
+            break;
+        case STAGE_DYN_NOTCH:
+            if (isDynNotchActive()) {
+                for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++)
+                    sink += dynNotchFilter(axis, sample[axis]);
+            }
+            break;
+        case STAGE_RPM_UPDATE:
+            rpmFilterUpdate();
+            break;
+        case STAGE_DYN_UPDATE:
+            if (isDynNotchActive())
+                dynNotchUpdate();
+            break;
+        case STAGE_CHAIN:
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++)
+                gyro.gyroADCd[axis] = sample[axis];
+            benchFilterGyro();
+            rpmFilterUpdate();
+            if (isDynNotchActive())
+                dynNotchUpdate();
+            sink = gyro.gyroADCf[0];
+            break;
+        default:
+            break;
+    }
+
+    benchSink = sink;
+}
+
+static double measureStage(stage_e stage, const gyroStream_t& stream)
+{
+    const int count = stream.size();
+
+    for (int n = 0; n < MIN(count, BENCH_WARMUP_COUNT); n++)
+        runStage(stage, stream[n]);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < count; n++)
+        runStage(stage, stream[n]);
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / count;
+}
+
+
+/*
+ * Budgets in host ns per gyro sample, measured on an unoptimised
+ * (-O0) unit test build with generous headroom.
+ */
+
+typedef struct {
+    int rpmPreset;
+    int dynNotchCount;
+    int dynNotchEngine;
+    double budget[STAGE_COUNT];
+} benchCase_t;
+
+static const benchCase_t benchCases[] = {
+    //  preset  dyn  engine                  rpm   lpf  notch  dyn   rpmupd  dynupd  chain
+    {   1,      0, DYN_NOTCH_ENGINE_SDFT,  { 1000,  250,  250,    50,   1000,   50,   3000 } },
+    {   1,      4, DYN_NOTCH_ENGINE_SDFT,  { 1000,  250,  250,  1000,   1000, 1500,   5000 } },
+    {   2,      0, DYN_NOTCH_ENGINE_SDFT,  { 1500,  250,  250,    50,   2000,   50,   3500 } },
+    {   2,      4, DYN_NOTCH_ENGINE_SDFT,  { 1500,  250,  250,  1000,   2000, 1500,   5500 } },
+    {   3,      0, DYN_NOTCH_ENGINE_SDFT,  { 2500,  250,  250,    50,   3000,   50,   4500 } },
+    {   3,      2, DYN_NOTCH_ENGINE_SDFT,  { 2500,  250,  250,   600,   3000, 1500,   5500 } },
+    {   3,      4, DYN_NOTCH_ENGINE_SDFT,  { 2500,  250,  250,  1000,   3000, 1500,   6500 } },
+    {   3,      8, DYN_NOTCH_ENGINE_SDFT,  { 2500,  250,  250,  2000,   3000, 1500,   8000 } },
+    {   3,      4, DYN_NOTCH_ENGINE_FFT,   { 2500,  250,  250,  1000,   3000, 1500,   6500 } },
+    {   3,      8, DYN_NOTCH_ENGINE_FFT,   { 2500,  250,  250,  2000,   3000, 1500,   8000 } },
+};
+
+class GyroFilterBenchmark : public ::testing::TestWithParam<benchCase_t> {};
+
+TEST_P(GyroFilterBenchmark, StageBudget)
+{
+    if (!timingEnabled()) {
+        GTEST_SKIP();
+    }
+
+    const benchCase_t& bench = GetParam();
+    const gyroStream_t& stream = benchStream();
+    const float scale = budgetScale();
+
+    ASSERT_GT(stream.size(), 0u);
+
+    printf("preset %d dyn_notch %d %s (%zu samples)\n", bench.rpmPreset, bench.dynNotchCount,
+        (bench.dynNotchEngine == DYN_NOTCH_ENGINE_FFT) ? "fft" : "sdft", stream.size());
+
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        initGyroChain(bench.rpmPreset, bench.dynNotchCount, bench.dynNotchEngine);
+
+        const double nsPerSample = measureStage((stage_e)stage, stream);
+        const double budget = bench.budget[stage] * scale;
+
+        printf("  %-12s %9.1f ns/sample  (budget %7.0f)\n", stageNames[stage], nsPerSample, budget);
+
+        EXPECT_LT(nsPerSample, budget) << "stage " << stageNames[stage];
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Presets, GyroFilterBenchmark, ::testing::ValuesIn(benchCases),
+    [](const ::testing::TestParamInfo<benchCase_t>& info) {
+        return "Preset" + std::to_string(info.param.rpmPreset) + "_DynNotch" + std::to_string(info.param.dynNotchCount) +
+            ((info.param.dynNotchEngine == DYN_NOTCH_ENGINE_FFT) ? "_FFT" : "");
+    });
+
+
+/*
+ * Sanity check: the chain must actually remove the rotor harmonics
+ */
+
+TEST(GyroFilterChain, AttenuatesRotorHarmonics)
+{
+    const gyroStream_t& stream = syntheticStream(BENCH_SAMPLE_COUNT);
+
+    initGyroChain(2, 0);
+
+    double energyIn = 0, energyOut = 0;
+
+    for (size_t n = 0; n < stream.size(); n++) {
+        runStage(STAGE_CHAIN, stream[n]);
+        if (n >= BENCH_WARMUP_COUNT) {
+            energyIn += sq(stream[n][0]);
+            energyOut += sq(gyro.gyroADCf[0]);
+        }
+    }
+
+    EXPECT_LT(energyOut, 0.2 * energyIn);
+}
+
+TEST(GyroFilterChain, RpmNotchBankMatchesBiquadCascade)
+{
+    const gyroStream_t& stream = syntheticStream(BENCH_SAMPLE_COUNT);
+
+    initGyroChain(1, 0);
+
+    // Low vibration preset, roll axis: 1x, 2x main rotor and 1x tail rotor
+    const float headHz = motorRPM * mainGearRatio / 60;
+    const float tailHz = motorRPM * tailGearRatio / 60;
+    const float centers[3] = { headHz, 2 * headHz, tailHz };
+    const float qs[3] = { 8.0f, 4.0f, 5.0f };
+
+    // Same coefficient engine as the RPM filter
+    biquadFilter_t reference[3];
+    for (int i = 0; i < 3; i++) {
+        biquadFilterInit(&reference[i], centers[i], BENCH_GYRO_RATE_HZ, qs[i], BIQUAD_NOTCH);
+        biquadNotchUpdate(&reference[i], centers[i], BENCH_GYRO_RATE_HZ, qs[i]);
+    }
+
+    // A single update sets the coefficients and fader of all banks
+    rpmFilterUpdate();
+
+    for (size_t n = 0; n < stream.size(); n++) {
+        float values[XYZ_AXIS_COUNT] = { stream[n][0], stream[n][1], stream[n][2] };
+        rpmFilterGyro(values);
+
+        float expected = stream[n][0];
+        for (int i = 0; i < 3; i++)
+            expected = biquadFilterApplyDF1(&reference[i], expected);
+
+        // Same filter, different rounding in the factored notch form
+        ASSERT_NEAR(expected, values[0], 0.05f) << "sample " << n;
+    }
+}
+
+
+/*
+ * Fast notch coefficients vs. the exact double precision formula
+ */
+
+TEST(NotchCoeffs, MatchExactCoefficients)
+{
+    const float sampleRates[] = { 1000, 4000, 8000 };
+    const float qs[] = { 0.5f, 2.5f, 5.0f, 10.0f, 25.0f };
+
+    for (float sampleRate : sampleRates) {
+        for (float Q : qs) {
+            for (float cutoff = 1; cutoff < sampleRate / 2; cutoff += 1.25f) {
+                biquadFilter_t filter;
+                biquadNotchUpdate(&filter, cutoff, sampleRate, Q);
+
+                const double omega = 2 * M_PI * fmin(cutoff, 0.475 * sampleRate) / sampleRate;
+                const double alpha = sin(omega) / (2 * Q);
+                const double a0 = 1 + alpha;
+
+                ASSERT_NEAR(1 / a0, filter.b0, 1e-5) << "cutoff " << cutoff << " Q " << Q;
+                ASSERT_NEAR(-2 * cos(omega) / a0, filter.b1, 1e-5) << "cutoff " << cutoff << " Q " << Q;
+                ASSERT_NEAR((1 - alpha) / a0, filter.a2, 1e-5) << "cutoff " << cutoff << " Q " << Q;
+                ASSERT_EQ(filter.b0, filter.b2);
+                ASSERT_EQ(filter.b1, filter.a1);
+            }
+        }
+    }
+}
+
+TEST(NotchCoeffs, FasterThanGenericUpdate)
+{
+    if (!timingEnabled()) {
+        GTEST_SKIP();
+    }
+
+    const int count = 100000;
+    biquadFilter_t filter;
+    volatile float sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < count; n++) {
+        biquadFilterUpdate(&filter, 20 + (n & 511), BENCH_GYRO_RATE_HZ, 5.0f, BIQUAD_NOTCH);
+        sink = sink + filter.b1;
+    }
+    const double genericNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+
+    start = std::chrono::steady_clock::now();
+    for (int n = 0; n < count; n++) {
+        biquadNotchUpdate(&filter, 20 + (n & 511), BENCH_GYRO_RATE_HZ, 5.0f);
+        sink = sink + filter.b1;
+    }
+    const double notchNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+
+    printf("  biquadFilterUpdate %7.1f ns/call\n", genericNs);
+    printf("  biquadNotchUpdate  %7.1f ns/call\n", notchNs);
+
+    EXPECT_LT(notchNs, genericNs);
+}
+
+
+/*
+ * Dynamic notch spectrum engines
+ */
+
+TEST(DynNotchSpectrum, RfftMatchesWindowedDft)
+{
+    static rfft_t fft;
+    static float work[RFFT_SAMPLE_SIZE];
+    static float output[RFFT_BIN_COUNT];
+    static float samples[RFFT_SAMPLE_SIZE];
+
+    rfftInit(&fft, 1, RFFT_BIN_COUNT - 1);
+
+    uint32_t seed = 1;
+    for (int n = 0; n < RFFT_SAMPLE_SIZE; n++) {
+        seed = seed * 1664525 + 1013904223;
+        samples[n] = 50 * sinf(M_2PIf * 7.3f * n / RFFT_SAMPLE_SIZE) + ((seed >> 8) & 0xff) / 25.6f - 5;
+        rfftPush(&fft, samples[n]);
+    }
+
+    int calls = 1;
+    while (!rfftProcess(&fft, work, output))
+        calls++;
+
+    // Processed in batches, not in one go
+    EXPECT_GT(calls, RFFT_SAMPLE_SIZE / RFFT_BATCH_SIZE);
+
+    double peak = 0;
+    for (int k = 1; k < RFFT_BIN_COUNT; k++) {
+        double re = 0, im = 0;
+        for (int n = 0; n < RFFT_SAMPLE_SIZE; n++) {
+            const double w = 0.5 - 0.5 * cos(2 * M_PI * n / RFFT_SAMPLE_SIZE);
+            re += w * samples[n] * cos(2 * M_PI * k * n / RFFT_SAMPLE_SIZE);
+            im -= w * samples[n] * sin(2 * M_PI * k * n / RFFT_SAMPLE_SIZE);
+        }
+        const double magSq = re * re + im * im;
+        peak = fmax(peak, magSq);
+
+        ASSERT_NEAR(magSq, output[k], 1e-3 * peak + 1) << "bin " << k;
+    }
+}
+
+TEST(DynNotchSpectrum, BothEnginesTrackTone)
+{
+    const int engines[] = { DYN_NOTCH_ENGINE_SDFT, DYN_NOTCH_ENGINE_FFT };
+
+    for (int engine : engines) {
+        initGyroChain(0, 1, engine);
+
+        double energyIn = 0, energyOut = 0;
+
+        for (int n = 0; n < BENCH_SAMPLE_COUNT; n++) {
+            const float input = 100 * sinf(M_2PIf * 173 * n / BENCH_GYRO_RATE_HZ);
+            float output = 0;
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++)
+                output = dynNotchFilter(axis, input);
+            dynNotchUpdate();
+            if (n >= BENCH_SAMPLE_COUNT / 2) {
+                energyIn += sq(input);
+                energyOut += sq(output);
+            }
+        }
+
+        EXPECT_LT(energyOut, 0.05 * energyIn) << "engine " << engine;
+    }
+}
+
+static bool dynNotchFreqNear(float hz, float tolerance)
+{
+    for (int p = 0; p < DYN_NOTCH_COUNT_MAX; p++) {
+        if (fabsf(debug[p] / 10.0f - hz) < tolerance)
+            return true;
+    }
+    return false;
+}
+
+TEST(DynNotchSpectrum, TrackedPeaksFollowToneSteps)
+{
+    const int engines[] = { DYN_NOTCH_ENGINE_SDFT, DYN_NOTCH_ENGINE_FFT };
+
+    debugMode = DEBUG_DYN_NOTCH_FREQ;
+    debugAxis = 0;
+
+    for (int engine : engines) {
+        initGyroChain(0, DYN_NOTCH_COUNT_MAX, engine);
+
+        // Two tones over noise, the second one moving after 1s
+        uint32_t seed = 1;
+        int checks = 0, found = 0;
+
+        for (int n = 0; n < 2 * BENCH_SAMPLE_COUNT; n++) {
+            const float t = (float)n / BENCH_GYRO_RATE_HZ;
+            const float hz = (n < BENCH_SAMPLE_COUNT) ? 310 : 380;
+            seed = seed * 1664525 + 1013904223;
+            const float noise = ((seed >> 8) & 0xff) / 64.0f - 2;
+            const float input = 100 * sinf(M_2PIf * 130 * t) + 60 * sinf(M_2PIf * hz * t) + noise;
+
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++)
+                dynNotchFilter(axis, input);
+            dynNotchUpdate();
+
+            if (n >= 3 * BENCH_SAMPLE_COUNT / 2 && (n % 100) == 0) {
+                checks++;
+                if (dynNotchFreqNear(130, 5) && dynNotchFreqNear(380, 5))
+                    found++;
+            }
+        }
+
+        EXPECT_EQ(checks, found) << "engine " << engine;
+    }
+
+    debugMode = DEBUG_NONE;
+}
@@ -0,0 +1,41 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+
+#include "platform.h"
+
+#include "build/debug.h"
+
+#include "flight/dyn_notch_filter.h"
+#include "flight/rpm_filter.h"
+
+#include "sensors/gyro.h"
+
+// Instantiate the gyro filter chain exactly as sensors/gyro.c does
+#define GYRO_FILTER_FUNCTION_NAME filterGyro
+#define GYRO_FILTER_DEBUG_SET(mode, index, value)
+#define GYRO_FILTER_AXIS_DEBUG_SET(axis, mode, index, value)
+#include "sensors/gyro_filter_impl.c"
+#undef GYRO_FILTER_FUNCTION_NAME
+#undef GYRO_FILTER_DEBUG_SET
+#undef GYRO_FILTER_AXIS_DEBUG_SET
+
+void benchFilterGyro(void)
+{
+    filterGyro();
+}
@@ -0,0 +1,181 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The coning test drives the integrator with the body rates of classic
+ * coning motion, whose true attitude is known analytically. The attitude
+ * is propagated at the IMU rate both from a single gyro sample (the old
+ * behaviour) and from the pre-integrated average rate, and the final
+ * errors are compared.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+
+    #include "sensors/gyro_integrator.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+
+#define GYRO_RATE_HZ    8000
+#define IMU_RATE_HZ     500
+
+typedef struct {
+    double w, x, y, z;
+} quat_t;
+
+static quat_t quatMul(const quat_t &a, const quat_t &b)
+{
+    return {
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+    };
+}
+
+// Same first order update as imuMahonyAHRSupdate(), followed by normalisation
+static quat_t quatPropagate(const quat_t &q, const double *rate, double dt)
+{
+    const quat_t r = { 0, rate[X] * 0.5 * dt, rate[Y] * 0.5 * dt, rate[Z] * 0.5 * dt };
+    const quat_t d = quatMul(q, r);
+    quat_t n = { q.w + d.w, q.x + d.x, q.y + d.y, q.z + d.z };
+    const double norm = sqrt(n.w * n.w + n.x * n.x + n.y * n.y + n.z * n.z);
+    n.w /= norm; n.x /= norm; n.y /= norm; n.z /= norm;
+    return n;
+}
+
+static double quatAngle(const quat_t &a, const quat_t &b)
+{
+    const double dot = fabs(a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z);
+    return 2 * acos(fmin(dot, 1.0));
+}
+
+// Classic coning: the rotation axis of half-angle a spins around X at frequency f
+typedef struct {
+    double a;
+    double omega;
+} coning_t;
+
+static quat_t coningAttitude(const coning_t &c, double t)
+{
+    return { cos(c.a / 2), 0, sin(c.a / 2) * cos(c.omega * t), sin(c.a / 2) * sin(c.omega * t) };
+}
+
+static void coningRate(const coning_t &c, double t, float *rate)
+{
+    const double s = sin(c.a / 2);
+    rate[X] = -2 * c.omega * s * s / M_RADf;
+    rate[Y] = -c.omega * sin(c.a) * sin(c.omega * t) / M_RADf;
+    rate[Z] =  c.omega * sin(c.a) * cos(c.omega * t) / M_RADf;
+}
+
+TEST(GyroIntegratorTest, Empty)
+{
+    gyroIntegrator_t integ;
+    float average[XYZ_AXIS_COUNT];
+
+    gyroIntegratorReset(&integ);
+    EXPECT_FALSE(gyroIntegratorGetAverage(&integ, average));
+}
+
+TEST(GyroIntegratorTest, ConstantRate)
+{
+    gyroIntegrator_t integ;
+    float average[XYZ_AXIS_COUNT];
+    const float rate[XYZ_AXIS_COUNT] = { 100, -250, 40 };
+
+    gyroIntegratorReset(&integ);
+
+    // The first sample only primes the trapezoid
+    gyroIntegratorUpdate(&integ, rate, 1.0f / GYRO_RATE_HZ);
+    EXPECT_TRUE(gyroIntegratorGetAverage(&integ, average));
+
+    for (int n = 0; n < 16; n++) {
+        gyroIntegratorUpdate(&integ, rate, 1.0f / GYRO_RATE_HZ);
+    }
+    EXPECT_TRUE(gyroIntegratorGetAverage(&integ, average));
+
+    // A fixed axis rotation has no coning term
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        EXPECT_NEAR(rate[axis], average[axis], 0.01f);
+    }
+
+    // Consumed
+    EXPECT_FALSE(gyroIntegratorGetAverage(&integ, average));
+}
+
+TEST(GyroIntegratorTest, Coning)
+{
+    gyroIntegrator_t integ;
+
+    // 0.5 deg half-angle at 110Hz, i.e. rotor vibration well above the IMU rate
+    const coning_t coning = { 0.5 * M_PI / 180, 2 * M_PI * 110 };
+    const double gyroDt = 1.0 / GYRO_RATE_HZ;
+    const double imuDt = 1.0 / IMU_RATE_HZ;
+    const int ratio = GYRO_RATE_HZ / IMU_RATE_HZ;
+    const int updates = 10 * IMU_RATE_HZ;
+
+    quat_t point = coningAttitude(coning, 0);
+    quat_t integrated = point;
+
+    float rate[XYZ_AXIS_COUNT];
+    float average[XYZ_AXIS_COUNT];
+    double value[XYZ_AXIS_COUNT];
+
+    gyroIntegratorReset(&integ);
+    coningRate(coning, 0, rate);
+    gyroIntegratorUpdate(&integ, rate, gyroDt);
+    gyroIntegratorGetAverage(&integ, average);
+
+    for (int k = 0; k < updates; k++) {
+        for (int n = 1; n <= ratio; n++) {
+            coningRate(coning, (k * ratio + n) * gyroDt, rate);
+            gyroIntegratorUpdate(&integ, rate, gyroDt);
+        }
+
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++)
+            value[axis] = rate[axis] * M_RADf;
+        point = quatPropagate(point, value, imuDt);
+
+        ASSERT_TRUE(gyroIntegratorGetAverage(&integ, average));
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++)
+            value[axis] = average[axis] * M_RADf;
+        integrated = quatPropagate(integrated, value, imuDt);
+    }
+
+    const quat_t truth = coningAttitude(coning, updates * imuDt);
+    const double pointError = quatAngle(truth, point) * 180 / M_PI;
+    const double integratedError = quatAngle(truth, integrated) * 180 / M_PI;
+
+    printf("coning error after %ds: point sample %.3f deg, pre-integrated %.3f deg\n",
+           updates / IMU_RATE_HZ, pointError, integratedError);
+
+    // Point sampling integrates the coning drift of 2*omega*sin^2(a/2)
+    EXPECT_GT(pointError, 1.0);
+    EXPECT_LT(integratedError, 0.1);
+    EXPECT_LT(integratedError * 20, pointError);
+}
@@ -0,0 +1,626 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Loopback tests of the MSP serial port processing. A fake serial port
+ * stands in for the MSP port; the test plays the host, writes MSPv2
+ * requests into the port and decodes the frames msp_serial pushes out.
+ * The streamed dataflash download is checked by reassembling the flash
+ * contents from the stream chunks.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/crc.h"
+    #include "common/huffman.h"
+    #include "common/maths.h"
+    #include "common/streambuf.h"
+
+    #include "drivers/serial.h"
+
+    #include "io/flashfs.h"
+    #include "io/serial.h"
+
+    #include "msp/msp.h"
+    #include "msp/msp_dataflash.h"
+    #include "msp/msp_protocol_v2_betaflight.h"
+    #include "msp/msp_serial.h"
+
+    #include "pg/serial.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+
+#define FLASH_IMAGE_SIZE    (64 * 1024)
+
+static std::vector<uint8_t> flashImage;
+static int flashReads;
+
+// Serial port seen by msp_serial
+static serialPort_t testPort;
+static serialPortConfig_t testPortConfig = {
+    .functionMask = FUNCTION_MSP,
+    .identifier = SERIAL_PORT_USART1,
+};
+static bool testPortConfigReturned;
+static std::deque<uint8_t> rxQueue;
+static std::vector<uint8_t> txData;
+static uint32_t txCapacity;
+static uint32_t txPending;
+static timeUs_t currentTimeUs;
+
+// Simple command answered with a single byte
+#define TEST_MSP_ECHO       1
+
+
+static void fillFlashImage(void)
+{
+    flashImage.resize(FLASH_IMAGE_SIZE);
+
+    // Log-like data, compressible but not trivially
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < flashImage.size(); i++) {
+        seed = seed * 1103515245 + 12345;
+        flashImage[i] = (i % 16 < 8) ? (seed >> 16) & 0x0F : i & 0xFF;
+    }
+}
+
+static void hostSend(uint16_t cmd, const std::vector<uint8_t> &payload)
+{
+    uint8_t header[5] = { 0, (uint8_t)(cmd & 0xFF), (uint8_t)(cmd >> 8), (uint8_t)(payload.size() & 0xFF), (uint8_t)(payload.size() >> 8) };
+
+    uint8_t crc = crc8_dvb_s2_update(0, header, sizeof(header));
+    crc = crc8_dvb_s2_update(crc, payload.data(), payload.size());
+
+    for (uint8_t c : { '$', 'X', '<' }) {
+        rxQueue.push_back(c);
+    }
+    rxQueue.insert(rxQueue.end(), header, header + sizeof(header));
+    rxQueue.insert(rxQueue.end(), payload.begin(), payload.end());
+    rxQueue.push_back(crc);
+}
+
+static void hostRequestStream(uint32_t address, uint32_t length, bool compress)
+{
+    std::vector<uint8_t> payload;
+
+    for (int i = 0; i < 4; i++) {
+        payload.push_back(address >> (i * 8));
+    }
+    for (int i = 0; i < 4; i++) {
+        payload.push_back(length >> (i * 8));
+    }
+    payload.push_back(compress);
+
+    hostSend(MSP2_DATAFLASH_STREAM, payload);
+}
+
+static uint32_t readLE(const uint8_t *data, int size)
+{
+    uint32_t value = 0;
+    for (int i = size - 1; i >= 0; i--) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+// Decodes the MSPv2 frames written to the port so far
+static std::vector<std::vector<uint8_t>> hostReceiveFrames(uint16_t expectedCmd)
+{
+    std::vector<std::vector<uint8_t>> frames;
+    size_t pos = 0;
+
+    while (pos < txData.size()) {
+        EXPECT_EQ(txData[pos], '$');
+        EXPECT_EQ(txData[pos + 1], 'X');
+        EXPECT_EQ(txData[pos + 2], '>');
+
+        const uint8_t *header = &txData[pos + 3];
+        EXPECT_EQ(readLE(header + 1, 2), expectedCmd);
+
+        const uint16_t size = readLE(header + 3, 2);
+        const uint8_t *payload = header + 5;
+
+        uint8_t crc = crc8_dvb_s2_update(0, header, 5);
+        crc = crc8_dvb_s2_update(crc, payload, size);
+        EXPECT_EQ(payload[size], crc);
+
+        frames.emplace_back(payload, payload + size);
+        pos += 3 + 5 + size + 1;
+    }
+
+    EXPECT_EQ(pos, txData.size());
+    txData.clear();
+
+    return frames;
+}
+
+static std::vector<uint8_t> huffmanDecode(const uint8_t *data, int size, int count)
+{
+    static std::map<std::pair<int, uint16_t>, uint8_t> codes;
+    if (codes.empty()) {
+        for (int c = 0; c < 256; c++) {
+            codes[{ huffmanTable[c].codeLen, huffmanTable[c].code >> (16 - huffmanTable[c].codeLen) }] = c;
+        }
+    }
+
+    std::vector<uint8_t> out;
+    int len = 0;
+    uint16_t code = 0;
+
+    for (int bit = 0; bit < size * 8 && (int)out.size() < count; bit++) {
+        code = (code << 1) | ((data[bit / 8] >> (7 - bit % 8)) & 1);
+        len++;
+        auto it = codes.find({ len, code });
+        if (it != codes.end()) {
+            out.push_back(it->second);
+            len = 0;
+            code = 0;
+        }
+    }
+
+    EXPECT_EQ((int)out.size(), count);
+    return out;
+}
+
+static mspResult_e testProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    // Same handling as msp.c
+    reply->cmd = cmd->cmd;
+    if (cmd->cmd == TEST_MSP_ECHO) {
+        sbufWriteU8(&reply->buf, sbufReadU8(&cmd->buf));
+        return MSP_RESULT_ACK;
+    }
+    if (cmd->cmd != MSP2_DATAFLASH_STREAM) {
+        return MSP_RESULT_ERROR;
+    }
+
+    const uint32_t address = sbufReadU32(&cmd->buf);
+    const uint32_t length = sbufReadU32(&cmd->buf);
+    const bool allowCompression = sbufBytesRemaining(&cmd->buf) ? sbufReadU8(&cmd->buf) : false;
+    if (length > 0) {
+        mspDataflashStreamStart(srcDesc, &reply->buf, address, length, allowCompression);
+    } else {
+        mspDataflashStreamStop(srcDesc);
+        sbufWriteU32(&reply->buf, address);
+        sbufWriteU32(&reply->buf, 0);
+        sbufWriteU8(&reply->buf, 0);
+    }
+
+    return MSP_RESULT_ACK;
+}
+
+static void testProcessReply(mspPacket_t *reply)
+{
+    UNUSED(reply);
+}
+
+static bool testProcessStream(mspDescriptor_t srcDesc, mspPacket_t *packet)
+{
+    if (mspDataflashStreamNext(srcDesc, &packet->buf)) {
+        packet->cmd = MSP2_DATAFLASH_STREAM;
+        packet->result = MSP_RESULT_ACK;
+        return true;
+    }
+    return false;
+}
+
+static void runSerialTask(timeDelta_t budgetUs = 0)
+{
+    mspSerialProcess(MSP_SKIP_NON_MSP_DATA, testProcessCommand, testProcessReply, testProcessStream, budgetUs);
+}
+
+class MspDataflashStreamTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        fillFlashImage();
+        flashReads = 0;
+        rxQueue.clear();
+        txData.clear();
+        txCapacity = 1400;
+        txPending = 0;
+        currentTimeUs = 0;
+
+        testPortConfigReturned = false;
+        mspSerialInit();
+    }
+
+    // Requests a range and runs the serial task until the end of the stream
+    std::vector<uint8_t> receiveStream(uint32_t address, uint32_t length, bool compress)
+    {
+        std::vector<uint8_t> data;
+        uint16_t sequence = 0;
+        bool replied = false;
+
+        hostRequestStream(address, length, compress);
+
+        ended = false;
+        runs = 0;
+        wireBytes = 0;
+        maxRunBytes = 0;
+
+        while (!ended && runs < 10000) {
+            runSerialTask();
+            runs++;
+
+            wireBytes += txData.size();
+            maxRunBytes = MAX(maxRunBytes, txPending);
+
+            for (const auto &frame : hostReceiveFrames(MSP2_DATAFLASH_STREAM)) {
+                EXPECT_FALSE(ended);
+
+                if (!replied) {
+                    // Request is acknowledged with the range served
+                    EXPECT_EQ(frame.size(), 9u);
+                    EXPECT_EQ(readLE(&frame[0], 4), address);
+                    servedLength = readLE(&frame[4], 4);
+                    EXPECT_EQ(frame[8], compress ? 1 : 0);
+                    replied = true;
+                    continue;
+                }
+
+                EXPECT_GE(frame.size(), 9u);
+                EXPECT_EQ(readLE(&frame[0], 2), sequence);
+                EXPECT_EQ(readLE(&frame[2], 4), address + data.size());
+
+                const uint16_t size = readLE(&frame[6], 2);
+                EXPECT_EQ(frame[8], compress ? 1 : 0);
+                EXPECT_EQ(frame.size(), 9u + size);
+
+                if (size == 0) {
+                    ended = true;
+                } else if (compress) {
+                    const uint16_t count = readLE(&frame[9], 2);
+                    const auto decoded = huffmanDecode(&frame[11], size - 2, count);
+                    data.insert(data.end(), decoded.begin(), decoded.end());
+                } else {
+                    data.insert(data.end(), frame.begin() + 9, frame.end());
+                }
+                sequence++;
+            }
+
+            // Port drains between runs
+            txPending = 0;
+        }
+
+        EXPECT_TRUE(replied);
+
+        return data;
+    }
+
+    bool ended;
+    int runs;
+    uint32_t servedLength;
+    size_t wireBytes;
+    uint32_t maxRunBytes;
+};
+
+TEST_F(MspDataflashStreamTest, WholeFlash)
+{
+    const auto data = receiveStream(0, FLASH_IMAGE_SIZE, false);
+
+    EXPECT_TRUE(ended);
+    EXPECT_EQ(servedLength, (uint32_t)FLASH_IMAGE_SIZE);
+    EXPECT_TRUE(data == flashImage);
+
+    // Flash is read in whole read-ahead blocks, once
+    EXPECT_EQ(flashReads, FLASH_IMAGE_SIZE / MSP_DATAFLASH_STREAM_BUFFER_SIZE);
+
+    // Every serial task run fills the TX buffer
+    EXPECT_LE(runs, FLASH_IMAGE_SIZE / (1400 - MSP_DATAFLASH_STREAM_CHUNK_MIN) + 2);
+}
+
+TEST_F(MspDataflashStreamTest, RunBudget)
+{
+    // Like serial_tcp, the port never fills up
+    txCapacity = 1 << 20;
+
+    const auto data = receiveStream(0, FLASH_IMAGE_SIZE, false);
+
+    EXPECT_TRUE(ended);
+    EXPECT_TRUE(data == flashImage);
+    EXPECT_LE(maxRunBytes, (uint32_t)MSP_PORT_STREAM_BYTES_PER_RUN + MSP_PORT_OUTBUF_SIZE + 16);
+    EXPECT_LE(runs, FLASH_IMAGE_SIZE / MSP_PORT_STREAM_BYTES_PER_RUN + 2);
+}
+
+TEST_F(MspDataflashStreamTest, Compressed)
+{
+    const auto data = receiveStream(0, FLASH_IMAGE_SIZE, true);
+
+    EXPECT_TRUE(ended);
+    EXPECT_TRUE(data == flashImage);
+    EXPECT_LT(wireBytes, (size_t)FLASH_IMAGE_SIZE);
+}
+
+TEST_F(MspDataflashStreamTest, SmallTxBuffer)
+{
+    // Like a UART, the port only takes what fits in its TX buffer
+    txCapacity = 256;
+
+    const auto data = receiveStream(0, FLASH_IMAGE_SIZE, false);
+
+    EXPECT_TRUE(ended);
+    EXPECT_TRUE(data == flashImage);
+    EXPECT_LE(maxRunBytes, 256u);
+    EXPECT_GE(runs, FLASH_IMAGE_SIZE / 256);
+}
+
+TEST_F(MspDataflashStreamTest, RangeClippedAtEnd)
+{
+    const uint32_t address = FLASH_IMAGE_SIZE - 1000;
+    const auto data = receiveStream(address, 5000, false);
+
+    EXPECT_TRUE(ended);
+    EXPECT_EQ(servedLength, 1000u);
+    EXPECT_TRUE(data == std::vector<uint8_t>(flashImage.begin() + address, flashImage.end()));
+}
+
+TEST_F(MspDataflashStreamTest, Stop)
+{
+    hostRequestStream(0, FLASH_IMAGE_SIZE, false);
+    runSerialTask();
+    EXPECT_GT(hostReceiveFrames(MSP2_DATAFLASH_STREAM).size(), 1u);
+    txPending = 0;
+
+    // Only the reply to the stop request follows
+    hostRequestStream(0, 0, false);
+    runSerialTask();
+    const auto frames = hostReceiveFrames(MSP2_DATAFLASH_STREAM);
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].size(), 9u);
+    EXPECT_EQ(readLE(&frames[0][4], 4), 0u);
+    txPending = 0;
+
+    runSerialTask();
+    EXPECT_TRUE(txData.empty());
+}
+
+class MspSerialBudgetTest : public MspDataflashStreamTest
+{
+  protected:
+    void sendEchoCommands(int count)
+    {
+        for (int i = 0; i < count; i++) {
+            hostSend(TEST_MSP_ECHO, { (uint8_t)i });
+        }
+    }
+
+    // Runs the serial task once, returns the echoed values
+    std::vector<uint8_t> receiveEchoes(timeDelta_t budgetUs)
+    {
+        std::vector<uint8_t> values;
+
+        runSerialTask(budgetUs);
+        for (const auto &frame : hostReceiveFrames(TEST_MSP_ECHO)) {
+            EXPECT_EQ(frame.size(), 1u);
+            values.push_back(frame[0]);
+        }
+        txPending = 0;
+
+        return values;
+    }
+};
+
+TEST_F(MspSerialBudgetTest, OneCommandWithoutBudget)
+{
+    sendEchoCommands(3);
+
+    EXPECT_EQ(receiveEchoes(0), std::vector<uint8_t>({ 0 }));
+    EXPECT_EQ(receiveEchoes(0), std::vector<uint8_t>({ 1 }));
+    EXPECT_EQ(receiveEchoes(0), std::vector<uint8_t>({ 2 }));
+    EXPECT_TRUE(receiveEchoes(0).empty());
+}
+
+TEST_F(MspSerialBudgetTest, BurstWithinBudget)
+{
+    sendEchoCommands(20);
+
+    // Each micros() call advances 10us, one call per command
+    const auto first = receiveEchoes(50);
+    EXPECT_EQ(first, std::vector<uint8_t>({ 0, 1, 2, 3, 4 }));
+
+    const auto rest = receiveEchoes(1000);
+    EXPECT_EQ(rest.size(), 15u);
+    EXPECT_EQ(rest.front(), 5);
+    EXPECT_EQ(rest.back(), 19);
+}
+
+TEST_F(MspSerialBudgetTest, BurstLimitedByTxBuffer)
+{
+    // Room for the first few replies only, the rest must not be dropped
+    txCapacity = MSP_PORT_OUTBUF_SIZE_MIN + MSP_MAX_HEADER_SIZE + 2 + 3 * 10;
+
+    sendEchoCommands(10);
+
+    const auto first = receiveEchoes(1000);
+    EXPECT_EQ(first.size(), 4u);
+
+    std::vector<uint8_t> all = first;
+    while (all.size() < 10) {
+        const auto more = receiveEchoes(1000);
+        ASSERT_FALSE(more.empty());
+        all.insert(all.end(), more.begin(), more.end());
+    }
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(all[i], i);
+    }
+}
+
+// STUBS
+extern "C" {
+    serialConfig_t serialConfig_System;
+
+    const uint32_t baudRates[] = { 0, 9600, 19200, 38400, 57600, 115200 };
+
+    uint32_t flashfsGetSize(void)
+    {
+        return flashImage.size();
+    }
+
+    int flashfsReadAbs(uint32_t offset, uint8_t *data, unsigned int len)
+    {
+        flashReads++;
+
+        if (offset >= flashImage.size()) {
+            return 0;
+        }
+        len = MIN(len, flashImage.size() - offset);
+        memcpy(data, &flashImage[offset], len);
+        return len;
+    }
+
+    mspDescriptor_t mspDescriptorAlloc(void)
+    {
+        return 1;
+    }
+
+    const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function)
+    {
+        EXPECT_EQ(function, FUNCTION_MSP);
+        if (testPortConfigReturned) {
+            return NULL;
+        }
+        testPortConfigReturned = true;
+        return &testPortConfig;
+    }
+
+    const serialPortConfig_t *findNextSerialPortConfig(serialPortFunction_e function)
+    {
+        UNUSED(function);
+        return NULL;
+    }
+
+    bool isSerialPortShared(const serialPortConfig_t *portConfig, uint16_t functionMask, serialPortFunction_e sharedWithFunction)
+    {
+        UNUSED(portConfig);
+        UNUSED(functionMask);
+        UNUSED(sharedWithFunction);
+        return false;
+    }
+
+    serialPort_t *openSerialPort(serialPortIdentifier_e identifier, serialPortFunction_e function, serialReceiveCallbackPtr callback,
+                                 void *callbackData, uint32_t baudrate, portMode_e mode, portOptions_e options)
+    {
+        UNUSED(identifier);
+        UNUSED(function);
+        UNUSED(callback);
+        UNUSED(callbackData);
+        UNUSED(baudrate);
+        UNUSED(mode);
+        UNUSED(options);
+        return &testPort;
+    }
+
+    void closeSerialPort(serialPort_t *serialPort)
+    {
+        UNUSED(serialPort);
+    }
+
+    void waitForSerialPortToFinishTransmitting(serialPort_t *serialPort)
+    {
+        UNUSED(serialPort);
+    }
+
+    uint32_t serialRxBytesWaiting(const serialPort_t *instance)
+    {
+        UNUSED(instance);
+        return rxQueue.size();
+    }
+
+    // Short runs, so that frames straddle the end of a run like a wrapping ring
+    uint32_t serialPeekRx(serialPort_t *instance, const uint8_t **data)
+    {
+        UNUSED(instance);
+        static uint8_t run[7];
+        const uint32_t count = std::min(rxQueue.size(), sizeof(run));
+        std::copy(rxQueue.begin(), rxQueue.begin() + count, run);
+        *data = run;
+        return count;
+    }
+
+    void serialConsumeRx(serialPort_t *instance, uint32_t count)
+    {
+        UNUSED(instance);
+        EXPECT_LE(count, rxQueue.size());
+        rxQueue.erase(rxQueue.begin(), rxQueue.begin() + count);
+    }
+
+    uint32_t serialTxBytesFree(const serialPort_t *instance)
+    {
+        UNUSED(instance);
+        return txCapacity - txPending;
+    }
+
+    bool isSerialTransmitBufferEmpty(const serialPort_t *instance)
+    {
+        UNUSED(instance);
+        return txPending == 0;
+    }
+
+    void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
+    {
+        UNUSED(instance);
+        txData.insert(txData.end(), data, data + count);
+        txPending += count;
+    }
+
+    void serialBeginWrite(serialPort_t *instance)
+    {
+        UNUSED(instance);
+    }
+
+    void serialEndWrite(serialPort_t *instance)
+    {
+        UNUSED(instance);
+    }
+
+    timeUs_t micros(void)
+    {
+        currentTimeUs += 10;
+        return currentTimeUs;
+    }
+
+    uint32_t millis(void)
+    {
+        return 0;
+    }
+
+    void systemReset(int reason)
+    {
+        UNUSED(reason);
+    }
+
+    void cliEnter(serialPort_t *serialPort)
+    {
+        UNUSED(serialPort);
+    }
+}
@@ -0,0 +1,168 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "fc/pid_subtask.h"
+
+    #include "scheduler/scheduler.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static const int chain[] = {
+    PID_SUBTASK_POSITION,
+    PID_SUBTASK_SETPOINT,
+    PID_SUBTASK_PID_CONTROLLER,
+    PID_SUBTASK_MIXER,
+    PID_SUBTASK_MOTORS_SERVOS,
+    PID_SUBTASK_BLACKBOX_UPDATE,
+};
+
+static int tasksInSlot(int slot)
+{
+    int count = 0;
+    for (int index = 0; index < PID_SUBTASK_COUNT; index++) {
+        if (pidSubTaskGetSlot(index) == slot)
+            count++;
+    }
+    return count;
+}
+
+static void expectDependencyOrder(void)
+{
+    for (unsigned i = 1; i < ARRAYLEN(chain); i++) {
+        EXPECT_LE(pidSubTaskGetSlot(chain[i - 1]), pidSubTaskGetSlot(chain[i]));
+    }
+}
+
+// Run a number of PID cycles with the given sub-task costs
+static void runCycles(int cycles, const uint32_t *cost10thUs)
+{
+    const int slotCount = pidSubTaskGetSlotCount();
+
+    for (int cycle = 0; cycle < cycles; cycle++) {
+        for (int slot = 0; slot < slotCount; slot++) {
+            if (slot == 0)
+                pidSubTaskApply();
+            for (int index = 0; index < PID_SUBTASK_COUNT; index++) {
+                if (pidSubTaskGetSlot(index) == slot)
+                    pidSubTaskRecord(index, cost10thUs[index]);
+            }
+            if (slot == pidSubTaskGetIdleSlot())
+                pidSubTaskIdle();
+        }
+    }
+}
+
+TEST(PidSubTaskTest, SingleSlotAfterReset)
+{
+    pidSubTaskReset(1);
+
+    EXPECT_EQ(1, pidSubTaskGetSlotCount());
+    EXPECT_EQ(PID_SUBTASK_COUNT, tasksInSlot(0));
+    EXPECT_EQ(0, pidSubTaskGetIdleSlot());
+}
+
+TEST(PidSubTaskTest, SpreadRightAfterReset)
+{
+    // Equal costs before anything is measured: two sub-tasks per slot
+    pidSubTaskReset(4);
+
+    EXPECT_EQ(4, pidSubTaskGetSlotCount());
+    for (int slot = 0; slot < 4; slot++) {
+        EXPECT_EQ(2, tasksInSlot(slot)) << "slot " << slot;
+    }
+    expectDependencyOrder();
+
+    pidSubTaskReset(2);
+
+    EXPECT_EQ(4, tasksInSlot(0));
+    EXPECT_EQ(4, tasksInSlot(1));
+    expectDependencyOrder();
+}
+
+TEST(PidSubTaskTest, ResetForgetsMeasurements)
+{
+    const uint32_t cost[PID_SUBTASK_COUNT] = { 10, 10, 500, 50, 50, 20, 20, 300 };
+
+    pidSubTaskReset(4);
+    runCycles(PID_SUBTASK_REPLAN_CYCLES, cost);
+    EXPECT_GT(pidSubTaskGetAverageTime(PID_SUBTASK_PID_CONTROLLER), 0u);
+
+    pidSubTaskReset(4);
+    for (int index = 0; index < PID_SUBTASK_COUNT; index++) {
+        EXPECT_EQ(0u, pidSubTaskGetAverageTime(index));
+    }
+    for (int slot = 0; slot < 4; slot++) {
+        EXPECT_EQ(2, tasksInSlot(slot));
+    }
+}
+
+TEST(PidSubTaskTest, ReplanFromMeasuredCosts)
+{
+    // The PID controller and the blackbox flush dominate
+    const uint32_t cost[PID_SUBTASK_COUNT] = { 10, 10, 500, 50, 50, 20, 20, 400 };
+
+    pidSubTaskReset(4);
+    runCycles(PID_SUBTASK_REPLAN_CYCLES * 2 + 1, cost);
+
+    // The heavy sub-tasks end up in different slots, and no slot
+    // takes longer than the PID controller alone
+    const int pidSlot = pidSubTaskGetSlot(PID_SUBTASK_PID_CONTROLLER);
+    const int flushSlot = pidSubTaskGetSlot(PID_SUBTASK_BLACKBOX_FLUSH);
+
+    EXPECT_NE(pidSlot, flushSlot);
+    EXPECT_EQ(1, tasksInSlot(pidSlot));
+    for (int slot = 0; slot < 4; slot++) {
+        uint32_t load = 0;
+        for (int index = 0; index < PID_SUBTASK_COUNT; index++) {
+            if (pidSubTaskGetSlot(index) == slot)
+                load += pidSubTaskGetAverageTime(index);
+        }
+        EXPECT_LE(load, cost[PID_SUBTASK_PID_CONTROLLER]) << "slot " << slot;
+    }
+    expectDependencyOrder();
+
+    // The planner runs in a slot without a heavy sub-task
+    EXPECT_NE(pidSlot, pidSubTaskGetIdleSlot());
+    EXPECT_NE(flushSlot, pidSubTaskGetIdleSlot());
+}
+
+TEST(PidSubTaskTest, KeepPlanWithoutClearGain)
+{
+    const uint32_t cost[PID_SUBTASK_COUNT] = { 10, 10, 10, 10, 10, 10, 10, 10 };
+    uint8_t slots[PID_SUBTASK_COUNT];
+
+    pidSubTaskReset(4);
+    for (int index = 0; index < PID_SUBTASK_COUNT; index++) {
+        slots[index] = pidSubTaskGetSlot(index);
+    }
+
+    runCycles(PID_SUBTASK_REPLAN_CYCLES * 3, cost);
+
+    for (int index = 0; index < PID_SUBTASK_COUNT; index++) {
+        EXPECT_EQ(slots[index], pidSubTaskGetSlot(index));
+    }
+}
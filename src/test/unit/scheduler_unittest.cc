@@ -17,6 +17,8 @@
 
 #include <stdint.h>
 
+#include <chrono>
+
 extern "C" {
     #include "drivers/accgyro/accgyro.h"
     #include "platform.h"
@@ -50,12 +52,13 @@ const int TEST_IMU_UPDATE_TIME = 5;
 const int TEST_DISPATCH_TIME = 200;
 const int TEST_UPDATE_OSD_CHECK_TIME = 5;
 const int TEST_UPDATE_OSD_TIME = 30;
+const int TEST_BENCHMARK_TIME = 2;
 
 #define TASK_COUNT_UNITTEST (TASK_BATTERY_VOLTAGE + 1)
 #define TASK_PERIOD_HZ(hz) (1000000 / (hz))
 
 extern "C" {
-    task_t * unittest_scheduler_selectedTask;
+    extern task_t *unittest_scheduler_selectedTask;
     uint8_t unittest_scheduler_selectedTaskDynPrio;
     timeDelta_t unittest_scheduler_taskRequiredTimeUs;
     bool taskGyroRan = false;
@@ -100,6 +103,7 @@ extern "C" {
     void dispatchProcess(timeUs_t) { simulatedTime += TEST_DISPATCH_TIME; }
     bool osdUpdateCheck(timeUs_t, timeDelta_t) { simulatedTime += TEST_UPDATE_OSD_CHECK_TIME; return false; }
     void osdUpdate(timeUs_t) { simulatedTime += TEST_UPDATE_OSD_TIME; }
+    void taskBenchmark(timeUs_t) { simulatedTime += TEST_BENCHMARK_TIME; }
 
     void resetGyroTaskTestFlags(void) {
         taskGyroRan = false;
@@ -119,76 +123,7 @@ extern "C" {
     extern task_t *queueFirst(void);
     extern task_t *queueNext(void);
 
-    task_attribute_t task_attributes[TASK_COUNT] = {
-        [TASK_SYSTEM] = {
-            .taskName = "SYSTEM",
-            .taskFunc = taskSystemLoad,
-            .desiredPeriodUs = TASK_PERIOD_HZ(10),
-            .staticPriority = TASK_PRIORITY_MEDIUM_HIGH,
-        },
-        [TASK_GYRO] = {
-            .taskName = "GYRO",
-            .taskFunc = taskGyroSample,
-            .desiredPeriodUs = TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ),
-            .staticPriority = TASK_PRIORITY_REALTIME,
-        },
-        [TASK_FILTER] = {
-            .taskName = "FILTER",
-            .taskFunc = taskFiltering,
-            .desiredPeriodUs = TASK_PERIOD_HZ(4000),
-            .staticPriority = TASK_PRIORITY_REALTIME,
-        },
-        [TASK_PID] = {
-            .taskName = "PID",
-            .taskFunc = taskMainPidLoop,
-            .desiredPeriodUs = TASK_PERIOD_HZ(4000),
-            .staticPriority = TASK_PRIORITY_REALTIME,
-        },
-        [TASK_ACCEL] = {
-            .taskName = "ACCEL",
-            .taskFunc = taskUpdateAccelerometer,
-            .desiredPeriodUs = TASK_PERIOD_HZ(1000),
-            .staticPriority = TASK_PRIORITY_MEDIUM,
-        },
-        [TASK_ATTITUDE] = {
-            .taskName = "ATTITUDE",
-            .taskFunc = imuUpdateAttitude,
-            .desiredPeriodUs = TASK_PERIOD_HZ(100),
-            .staticPriority = TASK_PRIORITY_MEDIUM,
-        },
-        [TASK_RX] = {
-            .taskName = "RX",
-            .checkFunc = rxUpdateCheck,
-            .taskFunc = taskUpdateRxMain,
-            .desiredPeriodUs = TASK_PERIOD_HZ(50),
-            .staticPriority = TASK_PRIORITY_HIGH,
-        },
-        [TASK_SERIAL] = {
-            .taskName = "SERIAL",
-            .taskFunc = taskHandleSerial,
-            .desiredPeriodUs = TASK_PERIOD_HZ(100),
-            .staticPriority = TASK_PRIORITY_LOW,
-        },
-        [TASK_DISPATCH] = {
-            .taskName = "DISPATCH",
-            .taskFunc = dispatchProcess,
-            .desiredPeriodUs = TASK_PERIOD_HZ(1000),
-            .staticPriority = TASK_PRIORITY_HIGH,
-        },
-        [TASK_BATTERY_VOLTAGE] = {
-            .taskName = "BATTERY_VOLTAGE",
-            .taskFunc = taskUpdateBatteryVoltage,
-            .desiredPeriodUs = TASK_PERIOD_HZ(50),
-            .staticPriority = TASK_PRIORITY_MEDIUM,
-        },
-        [TASK_OSD] = {
-            .taskName = "OSD",
-            .checkFunc = osdUpdateCheck,
-            .taskFunc = osdUpdate,
-            .desiredPeriodUs = TASK_PERIOD_HZ(12),
-            .staticPriority = TASK_PRIORITY_LOW,
-        }
-    };
+    extern task_attribute_t task_attributes[TASK_COUNT];
 
     task_t tasks[TASK_COUNT];
 
@@ -633,3 +568,130 @@ TEST(SchedulerUnittest, TestGyroTask)
     EXPECT_EQ(static_cast<task_t*>(0), unittest_scheduler_selectedTask);
 }
 
+TEST(SchedulerUnittest, TestSchedulerBenchmark)
+{
+    // Run the scheduler with most tasks enabled and only the gyro task realtime
+    schedulerInit();
+    for (int taskId = 0; taskId < TASK_COUNT; ++taskId) {
+        setTaskEnabled(static_cast<taskId_e>(taskId), true);
+    }
+    setTaskEnabled(TASK_FILTER, false);
+    setTaskEnabled(TASK_PID, false);
+    setTaskEnabled(TASK_DISPATCH, false);
+
+    resetGyroTaskTestFlags();
+
+    simulatedTime = 100000;
+    for (int taskId = 0; taskId < TASK_COUNT; ++taskId) {
+        tasks[taskId].lastExecutedAtUs = simulatedTime;
+        tasks[taskId].lastStatsAtUs = simulatedTime;
+        tasks[taskId].movingSumDeltaTime10thUs = 0;
+        tasks[taskId].anticipatedExecutionTime = 0;
+    }
+
+    const uint32_t endTime = simulatedTime + 2000000;
+    int passes = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    while (simulatedTime < endTime) {
+        scheduler();
+        simulatedTime++;
+        passes++;
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+#if defined(USE_SCHEDULER_HEAP)
+    const char *path = "heap";
+#else
+    const char *path = "queue scan";
+#endif
+    printf("scheduler %s: %.1f ns per pass\n", path,
+        std::chrono::duration<double, std::nano>(end - start).count() / passes);
+
+    // The time-driven tasks must still run at their desired rate
+    for (int taskId = 0; taskId < TASK_COUNT; ++taskId) {
+        const task_t *task = &tasks[taskId];
+        if (queueContains((task_t *)task) && !task->attribute->checkFunc &&
+            task->attribute->staticPriority != TASK_PRIORITY_REALTIME &&
+            task->attribute->desiredPeriodUs >= TASK_PERIOD_HZ(1000)) {
+            const int averageDeltaTimeUs = task->movingSumDeltaTime10thUs / TASK_STATS_MOVING_SUM_COUNT / 10;
+            EXPECT_NEAR(task->attribute->desiredPeriodUs, averageDeltaTimeUs, task->attribute->desiredPeriodUs / 10) << task->attribute->taskName;
+        }
+    }
+}
+
+#if defined(USE_SCHEDULER_TRACE)
+TEST(SchedulerUnittest, TestTraceRealtimeMargin)
+{
+    static const uint32_t startTime = 4000;
+
+    schedulerEnableGyro();
+    for (int taskId = 0; taskId < TASK_COUNT; ++taskId) {
+        setTaskEnabled(static_cast<taskId_e>(taskId), false);
+    }
+    setTaskEnabled(TASK_GYRO, true);
+    setTaskEnabled(TASK_FILTER, true);
+    setTaskEnabled(TASK_PID, true);
+
+    // The gyro is due now, with the filter and PID tasks ready behind it
+    simulatedTime = startTime;
+    tasks[TASK_GYRO].lastExecutedAtUs = simulatedTime - TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ);
+    resetGyroTaskTestFlags();
+    taskFilterReady = true;
+    taskPidReady = true;
+
+    const uint32_t head = schedulerTraceHead();
+    scheduler();
+    EXPECT_EQ(head + 3, schedulerTraceHead());
+
+    schedulerTraceEvent_t gyroEvent, filterEvent, pidEvent;
+    EXPECT_TRUE(schedulerTraceRead(head, &gyroEvent));
+    EXPECT_TRUE(schedulerTraceRead(head + 1, &filterEvent));
+    EXPECT_TRUE(schedulerTraceRead(head + 2, &pidEvent));
+
+    EXPECT_EQ(TASK_GYRO, gyroEvent.taskId);
+    EXPECT_EQ(TASK_FILTER, filterEvent.taskId);
+    EXPECT_EQ(TASK_PID, pidEvent.taskId);
+
+    // clockCyclesTo10thMicros() is 1:1 with the simulated cycles (10 per us)
+    EXPECT_EQ(TEST_GYRO_SAMPLE_TIME * 10, gyroEvent.duration10thUs);
+    EXPECT_EQ(TEST_FILTERING_TIME * 10, filterEvent.duration10thUs);
+    EXPECT_EQ(TEST_PID_LOOP_TIME * 10, pidEvent.duration10thUs);
+
+    // Each event records its own margin, shrinking by the time spent before it
+    EXPECT_EQ(TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ) * 10, gyroEvent.margin10thUs);
+    EXPECT_EQ(gyroEvent.margin10thUs - gyroEvent.duration10thUs, filterEvent.margin10thUs);
+    EXPECT_EQ(filterEvent.margin10thUs - filterEvent.duration10thUs, pidEvent.margin10thUs);
+}
+
+TEST(SchedulerUnittest, TestTraceOverwrite)
+{
+    schedulerEnableGyro();
+    for (int taskId = 0; taskId < TASK_COUNT; ++taskId) {
+        setTaskEnabled(static_cast<taskId_e>(taskId), false);
+    }
+    setTaskEnabled(TASK_GYRO, true);
+
+    const uint32_t head = schedulerTraceHead();
+    schedulerTraceEvent_t event;
+
+    // Nothing has been written at the head yet
+    EXPECT_FALSE(schedulerTraceRead(head, &event));
+
+    simulatedTime = 100000;
+    for (int i = 0; i < SCHEDULER_TRACE_SIZE + 1; i++) {
+        tasks[TASK_GYRO].lastExecutedAtUs = simulatedTime - TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ);
+        resetGyroTaskTestFlags();
+        scheduler();
+        simulatedTime += TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ);
+    }
+    EXPECT_EQ(head + SCHEDULER_TRACE_SIZE + 1, schedulerTraceHead());
+
+    // The oldest event has been overwritten, the rest of the ring is intact
+    EXPECT_FALSE(schedulerTraceRead(head, &event));
+    EXPECT_TRUE(schedulerTraceRead(head + 1, &event));
+    EXPECT_EQ(TASK_GYRO, event.taskId);
+    EXPECT_TRUE(schedulerTraceRead(head + SCHEDULER_TRACE_SIZE, &event));
+    EXPECT_EQ(TASK_GYRO, event.taskId);
+}
+#endif
@@ -0,0 +1,146 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// The task table uses array designators, which are only valid in C
+
+#include "platform.h"
+
+#include "scheduler/scheduler.h"
+
+#define TEST_GYRO_SAMPLE_HZ 8000
+
+void taskGyroSample(timeUs_t currentTimeUs);
+void taskFiltering(timeUs_t currentTimeUs);
+void taskMainPidLoop(timeUs_t currentTimeUs);
+void taskUpdateAccelerometer(timeUs_t currentTimeUs);
+void taskHandleSerial(timeUs_t currentTimeUs);
+void taskUpdateBatteryVoltage(timeUs_t currentTimeUs);
+bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
+void taskUpdateRxMain(timeUs_t currentTimeUs);
+void imuUpdateAttitude(timeUs_t currentTimeUs);
+void dispatchProcess(timeUs_t currentTimeUs);
+bool osdUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
+void osdUpdate(timeUs_t currentTimeUs);
+void taskBenchmark(timeUs_t currentTimeUs);
+
+task_attribute_t task_attributes[TASK_COUNT] = {
+    [TASK_SYSTEM] = {
+        .taskName = "SYSTEM",
+        .taskFunc = taskSystemLoad,
+        .desiredPeriodUs = TASK_PERIOD_HZ(10),
+        .staticPriority = TASK_PRIORITY_MEDIUM_HIGH,
+    },
+    [TASK_GYRO] = {
+        .taskName = "GYRO",
+        .taskFunc = taskGyroSample,
+        .desiredPeriodUs = TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ),
+        .staticPriority = TASK_PRIORITY_REALTIME,
+    },
+    [TASK_FILTER] = {
+        .taskName = "FILTER",
+        .taskFunc = taskFiltering,
+        .desiredPeriodUs = TASK_PERIOD_HZ(4000),
+        .staticPriority = TASK_PRIORITY_REALTIME,
+    },
+    [TASK_PID] = {
+        .taskName = "PID",
+        .taskFunc = taskMainPidLoop,
+        .desiredPeriodUs = TASK_PERIOD_HZ(4000),
+        .staticPriority = TASK_PRIORITY_REALTIME,
+    },
+    [TASK_ACCEL] = {
+        .taskName = "ACCEL",
+        .taskFunc = taskUpdateAccelerometer,
+        .desiredPeriodUs = TASK_PERIOD_HZ(1000),
+        .staticPriority = TASK_PRIORITY_MEDIUM,
+    },
+    [TASK_ATTITUDE] = {
+        .taskName = "ATTITUDE",
+        .taskFunc = imuUpdateAttitude,
+        .desiredPeriodUs = TASK_PERIOD_HZ(100),
+        .staticPriority = TASK_PRIORITY_MEDIUM,
+    },
+    [TASK_RX] = {
+        .taskName = "RX",
+        .checkFunc = rxUpdateCheck,
+        .taskFunc = taskUpdateRxMain,
+        .desiredPeriodUs = TASK_PERIOD_HZ(50),
+        .staticPriority = TASK_PRIORITY_HIGH,
+    },
+    [TASK_SERIAL] = {
+        .taskName = "SERIAL",
+        .taskFunc = taskHandleSerial,
+        .desiredPeriodUs = TASK_PERIOD_HZ(100),
+        .staticPriority = TASK_PRIORITY_LOW,
+    },
+    [TASK_DISPATCH] = {
+        .taskName = "DISPATCH",
+        .taskFunc = dispatchProcess,
+        .desiredPeriodUs = TASK_PERIOD_HZ(1000),
+        .staticPriority = TASK_PRIORITY_HIGH,
+    },
+    [TASK_BATTERY_VOLTAGE] = {
+        .taskName = "BATTERY_VOLTAGE",
+        .taskFunc = taskUpdateBatteryVoltage,
+        .desiredPeriodUs = TASK_PERIOD_HZ(50),
+        .staticPriority = TASK_PRIORITY_MEDIUM,
+    },
+    [TASK_OSD] = {
+        .taskName = "OSD",
+        .checkFunc = osdUpdateCheck,
+        .taskFunc = osdUpdate,
+        .desiredPeriodUs = TASK_PERIOD_HZ(12),
+        .staticPriority = TASK_PRIORITY_LOW,
+    },
+    // Additional tasks for loading the scheduler
+    [TASK_GPS] = {
+        .taskName = "GPS",
+        .taskFunc = taskBenchmark,
+        .desiredPeriodUs = TASK_PERIOD_HZ(100),
+        .staticPriority = TASK_PRIORITY_MEDIUM,
+    },
+    [TASK_TELEMETRY] = {
+        .taskName = "TELEMETRY",
+        .taskFunc = taskBenchmark,
+        .desiredPeriodUs = TASK_PERIOD_HZ(250),
+        .staticPriority = TASK_PRIORITY_LOW,
+    },
+    [TASK_LEDSTRIP] = {
+        .taskName = "LEDSTRIP",
+        .taskFunc = taskBenchmark,
+        .desiredPeriodUs = TASK_PERIOD_HZ(100),
+        .staticPriority = TASK_PRIORITY_LOW,
+    },
+    [TASK_ESC_SENSOR] = {
+        .taskName = "ESC_SENSOR",
+        .taskFunc = taskBenchmark,
+        .desiredPeriodUs = TASK_PERIOD_HZ(100),
+        .staticPriority = TASK_PRIORITY_LOW,
+    },
+    [TASK_CMS] = {
+        .taskName = "CMS",
+        .taskFunc = taskBenchmark,
+        .desiredPeriodUs = TASK_PERIOD_HZ(20),
+        .staticPriority = TASK_PRIORITY_LOW,
+    },
+    [TASK_TELEMETRY_SBUS2] = {
+        .taskName = "SBUS2_TELEMETRY",
+        .taskFunc = taskBenchmark,
+        .desiredPeriodUs = TASK_PERIOD_HZ(8000),
+        .staticPriority = TASK_PRIORITY_LOWEST,
+    },
+};
@@ -0,0 +1,167 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/serial.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define RING_SIZE 8
+
+static uint8_t ringBuffer[RING_SIZE];
+static int readBufCalls;
+
+static int fakeReadBuf(serialPort_t *instance, uint8_t *data, int count)
+{
+    UNUSED(instance);
+    readBufCalls++;
+    memset(data, 0xAA, count);
+    return count;
+}
+
+static const struct serialPortVTable ringVTable = {
+    .serialWrite = NULL,
+    .serialTotalRxWaiting = NULL,
+    .serialTotalTxFree = NULL,
+    .serialRead = NULL,
+    .serialSetBaudRate = NULL,
+    .isSerialTransmitBufferEmpty = NULL,
+    .setMode = NULL,
+    .setCtrlLineStateCb = NULL,
+    .setBaudRateCb = NULL,
+    .writeBuf = NULL,
+    .beginWrite = NULL,
+    .endWrite = NULL,
+    .rxPeek = serialRingPeek,
+    .rxConsume = serialRingConsume,
+    .readBuf = NULL,
+};
+
+class SerialRxTest : public ::testing::Test
+{
+protected:
+    serialPort_t port;
+
+    virtual void SetUp()
+    {
+        memset(&port, 0, sizeof(port));
+        memset(ringBuffer, 0, sizeof(ringBuffer));
+        port.vTable = &ringVTable;
+        port.rxBuffer = ringBuffer;
+        port.rxBufferSize = RING_SIZE;
+        readBufCalls = 0;
+    }
+
+    // What the receive interrupt does
+    void receive(const uint8_t *data, int count)
+    {
+        while (count--) {
+            port.rxBuffer[port.rxBufferHead] = *data++;
+            port.rxBufferHead = (port.rxBufferHead + 1) % port.rxBufferSize;
+        }
+    }
+};
+
+TEST_F(SerialRxTest, PeekEmpty)
+{
+    const uint8_t *data;
+
+    EXPECT_EQ(0u, serialPeekRx(&port, &data));
+}
+
+TEST_F(SerialRxTest, PeekAndConsume)
+{
+    const uint8_t rx[] = { 1, 2, 3, 4, 5 };
+    const uint8_t *data;
+
+    receive(rx, sizeof(rx));
+
+    ASSERT_EQ(5u, serialPeekRx(&port, &data));
+    EXPECT_EQ(0, memcmp(rx, data, sizeof(rx)));
+
+    // Peeking again without consuming gives the same bytes
+    serialConsumeRx(&port, 2);
+    ASSERT_EQ(3u, serialPeekRx(&port, &data));
+    EXPECT_EQ(3, data[0]);
+
+    serialConsumeRx(&port, 3);
+    EXPECT_EQ(0u, serialPeekRx(&port, &data));
+}
+
+TEST_F(SerialRxTest, PeekStopsAtEndOfRing)
+{
+    const uint8_t first[] = { 1, 2, 3, 4, 5, 6 };
+    const uint8_t second[] = { 7, 8, 9, 10 };
+    const uint8_t *data;
+
+    receive(first, sizeof(first));
+    serialConsumeRx(&port, sizeof(first));
+    receive(second, sizeof(second));
+
+    // Tail at 6, head wrapped to 2
+    ASSERT_EQ(2u, serialPeekRx(&port, &data));
+    EXPECT_EQ(7, data[0]);
+    EXPECT_EQ(8, data[1]);
+    serialConsumeRx(&port, 2);
+
+    ASSERT_EQ(2u, serialPeekRx(&port, &data));
+    EXPECT_EQ(ringBuffer, data);
+    EXPECT_EQ(9, data[0]);
+    EXPECT_EQ(10, data[1]);
+}
+
+TEST_F(SerialRxTest, ReadBufAcrossWrap)
+{
+    const uint8_t first[] = { 1, 2, 3, 4, 5 };
+    const uint8_t second[] = { 6, 7, 8, 9, 10, 11 };
+    uint8_t data[16];
+
+    receive(first, sizeof(first));
+    ASSERT_EQ(5, serialReadBuf(&port, data, sizeof(data)));
+    receive(second, sizeof(second));
+
+    // Limited by the caller's buffer
+    ASSERT_EQ(4, serialReadBuf(&port, data, 4));
+    EXPECT_EQ(0, memcmp(second, data, 4));
+
+    ASSERT_EQ(2, serialReadBuf(&port, data, sizeof(data)));
+    EXPECT_EQ(10, data[0]);
+    EXPECT_EQ(11, data[1]);
+
+    EXPECT_EQ(0, serialReadBuf(&port, data, sizeof(data)));
+}
+
+TEST_F(SerialRxTest, ReadBufUsesDriver)
+{
+    struct serialPortVTable vTable = ringVTable;
+    uint8_t data[4];
+
+    vTable.readBuf = fakeReadBuf;
+    port.vTable = &vTable;
+
+    EXPECT_EQ(4, serialReadBuf(&port, data, sizeof(data)));
+    EXPECT_EQ(1, readBufCalls);
+    EXPECT_EQ(0xAA, data[3]);
+}
@@ -0,0 +1,222 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+
+    #include "telemetry/sensors.h"
+    #include "telemetry/telemetry.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+extern "C" {
+    uint8_t armingFlags = 0;
+
+    bool isModeActivationConditionPresent(boxId_e) { return false; }
+    bool IS_RC_MODE_ACTIVE(boxId_e) { return false; }
+
+    void legacySensorInit(void) {}
+    void telemetrySnapshotUpdate(void) {}
+    int telemetryGetValue(sensor_id_e) { return 0; }
+
+    void initFrSkyHubTelemetry(void) {}
+    void checkFrSkyHubTelemetryState(void) {}
+    void handleFrSkyHubTelemetry(timeUs_t) {}
+    void initHoTTTelemetry(void) {}
+    void checkHoTTTelemetryState(void) {}
+    void handleHoTTTelemetry(timeUs_t) {}
+    void initSmartPortTelemetry(void) {}
+    void checkSmartPortTelemetryState(void) {}
+    void handleSmartPortTelemetry(timeUs_t) {}
+    void initLtmTelemetry(void) {}
+    void checkLtmTelemetryState(void) {}
+    void handleLtmTelemetry(void) {}
+    void initJetiExBusTelemetry(void) {}
+    void checkJetiExBusTelemetryState(void) {}
+    void handleJetiExBusTelemetry(void) {}
+    void initMAVLinkTelemetry(void) {}
+    void checkMAVLinkTelemetryState(void) {}
+    void handleMAVLinkTelemetry(void) {}
+    void initCrsfTelemetry(void) {}
+    void checkCrsfTelemetryState(void) {}
+    void handleCrsfTelemetry(timeUs_t) {}
+    void initIbusTelemetry(void) {}
+    void checkIbusTelemetryState(void) {}
+    void handleIbusTelemetry(void) {}
+}
+
+// Sensor intervals are in ms, the scheduler time in us
+#define SENSOR(ID, WEIGHT, FAST, SLOW) \
+    { .index = 0, .sensor_id = (ID), .app_id = 0, \
+      .fast_weight = (WEIGHT), .slow_weight = (WEIGHT), \
+      .fast_interval = (FAST), .slow_interval = (SLOW), \
+      .ratio_num = 0, .ratio_den = 0, .value = 0, \
+      .active = false, .update = false, .bucket = 0, \
+      .bucket_time = 0, .due_time = 0, .check_time = 0, .encode = NULL }
+
+static void scheduleAll(telemetrySensor_t *sensors, int count, bool useExcess)
+{
+    telemetryScheduleInit(sensors, count, useExcess);
+    for (int i = 0; i < count; i++) {
+        telemetryScheduleAdd(&sensors[i]);
+    }
+}
+
+// Send the next sensor, if any, and return its index
+static int sendNext(timeUs_t now)
+{
+    telemetryScheduleUpdate(now);
+    telemetrySensor_t *sensor = telemetryScheduleNext();
+    if (sensor) {
+        telemetryScheduleCommit(sensor);
+        return sensor->index;
+    }
+    return -1;
+}
+
+TEST(TelemetryScheduleTest, ReadyInOrderAdded)
+{
+    telemetrySensor_t sensors[] = {
+        SENSOR(1, 0, 100, 100),
+        SENSOR(2, 0, 200, 200),
+        SENSOR(3, 0, 500, 500),
+    };
+    scheduleAll(sensors, ARRAYLEN(sensors), false);
+
+    // All sensors start ready and go out first come first served
+    EXPECT_EQ(0, sendNext(0));
+    EXPECT_EQ(1, sendNext(0));
+    EXPECT_EQ(2, sendNext(0));
+    EXPECT_EQ(-1, sendNext(0));
+
+    // Then in the order their buckets refill
+    EXPECT_EQ(-1, sendNext(99000));
+    EXPECT_EQ(0, sendNext(100000));
+    EXPECT_EQ(-1, sendNext(150000));
+    EXPECT_EQ(1, sendNext(200000));
+    EXPECT_EQ(0, sendNext(200000));
+    EXPECT_EQ(-1, sendNext(200000));
+}
+
+TEST(TelemetryScheduleTest, SensorRate)
+{
+    telemetrySensor_t sensors[] = {
+        SENSOR(1, 0, 100, 100),
+        SENSOR(2, 0, 200, 200),
+        SENSOR(3, 0, 500, 500),
+        SENSOR(4, 0, 1000, 1000),
+    };
+    scheduleAll(sensors, ARRAYLEN(sensors), false);
+
+    int sent[ARRAYLEN(sensors)] = { 0 };
+
+    // Ten seconds with room for one sensor every 10ms
+    for (timeUs_t now = 0; now < 10000000; now += 10000) {
+        const int index = sendNext(now);
+        if (index >= 0) {
+            sent[index]++;
+        }
+    }
+
+    EXPECT_NEAR(100, sent[0], 1);
+    EXPECT_NEAR(50, sent[1], 1);
+    EXPECT_NEAR(20, sent[2], 1);
+    EXPECT_NEAR(10, sent[3], 1);
+}
+
+TEST(TelemetryScheduleTest, NothingEarlyWithoutExcess)
+{
+    telemetrySensor_t sensors[] = {
+        SENSOR(1, 1, 100, 100),
+        SENSOR(2, 2, 100, 100),
+    };
+    scheduleAll(sensors, ARRAYLEN(sensors), false);
+
+    EXPECT_EQ(0, sendNext(0));
+    EXPECT_EQ(1, sendNext(0));
+    EXPECT_EQ(-1, sendNext(50000));
+}
+
+TEST(TelemetryScheduleTest, ExcessPicksLowestExcess)
+{
+    telemetrySensor_t sensors[] = {
+        SENSOR(1, 1, 100, 100),
+        SENSOR(2, 2, 100, 100),
+        SENSOR(3, 0, 100, 100),
+    };
+    scheduleAll(sensors, ARRAYLEN(sensors), true);
+
+    EXPECT_EQ(0, sendNext(0));
+    EXPECT_EQ(1, sendNext(0));
+    EXPECT_EQ(2, sendNext(0));
+
+    // Half way to ready, sensor 1 needs the smallest excess per weight.
+    // Sending it credits the others with the same excess times their weight.
+    EXPECT_EQ(1, sendNext(50000));
+    EXPECT_EQ(-1000000, sensors[1].bucket);
+    EXPECT_EQ(-250000, sensors[0].bucket);
+    EXPECT_EQ(-500000, sensors[2].bucket);
+
+    // Sensor 2 has no weight, so it is never sent early
+    EXPECT_EQ(0, sendNext(50000));
+    EXPECT_EQ(1, sendNext(50000));
+    EXPECT_EQ(-500000, sensors[2].bucket);
+
+    // Its bucket still fills up on time
+    EXPECT_EQ(2, sendNext(100000));
+}
+
+TEST(TelemetryScheduleTest, ExcessCreditMakesReady)
+{
+    telemetrySensor_t sensors[] = {
+        SENSOR(1, 1, 100, 100),
+        SENSOR(2, 1, 100, 100),
+        SENSOR(3, 1, 200, 200),
+    };
+    scheduleAll(sensors, ARRAYLEN(sensors), true);
+
+    EXPECT_EQ(0, sendNext(0));
+    EXPECT_EQ(1, sendNext(0));
+    EXPECT_EQ(2, sendNext(0));
+
+    // Sensors 0 and 1 are tied, so the credit from sending one of them
+    // fills up the other and it moves to the ready list
+    telemetryScheduleUpdate(50000);
+    telemetrySensor_t *first = telemetryScheduleNext();
+    ASSERT_NE(nullptr, first);
+    EXPECT_NE(2, first->index);
+    telemetryScheduleCommit(first);
+
+    const int other = (first->index == 0) ? 1 : 0;
+    EXPECT_EQ(0, sensors[other].bucket);
+    EXPECT_EQ(-250000, sensors[2].bucket);
+    EXPECT_EQ(other, sendNext(50000));
+
+    // The queue order still follows the due times after the credit
+    telemetryScheduleUpdate(50000);
+    EXPECT_EQ(&sensors[2], telemetryScheduleNext());
+}